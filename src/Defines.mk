@@ -38,6 +38,10 @@ endif
 ifeq ($(findstring debug,$(MAKECMDGOALS)), debug)
     DEFINES += \
     DEBUG
+else ifeq ($(findstring host,$(MAKECMDGOALS)), host)
+    #keep asserts enabled in simulation
+    DEFINES += \
+    BOARD_HOST
 else
     DEFINES += \
     NDEBUG \
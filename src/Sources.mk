@@ -8,6 +8,14 @@ INCLUDE_DIRS := \
 -I"application/" \
 -I"application/board/avr/"
 
+ifeq ($(findstring host,$(MAKECMDGOALS)), host)
+    #host stand-ins for avr-libc headers need to be found first
+    INCLUDE_DIRS := \
+    -I"application/board/host/shim/" \
+    -I"application/board/host/" \
+    $(INCLUDE_DIRS)
+endif
+
 SOURCES :=
 
 #lufa sources
@@ -36,6 +44,7 @@ ifneq ($(findstring boot,$(MAKECMDGOALS)), boot)
     SOURCES += $(shell find application/board -name "*.c")
     SOURCES += $(shell find application/database -name "*.cpp")
     SOURCES += $(shell find application/interface -name "*.cpp")
+    SOURCES += $(shell find application/profiler -name "*.cpp")
     SOURCES += $(shell find modules/midi -name "*.cpp")
     SOURCES += $(shell find modules/dbms -name "*.cpp")
     SOURCES += $(shell find modules/core -name "*.cpp")
@@ -53,19 +62,31 @@ ifneq ($(findstring boot,$(MAKECMDGOALS)), boot)
     SOURCES += modules/u8g2/csrc/u8x8_gpio.c
     SOURCES += modules/u8g2/csrc/u8x8_d_ssd1322.c
 
-    ifeq ($(findstring rls,$(MAKECMDGOALS)), rls)
+    ifeq ($(findstring host,$(MAKECMDGOALS)), host)
+        #no usb stack on host, avr board sources are replaced with host stand-ins
+        #only eeprom access (through avr-libc stand-ins) and pin maps are reused
+        SOURCES := $(filter-out modules/lufa/% application/board/avr/%,$(SOURCES))
         SOURCES += \
-        modules/lufa/LUFA/Drivers/USB/Class/Device/AudioClassDevice.c \
-        modules/lufa/LUFA/Drivers/USB/Class/Device/MIDIClassDevice.c
-
-        #filter out usb cdc
-        SOURCES := $(filter-out %vserial/VSerial.c %vserial/Descriptors.c,$(SOURCES))
+        application/board/avr/EEPROM.cpp \
+        application/board/avr/pins/map/Map.cpp
     else
-        SOURCES += \
-        modules/lufa/LUFA/Drivers/USB/Class/Device/CDCClassDevice.c
+        #filter out host simulation
+        SOURCES := $(filter-out application/board/host/%,$(SOURCES))
+
+        ifeq ($(findstring rls,$(MAKECMDGOALS)), rls)
+            SOURCES += \
+            modules/lufa/LUFA/Drivers/USB/Class/Device/AudioClassDevice.c \
+            modules/lufa/LUFA/Drivers/USB/Class/Device/MIDIClassDevice.c
+
+            #filter out usb cdc
+            SOURCES := $(filter-out %vserial/VSerial.c %vserial/Descriptors.c,$(SOURCES))
+        else
+            SOURCES += \
+            modules/lufa/LUFA/Drivers/USB/Class/Device/CDCClassDevice.c
 
-        #filter out usb midi
-        SOURCES := $(filter-out %usb/midi/Descriptors.c %usb/midi/USB_MIDI.cpp,$(SOURCES))
+            #filter out usb midi
+            SOURCES := $(filter-out %usb/midi/Descriptors.c %usb/midi/USB_MIDI.cpp,$(SOURCES))
+        endif
     endif
 
     SOURCES += application/Zvuk9.cpp
@@ -29,8 +29,10 @@
 #include "interface/digital/output/leds/LEDs.h"
 #include "interface/digital/input/DigitalInput.h"
 #include "interface/analog/pads/Pads.h"
+#include "interface/midi/Coalescer.h"
 #include "database/Database.h"
 #include "board/Board.h"
+#include "profiler/Profiler.h"
 #include "core/src/general/Misc.h"
 #include "core/src/general/Timing.h"
 #include "core/src/HAL/avr/adc/ADC.h"
@@ -40,6 +42,10 @@
 #include "usb/vserial/VSerial.h"
 #endif
 
+#ifdef BOARD_HOST
+#include "Host.h"
+#endif
+
 MIDI midi;
 
 
@@ -72,6 +78,28 @@ void startUpAnimation()
     wait_ms(1000);
 }
 
+///
+/// \brief Displays message while database is being initialized.
+/// Display is left in direct write state.
+/// @param [in] message Message stored in flash.
+/// @param [in] size    Size of message.
+///
+void displayDatabaseMessage(const char *message, uint8_t size)
+{
+    display.setDirectWriteState(true);
+    display.clearAll();
+
+    stringBuffer.startLine();
+    stringBuffer.appendText_P(message);
+    stringBuffer.endLine();
+    display.updateText(1, displayText_still, display.getTextCenter(size));
+
+    stringBuffer.startLine();
+    stringBuffer.appendText_P(pleaseWait_string);
+    stringBuffer.endLine();
+    display.updateText(2, displayText_still, display.getTextCenter(ARRAY_SIZE(pleaseWait_string)));
+}
+
 int main()
 {
     //do not change order of initialization!
@@ -80,28 +108,29 @@ int main()
     display.init();
     database.init();
 
-    if (!database.signatureValid())
+    if (database.migrationBlocked())
     {
-        display.setDirectWriteState(true);
-        display.clearAll();
+        //memory holds older layout, keep settings
+        //only bytes which aren't in place yet are written here (see dbMigrationPhase_t)
+        //default map is written from main loop once settings are in place
+        displayDatabaseMessage(dbMigration_string, ARRAY_SIZE(dbMigration_string));
 
-        stringBuffer.startLine();
-        stringBuffer.appendText_P(dbInit_string);
-        stringBuffer.endLine();
-        display.updateText(1, displayText_still, display.getTextCenter(ARRAY_SIZE(dbInit_string)));
+        while (database.migrationBlocked())
+            database.migrate();
 
-        stringBuffer.startLine();
-        stringBuffer.appendText_P(pleaseWait_string);
-        stringBuffer.endLine();
-        display.updateText(2, displayText_still, display.getTextCenter(ARRAY_SIZE(pleaseWait_string)));
+        display.setDirectWriteState(false);
+    }
 
+    if (!database.signatureValid())
+    {
+        displayDatabaseMessage(dbInit_string, ARRAY_SIZE(dbInit_string));
         database.factoryReset(initFull);
         display.setDirectWriteState(false);
     }
 
     midi.setInputChannel(1);
-    midi.setNoteOffMode((noteOffType_t)database.read(DB_BLOCK_GLOBAL_SETTINGS, globalSettingsMIDI, MIDI_SETTING_NOTE_OFF_TYPE_ID));
-    midi.setRunningStatusState(database.read(DB_BLOCK_GLOBAL_SETTINGS, globalSettingsMIDI, MIDI_SETTING_RUNNING_STATUS_ID));
+    midi.setNoteOffMode((noteOffType_t)database.read<DB_BLOCK_GLOBAL_SETTINGS, globalSettingsMIDI>(MIDI_SETTING_NOTE_OFF_TYPE_ID));
+    midi.setRunningStatusState(database.read<DB_BLOCK_GLOBAL_SETTINGS, globalSettingsMIDI>(MIDI_SETTING_RUNNING_STATUS_ID));
     pads.init();
     encoders.init();
 
@@ -125,16 +154,58 @@ int main()
     //start first conversion manually
     startADCconversion();
 
+    profiler.init();
+
     while (1)
     {
         #ifdef DEBUG
         CDC_Update();
+        #else
+        if (midi.read(usbInterface))
+        {
+            if (midi.getType(usbInterface) == midiMessageSystemExclusive)
+                profiler.handleSysEx(midi.getSysExArray(usbInterface), midi.getSysExArrayLength(usbInterface));
+        }
         #endif
 
+        #ifdef BOARD_HOST
+        hostUpdate();
+        #endif
+
+        profiler.begin();
         pads.update();
+        coalescer.update();
+        profiler.end(profilerStagePads);
+
+        profiler.begin();
         digitalInput.update();
+        profiler.end(profilerStageDigitalInput);
+
+        profiler.begin();
         display.update();
+        profiler.end(profilerStageDisplay);
+
+        profiler.begin();
         leds.update();
+        profiler.end(profilerStageLEDs);
+
+        #ifndef DEBUG
+        board.updateUSBMIDI();
+        #endif
+
+        bool padsIdle = !pads.getNumberOfPressedPads();
+
+        //program can't be changed while pads are pressed, prefetch neighbors only once they're released
+        //rest of migration is done then as well
+        if (padsIdle)
+        {
+            database.prefetchPrograms();
+            database.updateMigration();
+        }
+
+        writeCache.update(padsIdle);
+
+        profiler.update();
     }
 
     return 0;
@@ -70,6 +70,15 @@ class Board
     ///
     bool padDataAvailable();
 
+    ///
+    /// \brief Checks if requested pad needs to be processed in current frame.
+    /// Released pads on which pressure hasn't changed beyond noise threshold
+    /// are reported as unchanged.
+    /// @param [in] pad Pad which is being checked.
+    /// \returns True if pad has changed, false otherwise.
+    ///
+    bool padChangeDetected(uint8_t pad);
+
     ///
     /// \brief Returns Z coordinate (pressure) reading for requested pad.
     /// @param [in] pad Pad for which reading is returned.
@@ -91,6 +100,13 @@ class Board
     ///
     int16_t getPadY(uint8_t pad);
 
+    ///
+    /// \brief Returns time at which readout of current pad data has been completed.
+    /// Used to keep pad processing independent of how often pads are read.
+    /// \returns Readout time in profiler timer ticks (see getProfilerTicks).
+    ///
+    uint32_t getPadTicks();
+
     ///
     /// \brief Checks if data from button matrix is available.
     /// Matrix data is read in ISR and stored into digitalInBuffer array.
@@ -132,6 +148,7 @@ class Board
 
     ///
     /// \brief Used to write value to memory provided by specific board.
+    /// Value is queued and written in background. Reads return queued value right away.
     /// @param [in] address Memory address in which new value is being written.
     /// @param [in] value   Value to write.
     /// @param [in] type    Type of parameter which is being written. Defined in DBMS module.
@@ -139,6 +156,54 @@ class Board
     ///
     static bool memoryWrite(uint32_t address, int32_t value, sectionParameterType_t type);
 
+    ///
+    /// \brief Reads sequence of bytes from memory provided by specific board.
+    /// @param [in] address     Memory address from which to start reading.
+    /// @param [in,out] data    Array in which read bytes are stored.
+    /// @param [in] size        Number of bytes to read.
+    /// \returns               True on success, false otherwise.
+    ///
+    static bool memoryReadBlock(uint32_t address, uint8_t *data, uint16_t size);
+
+    ///
+    /// \brief Checks whether all writes to memory have been completed.
+    /// \returns True if there are no queued writes and memory isn't busy, false otherwise.
+    ///
+    static bool memoryReady();
+
+    ///
+    /// \brief Sends all USB MIDI packets which are waiting in endpoint.
+    /// Outgoing USB MIDI packets are batched into single transfer until
+    /// endpoint is full, flush is requested or USB_MIDI_FLUSH_TIMEOUT passes.
+    ///
+    static void flushUSBMIDI();
+
+    ///
+    /// \brief Sends pending USB MIDI packets if they've been waiting for
+    /// USB_MIDI_FLUSH_TIMEOUT milliseconds or more. Called from main loop.
+    ///
+    static void updateUSBMIDI();
+
+    ///
+    /// \brief Returns number of messages of specified type which can be sent
+    /// without waiting or being dropped by any MIDI transport.
+    /// Capacity is limited both by UART (DIN) queue lane of message type and by free
+    /// space in USB MIDI endpoint. Control change, key aftertouch and channel aftertouch
+    /// share the same lane and therefore the same capacity. USB MIDI isn't used in debug mode, in which case
+    /// capacity is limited only by UART.
+    /// @param [in] type    MIDI message type.
+    /// \returns Number of messages which can be sent.
+    ///
+    static uint8_t getMIDIcapacity(midiMessageType_t type);
+
+    ///
+    /// \brief Returns current value of free-running profiler timer.
+    /// Timer runs with PROFILER_TICKS_PER_US ticks per microsecond and overflows
+    /// once 32-bit range is exceeded.
+    /// \returns Profiler timer value in ticks.
+    ///
+    static uint32_t getProfilerTicks();
+
     private:
     ///
     /// \brief Initializes all pins to correct states.
@@ -154,6 +219,12 @@ class Board
     ///
     static void initUART_MIDI();
 
+    ///
+    /// \brief Returns number of USB MIDI packets which can be written to endpoint without waiting.
+    /// Internal function, see getMIDIcapacity.
+    ///
+    static uint8_t getUSBMIDIcapacity();
+
     ///
     /// \brief Initializes main and PWM timers.
     ///
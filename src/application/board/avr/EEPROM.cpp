@@ -22,9 +22,97 @@
     published by the Free Software Foundation here
     <https://www.gnu.org/licenses/gpl-3.0.txt>
 */
-
 #include <avr/eeprom.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
 #include "../Board.h"
+#include "board/common/eeprom/Queue.h"
+
+///
+/// \ingroup board
+/// @{
+
+///
+/// \brief Writes next queued byte to EEPROM.
+/// Byte is written only if it differs from current one. Once queue is empty,
+/// EE_READY interrupt is disabled.
+///
+static void writeNext()
+{
+    uint16_t address;
+    uint8_t value;
+
+    if (!eepromQueueNext(address, value))
+    {
+        EECR &= ~(1<<EERIE);
+        return;
+    }
+
+    eeprom_update_byte((uint8_t*)address, value);
+}
+
+///
+/// \brief ISR used to write queued bytes to EEPROM.
+/// Fires once EEPROM is ready for next write.
+///
+ISR(EE_READY_vect)
+{
+    writeNext();
+}
+
+///
+/// \brief Adds byte to EEPROM write queue.
+/// If queue is full, waits for free space. When interrupts are disabled (during
+/// initialization), queued bytes are written directly instead.
+///
+static void writeByte(uint16_t address, uint8_t value)
+{
+    while (!eepromQueueWrite(address, value))
+    {
+        if (!(SREG & (1<<SREG_I)))
+        {
+            eeprom_busy_wait();
+            writeNext();
+        }
+    }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        EECR |= (1<<EERIE);
+    }
+}
+
+///
+/// \brief Reads sequence of bytes with queued bytes applied.
+/// EE_READY interrupt is disabled while waiting, so that ISR can't start writing next
+/// queued byte as soon as current one is written. This way, read waits only for byte
+/// which is being written already instead of for entire queue, while other interrupts
+/// keep running. Read from EEPROM is done together with queue lookup, so that byte
+/// which has just been written can't be missed.
+///
+static void readBytes(uint16_t address, uint8_t *data, uint8_t size)
+{
+    bool writing;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        writing = EECR & (1<<EERIE);
+        EECR &= ~(1<<EERIE);
+    }
+
+    eeprom_busy_wait();
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        eeprom_read_block(data, (const void*)address, size);
+        eepromQueueOverlay(address, data, size);
+
+        if (writing)
+            EECR |= (1<<EERIE);
+    }
+}
+
+/// @}
 
 bool Board::memoryRead(uint32_t address, sectionParameterType_t type, int32_t &value)
 {
@@ -33,16 +121,33 @@ bool Board::memoryRead(uint32_t address, sectionParameterType_t type, int32_t &v
         case BIT_PARAMETER:
         case BYTE_PARAMETER:
         case HALFBYTE_PARAMETER:
-        value = eeprom_read_byte((uint8_t*)address);
+        {
+            uint8_t data;
+
+            if (!eepromQueueRead(address, data))
+                readBytes(address, &data, 1);
+
+            value = data;
+        }
         break;
 
         case WORD_PARAMETER:
-        value = eeprom_read_word((uint16_t*)address);
+        {
+            uint16_t data;
+
+            readBytes(address, (uint8_t*)&data, sizeof(data));
+            value = data;
+        }
         break;
 
         default:
         // case DWORD_PARAMETER:
-        value = eeprom_read_dword((uint32_t*)address);
+        {
+            uint32_t data;
+
+            readBytes(address, (uint8_t*)&data, sizeof(data));
+            value = data;
+        }
         break;
     }
 
@@ -51,23 +156,49 @@ bool Board::memoryRead(uint32_t address, sectionParameterType_t type, int32_t &v
 
 bool Board::memoryWrite(uint32_t address, int32_t value, sectionParameterType_t type)
 {
+    uint8_t size;
+
     switch(type)
     {
         case BIT_PARAMETER:
         case BYTE_PARAMETER:
         case HALFBYTE_PARAMETER:
-        eeprom_update_byte((uint8_t*)address, value);
+        size = 1;
         break;
 
         case WORD_PARAMETER:
-        eeprom_update_word((uint16_t*)address, value);
+        size = 2;
         break;
 
         default:
         // case DWORD_PARAMETER:
-        eeprom_update_dword((uint32_t*)address, value);
+        size = 4;
         break;
     }
 
+    //little-endian, same as eeprom_update_word/dword
+    for (int i=0; i<size; i++)
+        writeByte(address+i, value >> (8*i));
+
     return true;
-}
\ No newline at end of file
+}
+
+bool Board::memoryReadBlock(uint32_t address, uint8_t *data, uint16_t size)
+{
+    while (size)
+    {
+        uint8_t chunk = (size > EEPROM_READ_CHUNK_SIZE) ? EEPROM_READ_CHUNK_SIZE : size;
+
+        readBytes(address, data, chunk);
+        address += chunk;
+        data += chunk;
+        size -= chunk;
+    }
+
+    return true;
+}
+
+bool Board::memoryReady()
+{
+    return !eepromQueueCount() && eeprom_is_ready();
+}
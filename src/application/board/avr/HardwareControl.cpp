@@ -33,6 +33,7 @@
 #include "core/src/HAL/avr/PinManipulation.h"
 #include "core/src/general/BitManipulation.h"
 #include "core/src/HAL/avr/adc/ADC.h"
+#include "board/common/analog/Scan.h"
 
 
 ///
@@ -279,4 +280,72 @@ inline void setMuxInput(uint8_t muxInput)
     BIT_READ(muxInput, 3) ? setHigh(MUX_SELECT_PIN_3_PORT, MUX_SELECT_PIN_3_PIN) : setLow(MUX_SELECT_PIN_3_PORT, MUX_SELECT_PIN_3_PIN);
 }
 
+///
+/// \brief Configures pad pins, multiplexer and ADC channel for specified pad reading.
+/// @param [in] pad         Pad which is being read.
+/// @param [in] reading     Pad reading (enumerated type). See padReadOrder_t enumeration.
+///
+inline void setupPadReading(uint8_t pad, uint8_t reading)
+{
+    switch(reading)
+    {
+        case readPressure0:
+        case readPressure1:
+        setupPressure0();
+        break;
+
+        case readPressure2:
+        case readPressure3:
+        setupPressure1();
+        break;
+
+        case readX:
+        setupX();
+        break;
+
+        case readY:
+        setupY();
+        break;
+    }
+
+    setMuxInput(padIDArray[pad]);
+    setADCchannel(coordinateAnalogInput[reading]);
+}
+
+///
+/// \brief Stores ADC result for specified pad reading into ring buffer frame which is being filled.
+/// @param [in] pad         Pad which has been read.
+/// @param [in] reading     Pad reading (enumerated type). See padReadOrder_t enumeration.
+/// @param [in] value       ADC result.
+///
+inline void storePadReading(uint8_t pad, uint8_t reading, uint16_t value)
+{
+    switch(reading)
+    {
+        case readPressure0:
+        case readPressure2:
+        pressurePlate1 = value;
+        break;
+
+        case readPressure1:
+        //store second pressure reading from opposite plate
+        analogInBuffer[aIn_head].zReading[pad] = 1023 - (value - pressurePlate1);
+        break;
+
+        case readPressure3:
+        //store second pressure reading from opposite plate
+        analogInBuffer[aIn_head].zReading[pad] = analogInBuffer[aIn_head].zReading[pad] + (1023 - (value - pressurePlate1));
+        padScanStorePressure(pad, analogInBuffer[aIn_head].zReading[pad]);
+        break;
+
+        case readX:
+        analogInBuffer[aIn_head].xReading[pad] = value;
+        break;
+
+        case readY:
+        analogInBuffer[aIn_head].yReading[pad] = value;
+        break;
+    }
+}
+
 /// @}
\ No newline at end of file
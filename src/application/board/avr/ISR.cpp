@@ -25,10 +25,13 @@
 
 #include <avr/cpufunc.h>
 #include <avr/interrupt.h>
+#include <util/atomic.h>
 #include "../Board.h"
 #include "HardwareControl.cpp"
 #include "board/common/analog/Variables.h"
+#include "board/common/analog/Scan.h"
 #include "../../interface/analog/pads/DataTypes.h"
+#include "profiler/Profiler.h"
 
 ///
 /// \ingroup boardAVR
@@ -39,6 +42,12 @@
 ///
 volatile uint32_t   rTime_ms;
 
+///
+/// \brief Number of profiler timer (timer0) overflows.
+/// Used together with timer counter to get 32-bit profiler time.
+///
+volatile uint32_t   profilerTimerOverflows;
+
 
 ///
 /// \brief Main interrupt service routine.
@@ -46,6 +55,8 @@ volatile uint32_t   rTime_ms;
 ///
 ISR(TIMER3_COMPA_vect)
 {
+    uint8_t profilerStart = TCNT0;
+
     //1ms
     ledRowsOff();
 
@@ -70,103 +81,269 @@ ISR(TIMER3_COMPA_vect)
 
         dIn_count++;
     }
+
+    Profiler::addISRtime(profilerStageISR_timer, TCNT0 - profilerStart);
+}
+
+///
+/// \brief Starts new pad readout in ring buffer if previous one has been completed.
+/// Readings which aren't scanned in new readout are kept from previous one.
+///
+inline void padReadoutInsert(bool &ringBufferInsert)
+{
+    if (!ringBufferInsert)
+        return;
+
+    //only do this once per readout
+    ringBufferInsert = false;
+    uint8_t previousHead = aIn_head;
+
+    if (++aIn_head == ANALOG_IN_BUFFER_SIZE)
+        aIn_head = 0;
+
+    padScanCopy(analogInBuffer[aIn_head], analogInBuffer[previousHead]);
+}
+
+#if PAD_SCAN_PIPELINE > 0
+///
+/// \brief Remaining settle time in profiler timer ticks below which conversion start
+/// is busy-waited instead of scheduled using compare match.
+///
+#define PAD_SCAN_MIN_COMPARE_TICKS  4
+
+///
+/// \brief Possible actions of timer0 compare match ISR during pipelined pad readout.
+///
+typedef enum
+{
+    padCompareStartConversion,
+    padCompareSetupNext
+} padCompareAction_t;
+
+///
+/// \brief Pad and reading which follow reading currently being converted.
+/// @{
+
+static uint8_t              nextPad;
+static uint8_t              nextReading = readPressure1;
+
+/// @}
+
+///
+/// \brief Set if reading which follows current one starts new readout.
+///
+static bool                 nextReadoutStart;
+
+///
+/// \brief Set once next reading has been set up.
+///
+static bool                 nextSetupDone;
+
+///
+/// \brief Set if currently converted reading has been set up and settled before conversion start.
+/// First conversion is started before any setup is performed so it's invalid.
+///
+static bool                 conversionValid;
+
+///
+/// \brief Profiler timer value at which currently used setup has been applied.
+///
+static uint8_t              setupTime;
+
+///
+/// \brief Action performed once timer0 compare match ISR fires.
+///
+static padCompareAction_t   compareAction;
+
+///
+/// \brief Schedules timer0 compare match ISR after specified number of timer ticks.
+///
+inline void padCompareSchedule(padCompareAction_t action, uint8_t time)
+{
+    compareAction = action;
+    OCR0A = time;
+    TIFR0 = (1<<OCF0A);
+    TIMSK0 |= (1<<OCIE0A);
+}
+
+///
+/// \brief Starts conversion of current reading and schedules setup of next reading
+/// once ADC has sampled its input.
+///
+inline void padConversionStart()
+{
+    startADCconversion();
+    conversionValid = true;
+    padCompareSchedule(padCompareSetupNext, TCNT0 + PAD_SCAN_SAMPLE_HOLD_US*PROFILER_TICKS_PER_US);
+}
+
+///
+/// \brief Starts conversion of current reading once its setup has settled.
+///
+inline void padConversionStartSettled()
+{
+    uint8_t settleTime = padSettleTime_us[padReadingIndex]*PROFILER_TICKS_PER_US;
+    uint8_t elapsedTime = TCNT0 - setupTime;
+
+    if (elapsedTime >= settleTime)
+    {
+        padConversionStart();
+    }
+    else if ((settleTime - elapsedTime) <= PAD_SCAN_MIN_COMPARE_TICKS)
+    {
+        //too short for compare match, wait here
+        while ((uint8_t)(TCNT0 - setupTime) < settleTime);
+        padConversionStart();
+    }
+    else
+    {
+        padCompareSchedule(padCompareStartConversion, setupTime + settleTime);
+    }
 }
 
 ///
 /// \brief ADC ISR used to read values from pads.
+/// Pads and coordinates which are read in each readout are selected with padScanPlan.
+/// Readout is pipelined: next reading is set up while current one is being converted
+/// (see TIMER0_COMPA_vect) so that no conversion is discarded.
 ///
 ISR(ADC_vect)
 {
+    uint8_t profilerStart = TCNT0;
     static bool ringBufferInsert = true;
 
-    if (aIn_count < ANALOG_IN_BUFFER_SIZE)
+    TIMSK0 &= ~(1<<OCIE0A);
+
+    if (conversionValid && (aIn_count < ANALOG_IN_BUFFER_SIZE))
     {
-        if (ringBufferInsert)
+        padReadoutInsert(ringBufferInsert);
+        storePadReading(activePad, padReadingIndex, ADC);
+
+        if (nextReadoutStart)
         {
-            //only do this once per readout
-            ringBufferInsert = false;
-            if (++aIn_head == ANALOG_IN_BUFFER_SIZE)
-                aIn_head = 0;
+            //all pads are read
+            analogInBuffer[aIn_head].ticks = Board::getProfilerTicks();
+            ringBufferInsert = true;
+            aIn_count++;
         }
 
-        //always ignore first reading
-        static bool ignoreFirst = true;
-        //pad should be switched if all coordinates are read
-        bool padSwitch = false;
+        activePad = nextPad;
+        padReadingIndex = nextReading;
+        nextReadoutStart = padScanAdvance(nextPad, nextReading);
 
-        if (!ignoreFirst)
+        if (!nextSetupDone)
         {
-            switch(padReadingIndex)
-            {
-                case readPressure0:
-                pressurePlate1 = ADC;
-                padReadingIndex = readPressure1;
-                setupPressure0();
-                break;
-
-                case readPressure1:
-                //store second pressure reading from opposite plate
-                analogInBuffer[aIn_head].zReading[activePad] = 1023 - (ADC - pressurePlate1);
-                padReadingIndex = readPressure2;
-                setupPressure1();
-                break;
-
-                case readPressure2:
-                pressurePlate1 = ADC;
-                padReadingIndex = readPressure3;
-                setupPressure1();
-                break;
-
-                case readPressure3:
-                //store second pressure reading from opposite plate
-                analogInBuffer[aIn_head].zReading[activePad] = analogInBuffer[aIn_head].zReading[activePad] + (1023 - (ADC - pressurePlate1));
-                padReadingIndex = readX;
-                setupX();
-                break;
-
-                case readX:
-                analogInBuffer[aIn_head].xReading[activePad] = ADC;
-                //finally, read y
-                padReadingIndex = readY;
-                setupY();
-                break;
-
-                case readY:
-                analogInBuffer[aIn_head].yReading[activePad] = ADC;
-                //continue with pressure reading
-                padReadingIndex = readPressure0;
-                padSwitch = true;
-                setupPressure0();
-                break;
-            }
+            setupPadReading(activePad, padReadingIndex);
+            setupTime = TCNT0;
+        }
+    }
+    else
+    {
+        //reading can't be stored, read it again once its setup is restored
+        setupPadReading(activePad, padReadingIndex);
+        setupTime = TCNT0;
+    }
 
-            //switch adc channel
-            setADCchannel(coordinateAnalogInput[padReadingIndex]);
+    nextSetupDone = false;
+    conversionValid = false;
+    padConversionStartSettled();
 
-            if (padSwitch)
-            {
-                activePad++;
+    Profiler::addISRtime(profilerStageISR_ADC, TCNT0 - profilerStart);
+}
+
+///
+/// \brief Timer0 compare match ISR used for pipelined pad readout.
+/// Either starts conversion once setup has settled or sets up next reading
+/// once ADC has sampled input for current conversion.
+///
+ISR(TIMER0_COMPA_vect)
+{
+    uint8_t profilerStart = TCNT0;
+
+    switch(compareAction)
+    {
+        case padCompareStartConversion:
+        padConversionStart();
+        break;
+
+        case padCompareSetupNext:
+        setupPadReading(nextPad, nextReading);
+        setupTime = TCNT0;
+        nextSetupDone = true;
+        TIMSK0 &= ~(1<<OCIE0A);
+        break;
+    }
+
+    //time belongs to pad readout, but only ADC ISR calls are conversions
+    Profiler::addISRtime(profilerStageISR_ADC, TCNT0 - profilerStart, 0);
+}
+#else
+///
+/// \brief ADC ISR used to read values from pads.
+/// Pads and coordinates which are read in each readout are selected with padScanPlan.
+/// Conversion following each setup change is discarded so that setup can settle.
+///
+ISR(ADC_vect)
+{
+    uint8_t profilerStart = TCNT0;
+    static bool ringBufferInsert = true;
 
-                if (activePad == NUMBER_OF_PADS)
-                {
-                    //all pads are read
-                    setMuxInput(padIDArray[0]);
+    if (aIn_count < ANALOG_IN_BUFFER_SIZE)
+    {
+        padReadoutInsert(ringBufferInsert);
 
-                    ringBufferInsert = true;
-                    aIn_count++;
-                    activePad = 0;
-                }
+        //always ignore first reading
+        static bool ignoreFirst = true;
 
-                //set new pad
-                setMuxInput(padIDArray[activePad]);
+        if (!ignoreFirst)
+        {
+            storePadReading(activePad, padReadingIndex, ADC);
+
+            if (padScanAdvance(activePad, padReadingIndex))
+            {
+                //all pads are read
+                analogInBuffer[aIn_head].ticks = Board::getProfilerTicks();
+                ringBufferInsert = true;
+                aIn_count++;
             }
+
+            setupPadReading(activePad, padReadingIndex);
         }
 
         ignoreFirst = !ignoreFirst;
-
     }
 
     startADCconversion();
+
+    Profiler::addISRtime(profilerStageISR_ADC, TCNT0 - profilerStart);
+}
+#endif
+
+///
+/// \brief Profiler timer overflow ISR.
+/// Fires every 128us.
+///
+ISR(TIMER0_OVF_vect)
+{
+    profilerTimerOverflows++;
 }
 
-/// @}
\ No newline at end of file
+/// @}
+
+uint32_t Board::getProfilerTicks()
+{
+    uint32_t overflows;
+    uint8_t counter;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        overflows = profilerTimerOverflows;
+        counter = TCNT0;
+
+        //overflow which hasn't been serviced yet
+        if ((TIFR0 & (1<<TOV0)) && (counter != 0xFF))
+            overflows++;
+    }
+
+    return (overflows << 8) | counter;
+}
\ No newline at end of file
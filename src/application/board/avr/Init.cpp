@@ -236,12 +236,18 @@ void Board::initTimers()
     TCCR1B |= (1<<CS10);
     TCCR2B |= (1<<CS20);
 
-    //clear timer0 conf (unused)
+    //timer0 is used as free-running profiler timer
     TCCR0A = 0;
     TCCR0B = 0;
     TCNT0 = 0;
     TIMSK0 = 0;
     OCR0A = 0;
+
+    //normal mode, prescaler 8 (0.5us per tick)
+    TCCR0B |= (1<<CS01);
+
+    //count overflows to extend timer to 32 bits
+    TIMSK0 |= (1<<TOIE0);
 }
 
 void Board::initPads()
@@ -24,57 +24,46 @@
 */
 
 #include "../Board.h"
-#include "core/src/general/RingBuffer.h"
+#include "board/common/uart/Queue.h"
 
 ///
 /// \ingroup board
 /// @{
 
 ///
-/// \brief Buffer in which outgoing UART data is stored.
-///
-static RingBuff_t  txBuffer;
-
-///
-/// \brief ISR used to write outgoing data in buffer to UART.
+/// \brief ISR used to write outgoing data in queue to UART.
 ///
 ISR(USART1_UDRE_vect)
 {
-    if (RingBuffer_IsEmpty(&txBuffer))
+    int16_t data = uartQueueRead();
+
+    if (data < 0)
     {
-        //buffer is empty, disable transmit interrupt
+        //queue is empty, disable transmit interrupt
         UCSR1B &= ~(1<<UDRIE1);
     }
     else
     {
-        uint8_t data = RingBuffer_Remove(&txBuffer);
         UDR1 = data;
     }
 }
 
 ///
-/// \brief Writes a byte to outgoing UART buffer.
-/// \returns Positive value on success. Since this function waits if
-/// outgoig buffer is full, result will always be success (1).
+/// \brief Writes a byte to outgoing UART queue.
+/// Waits for free space in queue only on note off and SysEx, see uartQueueWrite.
+/// \returns True on success, false if message to which byte belongs has been dropped.
 ///
 bool UARTwrite(uint8_t data)
 {
-    //if both the outgoing buffer and the UART data register are empty
-    //write the byte to the data register directly
-    if (RingBuffer_IsEmpty(&txBuffer) && (UCSR1A & (1<<UDRE1)))
-    {
-        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
-        {
-            UDR1 = data;
-        }
+    bool result = uartQueueWrite(data);
 
-        return true;
+    //interrupt fires right away if data register is empty
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        UCSR1B |= (1<<UDRIE1);
     }
 
-    while (RingBuffer_IsFull(&txBuffer));
-    RingBuffer_Insert(&txBuffer, data);
-    UCSR1B |= (1<<UDRIE1);
-    return true;
+    return result;
 }
 
 /// @}
@@ -109,6 +98,6 @@ void Board::initUART_MIDI()
     //enable transmitter only
     UCSR1B = (1<<TXEN1);
 
-    RingBuffer_InitBuffer(&txBuffer);
+    uartQueueInit();
     midi.handleUARTwrite(UARTwrite);
 }
\ No newline at end of file
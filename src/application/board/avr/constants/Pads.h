@@ -26,6 +26,7 @@
 #pragma once
 
 #include "Hardware.h"
+#include "board/common/DataTypes.h"
 
 ///
 /// \ingroup board
@@ -42,9 +43,64 @@
 #define PAD_RELEASE_PRESSURE                        5
 
 ///
-/// \brief Number of times raw ADC value needs to be 0 in order to consider pad released.
+/// \brief Time in microseconds during which raw ADC value needs to stay 0 in order to consider pad released.
+/// Matches five readouts of all pads with discarded conversions, for which it has been tuned.
+/// Debounce is timed so that it doesn't depend on how often pad is read (see PAD_SCAN_ADAPTIVE).
 ///
-#define PAD_RELEASED_DEBOUNCE_COUNT                 5
+#define PAD_RELEASED_DEBOUNCE_TIME_US               56000
+
+///
+/// \brief Raw pressure difference up to which released pad is considered unchanged.
+/// Released pads with unchanged pressure aren't processed.
+///
+#define PAD_NOISE_THRESHOLD                         2
+
+///
+/// \brief Enables adaptive pad scanning.
+/// When enabled, X and Y coordinates are read only on touched pads. While any pad is touched,
+/// each scan reads touched pads and only PAD_SCAN_IDLE_PADS idle pads (pressure only), so that
+/// touched pads are read several times more often. When set to 0, all coordinates are read on
+/// all pads in every scan.
+///
+#define PAD_SCAN_ADAPTIVE                           1
+
+///
+/// \brief Number of idle pads which are checked for pressure in each scan while any pad is touched.
+/// Idle pads are rotated between scans.
+///
+#define PAD_SCAN_IDLE_PADS                          3
+
+///
+/// \brief Enables pipelined pad readout.
+/// When enabled, next pad reading is set up as soon as ADC has sampled current one so that
+/// next conversion can be started right after current one completes. When set to 0, each
+/// reading is preceded by one discarded conversion during which setup settles.
+/// Disabled until settle times in padSettleTime_us are measured on hardware.
+///
+#define PAD_SCAN_PIPELINE                           0
+
+///
+/// \brief Time in microseconds after conversion start after which ADC input has been sampled.
+/// Sample and hold takes 1.5 ADC clock cycles (12us with ADC clock of 125kHz), additional
+/// margin is added.
+///
+#define PAD_SCAN_SAMPLE_HOLD_US                     16
+
+///
+/// \brief Time in microseconds needed for pad plates and ADC input to settle after switching
+/// to specific reading. Matched with padReadOrder_t enumeration.
+/// Pipelined readout doesn't lose any time as long as settle time is shorter than
+/// conversion time reduced by PAD_SCAN_SAMPLE_HOLD_US.
+///
+const uint8_t padSettleTime_us[PAD_READINGS] =
+{
+    60, //readPressure0: multiplexer and plates switched
+    10, //readPressure1: ADC channel switched only
+    60, //readPressure2: plates switched
+    10, //readPressure3: ADC channel switched only
+    60, //readX: plates switched
+    60  //readY: plates switched
+};
 
 ///
 /// \brief Raw ADC pressure which corresponds with MIDI velocity 127.
@@ -25,6 +25,8 @@
 
 #include "../../../Board.h"
 #include "Descriptors.h"
+#include "board/common/constants/USB.h"
+#include "core/src/general/Timing.h"
 
 ///
 /// \ingroup board
@@ -35,6 +37,16 @@
 ///
 static USB_ClassInfo_MIDI_Device_t MIDI_Interface;
 
+///
+/// \brief Set if endpoint holds packets which haven't been sent yet.
+///
+static bool     usbMIDIpending;
+
+///
+/// \brief Time in milliseconds at which first pending packet has been written to endpoint.
+///
+static uint32_t usbMIDIpendingTime;
+
 
 ///
 /// \brief Event handler for the USB_ConfigurationChanged event.
@@ -86,6 +98,7 @@ bool usbRead(USBMIDIpacket_t& USBMIDIpacket)
 
 ///
 /// \brief Used to write data to USB interface.
+/// Packet is only stored into endpoint, see Board::flushUSBMIDI.
 /// @param [in] USBMIDIpacket       Pointer to structure holding data in which
 ///                                 USB data is stored.
 /// \returns                        True if there is writing to USB interface has
@@ -104,9 +117,16 @@ bool usbWrite(USBMIDIpacket_t& USBMIDIpacket)
         return false;
 
     if (!(Endpoint_IsReadWriteAllowed()))
+    {
+        //endpoint is full (USB_MIDI_BATCH_SIZE packets), send it right away
         Endpoint_ClearIN();
-
-    MIDI_Device_Flush(&MIDI_Interface);
+        usbMIDIpending = false;
+    }
+    else if (!usbMIDIpending)
+    {
+        usbMIDIpending = true;
+        usbMIDIpendingTime = rTimeMs();
+    }
 
     return true;
 }
@@ -129,3 +149,36 @@ void Board::initUSB_MIDI()
     midi.handleUSBread(usbRead);
     midi.handleUSBwrite(usbWrite);
 }
+
+void Board::flushUSBMIDI()
+{
+    if (!usbMIDIpending)
+        return;
+
+    MIDI_Device_Flush(&MIDI_Interface);
+    usbMIDIpending = false;
+}
+
+uint8_t Board::getUSBMIDIcapacity()
+{
+    //packets are dropped right away if device isn't configured
+    if (USB_DeviceState != DEVICE_STATE_Configured)
+        return 0xFF;
+
+    Endpoint_SelectEndpoint(MIDI_Interface.Config.DataINEndpoint.Address);
+
+    //previous batch hasn't been read by host yet
+    if (!Endpoint_IsINReady())
+        return 0;
+
+    return (MIDI_STREAM_EPSIZE - Endpoint_BytesInEndpoint()) / sizeof(USBMIDIpacket_t);
+}
+
+void Board::updateUSBMIDI()
+{
+    if (!usbMIDIpending)
+        return;
+
+    if ((rTimeMs() - usbMIDIpendingTime) >= USB_MIDI_FLUSH_TIMEOUT)
+        flushUSBMIDI();
+}
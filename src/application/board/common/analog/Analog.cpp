@@ -22,75 +22,150 @@
     <https://www.gnu.org/licenses/gpl-3.0.txt>
 */
 
+#include <stdlib.h>
 #include <util/atomic.h>
 #include "board/Board.h"
 #include "Variables.h"
+#include "Scan.h"
 #include "interface/analog/pads/DataTypes.h"
 #include "constants/Pads.h"
 #include "core/src/general/BitManipulation.h"
+#include "profiler/Profiler.h"
 
 ///
 /// \ingroup board
 /// @{
 
 volatile uint16_t   padPressed;
+volatile uint16_t   padTouched;
+uint16_t            padScanPressure = PAD_SCAN_ALL_PADS;
+uint16_t            padScanXY = PAD_SCAN_ALL_PADS;
+uint8_t             padScanIdlePad;
 uint16_t            pressurePlate1;
 padData_t           analogInBuffer[ANALOG_IN_BUFFER_SIZE];
-padData_t           analogInBufferReadOnly;
+padData_t           *analogInFrame = &analogInBuffer[0];
 uint8_t             activePad;
 uint8_t             padReadingIndex;
 volatile uint8_t    aIn_head;
 volatile uint8_t    aIn_tail;
 volatile uint8_t    aIn_count;
 
-/// @}
+///
+/// \brief Readout time of last non-zero pressure reading for each pad in profiler timer ticks.
+///
+static uint32_t     lastPressureTicks[NUMBER_OF_PADS];
 
+///
+/// \brief Holds debounced release state for all pads.
+/// Bit is set once pressure reading has been zero for PAD_RELEASED_DEBOUNCE_TIME_US.
+///
+static uint16_t     padReleaseDebounced;
 
-bool Board::padDataAvailable()
+///
+/// \brief Pressure reading for each pad at the moment it has been last marked as changed.
+/// Readings at or below PAD_PRESS_PRESSURE are stored as 0.
+///
+static uint16_t     lastChangedPressure[NUMBER_OF_PADS];
+
+///
+/// \brief Set while analogInFrame points to frame taken from ring buffer.
+///
+static bool         analogInFrameOwned;
+
+///
+/// \brief Holds changed state for all pads in current frame.
+///
+static uint16_t     padChanged;
+
+///
+/// \brief Updates changed state for all pads once new frame is available.
+/// Pad is considered changed if it's pressed, if its release debounce is still
+/// running or if its pressure has moved more than PAD_NOISE_THRESHOLD since the
+/// last time pad has been marked as changed. X and Y readings aren't checked since
+/// they're only processed while pad is pressed.
+///
+static void updateChangedPads()
 {
-    if (aIn_count)
+    padChanged = padPressed;
+
+    for (int i=0; i<NUMBER_OF_PADS; i++)
     {
-        #ifdef __AVR__
-        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
-        #endif
-        {
-            if (++aIn_tail == ANALOG_IN_BUFFER_SIZE)
-                aIn_tail = 0;
+        if (!BIT_READ(padReleaseDebounced, i))
+            BIT_SET(padChanged, i);
+
+        uint16_t pressure = analogInFrame->zReading[i];
+
+        if (pressure <= PAD_PRESS_PRESSURE)
+            pressure = 0;
+
+        if (abs(pressure - lastChangedPressure[i]) > PAD_NOISE_THRESHOLD)
+            BIT_SET(padChanged, i);
+
+        if (BIT_READ(padChanged, i))
+            lastChangedPressure[i] = pressure;
+    }
+}
+
+/// @}
+
 
-            for (int i=0; i<NUMBER_OF_PADS; i++)
-            {
-                analogInBufferReadOnly.zReading[i] = analogInBuffer[aIn_tail].zReading[i];
-                analogInBufferReadOnly.xReading[i] = analogInBuffer[aIn_tail].xReading[i];
-                analogInBufferReadOnly.yReading[i] = analogInBuffer[aIn_tail].yReading[i];
-            }
+bool Board::padDataAvailable()
+{
+    uint8_t count;
 
+    #ifdef __AVR__
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    #endif
+    {
+        //release previous frame to ISR
+        if (analogInFrameOwned)
             aIn_count--;
-        }
 
-        return true;
+        count = aIn_count;
     }
 
-    return false;
+    analogInFrameOwned = false;
+
+    if (!count)
+        return false;
+
+    //tail is only modified here and ISR never writes frame at tail while it's counted
+    if (++aIn_tail == ANALOG_IN_BUFFER_SIZE)
+        aIn_tail = 0;
+
+    analogInFrame = &analogInBuffer[aIn_tail];
+    analogInFrameOwned = true;
+
+    updateChangedPads();
+    return true;
 }
 
 int16_t Board::getPadX(uint8_t pad)
 {
-    return 1023 - analogInBufferReadOnly.xReading[pad];
+    return 1023 - analogInFrame->xReading[pad];
 }
 
 int16_t Board::getPadY(uint8_t pad)
 {
-    return analogInBufferReadOnly.yReading[pad];
+    return analogInFrame->yReading[pad];
 }
 
-int16_t Board::getPadPressure(uint8_t pad)
+uint32_t Board::getPadTicks()
 {
-    static uint8_t releaseDebounceCount[NUMBER_OF_PADS] = { 0 };
+    return analogInFrame->ticks;
+}
 
-    if (analogInBufferReadOnly.zReading[pad] >= PRESSURE_VALUES)
-        analogInBufferReadOnly.zReading[pad] = PRESSURE_VALUES-1;
+bool Board::padChangeDetected(uint8_t pad)
+{
+    return BIT_READ(padChanged, pad);
+}
 
-    uint16_t cVal = analogInBufferReadOnly.zReading[pad];
+int16_t Board::getPadPressure(uint8_t pad)
+{
+    if (analogInFrame->zReading[pad] >= PRESSURE_VALUES)
+        analogInFrame->zReading[pad] = PRESSURE_VALUES-1;
+
+    uint16_t cVal = analogInFrame->zReading[pad];
 
     //if pad is already pressed, return zero value only if it's smaller
     //or equal to PAD_RELEASE_PRESSURE
@@ -114,25 +189,29 @@ int16_t Board::getPadPressure(uint8_t pad)
 
     if (!cVal)
     {
-        if (releaseDebounceCount[pad] >= PAD_RELEASED_DEBOUNCE_COUNT)
+        if (BIT_READ(padReleaseDebounced, pad))
         {
             //really released
         }
+        else if ((analogInFrame->ticks - lastPressureTicks[pad]) >= (uint32_t)PAD_RELEASED_DEBOUNCE_TIME_US*PROFILER_TICKS_PER_US)
+        {
+            BIT_SET(padReleaseDebounced, pad);
+        }
         else
         {
             //not yet released
             cVal = 1;
-            releaseDebounceCount[pad]++;
         }
     }
     else
     {
-        releaseDebounceCount[pad] = 0;
+        lastPressureTicks[pad] = analogInFrame->ticks;
+        BIT_CLEAR(padReleaseDebounced, pad);
     }
 
     #ifdef DEBUG
     if (!pad)
-        printf("pad %d pressure: %d raw: %d\nx: %d\ny: %d\n\n", pad, cVal, analogInBufferReadOnly.zReading[pad], getPadX(pad), getPadY(pad));
+        printf("pad %d pressure: %d raw: %d\nx: %d\ny: %d\n\n", pad, cVal, analogInFrame->zReading[pad], getPadX(pad), getPadY(pad));
     #endif
 
     return cVal;
@@ -22,6 +22,8 @@
     <https://www.gnu.org/licenses/gpl-3.0.txt>
 */
 
+#pragma once
+
 #include "Hardware.h"
 
 ///
@@ -32,4 +34,5 @@ typedef struct
     volatile uint16_t zReading[NUMBER_OF_PADS]; ///< Reading of Z pad coordinate.
     volatile uint16_t xReading[NUMBER_OF_PADS]; ///< Reading of X pad coordinate.
     volatile uint16_t yReading[NUMBER_OF_PADS]; ///< Reading of Y pad coordinate.
+    volatile uint32_t ticks;                    ///< Profiler timer ticks at which readout has been completed.
 } padData_t;
\ No newline at end of file
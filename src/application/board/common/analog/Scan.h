@@ -0,0 +1,194 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#pragma once
+
+#include "board/common/DataTypes.h"
+#include "Variables.h"
+#include "constants/Pads.h"
+#include "core/src/general/BitManipulation.h"
+
+///
+/// \ingroup board
+/// @{
+
+///
+/// \brief Pad scan scheduling shared between ADC ISR and host simulation.
+/// Each scan reads pressure on pads set in padScanPressure and X/Y coordinates on
+/// pads set in padScanXY. Pads which aren't read keep readings from previous scan.
+/// @{
+
+///
+/// \brief Bitmask with all pads set.
+///
+#define PAD_SCAN_ALL_PADS   ((uint16_t)((1UL << NUMBER_OF_PADS) - 1))
+
+///
+/// \brief Number of ADC conversions needed for single pad reading.
+///
+#if PAD_SCAN_PIPELINE > 0
+#define PAD_SCAN_CONVERSIONS_PER_READING    1
+#else
+#define PAD_SCAN_CONVERSIONS_PER_READING    2
+#endif
+
+///
+/// \brief Selects pads which are read in next scan.
+/// Called once scan is complete.
+///
+inline void padScanPlan()
+{
+    #if PAD_SCAN_ADAPTIVE > 0
+    uint16_t active = padPressed | padTouched;
+
+    if (!active)
+    {
+        //nothing is touched, only check pressure on all pads
+        padScanPressure = PAD_SCAN_ALL_PADS;
+        padScanXY = 0;
+        return;
+    }
+
+    padScanPressure = active;
+    padScanXY = active;
+
+    //rotate through idle pads so that each one is checked within few scans
+    uint8_t idlePads = 0;
+
+    for (int i=0; (i<NUMBER_OF_PADS) && (idlePads<PAD_SCAN_IDLE_PADS); i++)
+    {
+        if (++padScanIdlePad >= NUMBER_OF_PADS)
+            padScanIdlePad = 0;
+
+        if (!BIT_READ(active, padScanIdlePad))
+        {
+            BIT_SET(padScanPressure, padScanIdlePad);
+            idlePads++;
+        }
+    }
+    #endif
+}
+
+///
+/// \brief Finds next pad which is read in current scan.
+/// @param [in] pad     Last read pad. Use -1 to get first pad.
+/// \returns Next pad or NUMBER_OF_PADS if there are no more pads to read.
+///
+inline uint8_t padScanNext(int8_t pad)
+{
+    while (++pad < NUMBER_OF_PADS)
+    {
+        if (BIT_READ(padScanPressure, pad))
+            break;
+    }
+
+    return pad;
+}
+
+///
+/// \brief Advances to reading which follows specified one in current scan.
+/// Once last reading in scan is passed, pads for next scan are selected.
+/// @param [in,out] pad         Pad which is being read.
+/// @param [in,out] reading     Reading on pad (enumerated type). See padReadOrder_t enumeration.
+/// \returns True if new scan has been started, false otherwise.
+///
+inline bool padScanAdvance(uint8_t &pad, uint8_t &reading)
+{
+    if ((reading == readY) || ((reading == readPressure3) && !BIT_READ(padScanXY, pad)))
+    {
+        //all readings on this pad are done
+        reading = readPressure0;
+        pad = padScanNext(pad);
+
+        if (pad == NUMBER_OF_PADS)
+        {
+            padScanPlan();
+            pad = padScanNext(-1);
+            return true;
+        }
+
+        return false;
+    }
+
+    reading++;
+    return false;
+}
+
+///
+/// \brief Marks pad as touched or untouched based on last pressure reading.
+/// @param [in] pad         Pad which has been read.
+/// @param [in] pressure    Raw pressure reading.
+///
+inline void padScanStorePressure(uint8_t pad, uint16_t pressure)
+{
+    if (pressure > PAD_PRESS_PRESSURE)
+        BIT_SET(padTouched, pad);
+    else
+        BIT_CLEAR(padTouched, pad);
+}
+
+///
+/// \brief Copies readings which aren't read in current scan from previous scan.
+/// @param [in,out] frame       Frame which is being filled in current scan.
+/// @param [in]     previous    Frame filled in previous scan.
+///
+inline void padScanCopy(padData_t &frame, const padData_t &previous)
+{
+    for (int i=0; i<NUMBER_OF_PADS; i++)
+    {
+        if (!BIT_READ(padScanPressure, i))
+            frame.zReading[i] = previous.zReading[i];
+
+        if (!BIT_READ(padScanXY, i))
+        {
+            frame.xReading[i] = previous.xReading[i];
+            frame.yReading[i] = previous.yReading[i];
+        }
+    }
+}
+
+///
+/// \brief Calculates number of ADC conversions needed for current scan.
+/// Unless pipelined readout is used, each reading is preceded by one discarded conversion.
+///
+inline uint8_t padScanConversions()
+{
+    uint8_t conversions = 0;
+
+    for (int i=0; i<NUMBER_OF_PADS; i++)
+    {
+        if (BIT_READ(padScanPressure, i))
+            conversions += (readX - readPressure0)*PAD_SCAN_CONVERSIONS_PER_READING;
+
+        if (BIT_READ(padScanXY, i))
+            conversions += (PAD_READINGS - readX)*PAD_SCAN_CONVERSIONS_PER_READING;
+    }
+
+    return conversions;
+}
+
+/// @}
+
+/// @}
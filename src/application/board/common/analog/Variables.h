@@ -22,6 +22,8 @@
     <https://www.gnu.org/licenses/gpl-3.0.txt>
 */
 
+#pragma once
+
 #include "Hardware.h"
 #include "DataTypes.h"
 #include "../constants/Analog.h"
@@ -47,6 +49,27 @@ extern volatile uint8_t     analogSampleCounter;
 ///
 extern volatile uint16_t    padPressed;
 
+///
+/// \brief Holds pads on which pressure above PAD_PRESS_PRESSURE has been read in last scan.
+/// Updated from ADC ISR so that pad is scanned fully before firmware marks it as pressed.
+///
+extern volatile uint16_t    padTouched;
+
+///
+/// \brief Pads on which pressure is read in current scan.
+///
+extern uint16_t             padScanPressure;
+
+///
+/// \brief Pads on which X and Y coordinates are read in current scan.
+///
+extern uint16_t             padScanXY;
+
+///
+/// \brief Last idle pad which has been added to scan.
+///
+extern uint8_t              padScanIdlePad;
+
 ///
 /// \brief Holds currently active coordinate reading for active pad.
 ///
@@ -65,10 +88,11 @@ extern uint16_t             pressurePlate1;
 extern padData_t            analogInBuffer[ANALOG_IN_BUFFER_SIZE];
 
 ///
-/// \brief Read only copy of ADC input buffer.
-/// Used to avoid data overwrite from ISR.
+/// \brief Pointer to ring buffer frame which is currently being processed.
+/// Frame is read in place. It stays counted in aIn_count until next frame is
+/// requested so that ISR can't overwrite it in the meantime.
 ///
-extern padData_t            analogInBufferReadOnly;
+extern padData_t            *analogInFrame;
 
 ///
 /// \brief Holds currently active pad (pad which is being processed).
@@ -0,0 +1,149 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#include <util/atomic.h>
+#include "Queue.h"
+
+///
+/// \ingroup board
+/// @{
+
+///
+/// \brief Single queued byte.
+///
+typedef struct
+{
+    uint16_t address;
+    uint8_t value;
+} eepromQueueEntry_t;
+
+///
+/// \brief Queue storage.
+/// @{
+
+static eepromQueueEntry_t   queue[EEPROM_QUEUE_SIZE];
+static volatile uint8_t     queueHead;
+static volatile uint8_t     queueCount;
+
+/// @}
+
+///
+/// \brief Returns index of n-th queued byte, starting from oldest one.
+///
+static inline uint8_t queueIndex(uint8_t n)
+{
+    uint8_t index = queueHead + n;
+
+    if (index >= EEPROM_QUEUE_SIZE)
+        index -= EEPROM_QUEUE_SIZE;
+
+    return index;
+}
+
+bool eepromQueueWrite(uint16_t address, uint8_t value)
+{
+    bool stored = true;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (queueCount && (queue[queueIndex(queueCount-1)].address == address))
+        {
+            //same address as last queued byte, replace it
+            queue[queueIndex(queueCount-1)].value = value;
+        }
+        else if (queueCount == EEPROM_QUEUE_SIZE)
+        {
+            stored = false;
+        }
+        else
+        {
+            uint8_t index = queueIndex(queueCount);
+
+            queue[index].address = address;
+            queue[index].value = value;
+            queueCount++;
+        }
+    }
+
+    return stored;
+}
+
+bool eepromQueueRead(uint16_t address, uint8_t &value)
+{
+    bool found = false;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        //newest byte for address is the one which ends up in eeprom
+        for (int i=queueCount-1; i>=0; i--)
+        {
+            uint8_t index = queueIndex(i);
+
+            if (queue[index].address == address)
+            {
+                value = queue[index].value;
+                found = true;
+                break;
+            }
+        }
+    }
+
+    return found;
+}
+
+void eepromQueueOverlay(uint16_t address, uint8_t *data, uint16_t size)
+{
+    //apply oldest first so that newest byte for address remains
+    for (int i=0; i<queueCount; i++)
+    {
+        uint8_t index = queueIndex(i);
+
+        if ((queue[index].address >= address) && (queue[index].address < (address+size)))
+            data[queue[index].address-address] = queue[index].value;
+    }
+}
+
+bool eepromQueueNext(uint16_t &address, uint8_t &value)
+{
+    if (!queueCount)
+        return false;
+
+    address = queue[queueHead].address;
+    value = queue[queueHead].value;
+
+    if (++queueHead == EEPROM_QUEUE_SIZE)
+        queueHead = 0;
+
+    queueCount--;
+
+    return true;
+}
+
+uint8_t eepromQueueCount()
+{
+    return queueCount;
+}
+
+/// @}
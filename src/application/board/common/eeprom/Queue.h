@@ -0,0 +1,98 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#pragma once
+
+#include <inttypes.h>
+
+///
+/// \ingroup board
+/// @{
+
+///
+/// \brief Outgoing EEPROM write queue.
+/// Bytes are written to EEPROM from EE_READY ISR in order in which they've been queued,
+/// so that main loop doesn't wait for each write to complete. Byte written to same
+/// address as last queued byte replaces it, otherwise it's added after it even if its
+/// address is already queued, so that order of writes is always preserved.
+/// @{
+
+///
+/// \brief Number of bytes which can be queued.
+/// Single byte takes 3.3 ms to write.
+///
+#define EEPROM_QUEUE_SIZE   32
+
+///
+/// \brief Number of bytes read from EEPROM at once during bulk reads.
+/// Interrupts are disabled during each chunk, and each chunk waits for byte
+/// which is being written, if any.
+///
+#define EEPROM_READ_CHUNK_SIZE  8
+
+///
+/// \brief Adds byte to queue.
+/// Needs to be called from main loop only.
+/// @param [in] address Address in which byte is written.
+/// @param [in] value   Byte to write.
+/// \returns True if byte has been queued, false if queue is full.
+///
+bool eepromQueueWrite(uint16_t address, uint8_t value);
+
+///
+/// \brief Checks whether byte at specified address is queued.
+/// Needs to be called from main loop only.
+/// @param [in] address     Address which is being checked.
+/// @param [in,out] value   Last queued byte for address, if found.
+/// \returns True if byte is queued, false otherwise.
+///
+bool eepromQueueRead(uint16_t address, uint8_t &value);
+
+///
+/// \brief Replaces bytes read from EEPROM with queued ones.
+/// Needs to be called with interrupts disabled, together with EEPROM read.
+/// @param [in] address     Address from which bytes have been read.
+/// @param [in,out] data    Bytes read from EEPROM.
+/// @param [in] size        Number of read bytes.
+///
+void eepromQueueOverlay(uint16_t address, uint8_t *data, uint16_t size);
+
+///
+/// \brief Removes oldest byte from queue.
+/// Needs to be called from EE_READY ISR (or with interrupts disabled).
+/// @param [in,out] address Address in which byte needs to be written.
+/// @param [in,out] value   Byte to write.
+/// \returns True if byte has been retrieved, false if queue is empty.
+///
+bool eepromQueueNext(uint16_t &address, uint8_t &value);
+
+///
+/// \brief Returns number of queued bytes.
+///
+uint8_t eepromQueueCount();
+
+/// @}
+
+/// @}
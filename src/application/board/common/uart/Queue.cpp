@@ -0,0 +1,415 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#include <util/atomic.h>
+#include "Queue.h"
+
+///
+/// \ingroup board
+/// @{
+
+///
+/// \brief Total number of messages in all lanes.
+///
+#define UART_QUEUE_SIZE     (UART_QUEUE_NOTE_SIZE+UART_QUEUE_PITCH_BEND_SIZE+UART_QUEUE_CONTROL_SIZE)
+
+///
+/// \brief Single queued message.
+/// SysEx is queued byte by byte, as single byte messages.
+///
+typedef struct
+{
+    uint8_t data[3];
+    uint8_t length;
+} uartMessage_t;
+
+///
+/// \brief Storage for all lanes.
+/// @{
+
+static uartMessage_t        queue[UART_QUEUE_SIZE];
+
+static const uint8_t        laneStart[UART_LANES] =
+{
+    0,
+    UART_QUEUE_NOTE_SIZE,
+    UART_QUEUE_NOTE_SIZE+UART_QUEUE_PITCH_BEND_SIZE
+};
+
+static const uint8_t        laneSize[UART_LANES] =
+{
+    UART_QUEUE_NOTE_SIZE,
+    UART_QUEUE_PITCH_BEND_SIZE,
+    UART_QUEUE_CONTROL_SIZE
+};
+
+static volatile uint8_t     laneHead[UART_LANES];
+static volatile uint8_t     laneCount[UART_LANES];
+
+/// @}
+
+volatile uint16_t           uartQueueOverflow[UART_LANES];
+
+///
+/// \brief Message which is being collected from written bytes.
+/// @{
+
+static uartMessage_t        pending;
+static uint8_t              pendingIndex;
+static uint8_t              runningStatus;
+
+/// @}
+
+///
+/// \brief Set while MIDI library leaves out repeated status bytes.
+/// Library omits status byte only if running status is enabled, and repeats it only if
+/// it's disabled, so the setting is taken from written bytes. Status byte is then left
+/// out on the wire as well whenever it's the same as the last one sent (see sentStatus).
+///
+static volatile bool        runningStatusEnabled;
+
+///
+/// \brief SysEx state on writing side.
+/// sysExWrite is set while SysEx is being written. sysExOpen is set while SysEx start is in
+/// queue and its end hasn't been queued yet, so that UDRE ISR waits for rest of SysEx instead
+/// of sending messages from other lanes.
+/// @{
+
+static bool                 sysExWrite;
+static volatile bool        sysExOpen;
+
+/// @}
+
+///
+/// \brief Message which is being sent from UDRE ISR.
+/// @{
+
+static uartMessage_t        current;
+static uint8_t              currentIndex;
+static bool                 sysExRead;
+static uint8_t              sentStatus;
+
+/// @}
+
+///
+/// \brief Returns length of message with specified status byte.
+///
+static uint8_t messageLength(uint8_t status)
+{
+    switch(status & 0xF0)
+    {
+        case 0xC0:
+        case 0xD0:
+        return 2;
+
+        case 0xF0:
+        switch(status)
+        {
+            case 0xF1:
+            case 0xF3:
+            return 2;
+
+            case 0xF2:
+            return 3;
+
+            default:
+            return 1;
+        }
+
+        default:
+        return 3;
+    }
+}
+
+///
+/// \brief Returns lane in which message with specified status byte is queued.
+///
+static uartLane_t messageLane(uint8_t status)
+{
+    switch(status & 0xF0)
+    {
+        case 0xE0:
+        return uartLanePitchBend;
+
+        case 0xA0:
+        case 0xB0:
+        case 0xD0:
+        return uartLaneControl;
+
+        default:
+        return uartLaneNotes;
+    }
+}
+
+///
+/// \brief Checks whether message is note off, or note on with zero velocity.
+///
+static bool messageNoteOff(const uartMessage_t &message)
+{
+    switch(message.data[0] & 0xF0)
+    {
+        case 0x80:
+        return true;
+
+        case 0x90:
+        return !message.data[2];
+
+        default:
+        return false;
+    }
+}
+
+///
+/// \brief Stores message into lane.
+/// @param [in] lane        Lane in which message is stored.
+/// @param [in] message     Message to store.
+/// @param [in] wait        If set to true, message isn't dropped from full note lane and
+///                         isn't counted as overflow, caller needs to retry instead.
+/// \returns False if message hasn't been stored, true otherwise.
+///
+static bool enqueue(uartLane_t lane, const uartMessage_t &message, bool wait = false)
+{
+    bool stored = true;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (laneCount[lane] == laneSize[lane])
+        {
+            if (!wait)
+                uartQueueOverflow[lane]++;
+
+            if (lane == uartLaneNotes)
+            {
+                stored = false;
+            }
+            else
+            {
+                //make space by dropping oldest value
+                if (++laneHead[lane] == laneSize[lane])
+                    laneHead[lane] = 0;
+
+                laneCount[lane]--;
+            }
+        }
+
+        if (stored)
+        {
+            uint8_t index = laneHead[lane] + laneCount[lane];
+
+            if (index >= laneSize[lane])
+                index -= laneSize[lane];
+
+            queue[laneStart[lane]+index] = message;
+            laneCount[lane]++;
+        }
+    }
+
+    return stored;
+}
+
+///
+/// \brief Stores single SysEx byte into note lane.
+/// SysEx can't be thinned without breaking it and it's sent only as a response to
+/// configuration requests, so this waits for free space in note lane instead of dropping.
+/// Note lane is never full while transmit interrupt is disabled.
+///
+static void enqueueSysEx(uint8_t data)
+{
+    uartMessage_t message = { { data, 0, 0 }, 1 };
+
+    while (!enqueue(uartLaneNotes, message, true));
+}
+
+void uartQueueInit()
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        for (int i=0; i<UART_LANES; i++)
+        {
+            laneHead[i] = 0;
+            laneCount[i] = 0;
+            uartQueueOverflow[i] = 0;
+        }
+
+        pendingIndex = 0;
+        runningStatus = 0;
+        runningStatusEnabled = false;
+        sysExWrite = false;
+        sysExOpen = false;
+        current.length = 0;
+        currentIndex = 0;
+        sysExRead = false;
+        sentStatus = 0;
+    }
+}
+
+bool uartQueueWrite(uint8_t data)
+{
+    if (data >= 0xF8)
+    {
+        //real time message, can be sent anywhere
+        uartMessage_t message = { { data, 0, 0 }, 1 };
+        return enqueue(uartLaneNotes, message);
+    }
+
+    if (data & 0x80)
+    {
+        if (sysExWrite)
+        {
+            sysExWrite = false;
+
+            if (data == 0xF7)
+            {
+                enqueueSysEx(data);
+                sysExOpen = false;
+                return true;
+            }
+
+            //SysEx ended without end byte
+            sysExOpen = false;
+        }
+
+        if (data == 0xF0)
+        {
+            sysExWrite = true;
+            runningStatus = 0;
+            pendingIndex = 0;
+            enqueueSysEx(data);
+            sysExOpen = true;
+            return true;
+        }
+
+        if (data == runningStatus)
+            runningStatusEnabled = false;
+
+        pending.data[0] = data;
+        pending.length = messageLength(data);
+        pendingIndex = 1;
+        runningStatus = (data < 0xF0) ? data : 0;
+    }
+    else
+    {
+        if (sysExWrite)
+        {
+            enqueueSysEx(data);
+            return true;
+        }
+
+        if (!pendingIndex)
+        {
+            //running status
+            if (!runningStatus)
+                return false;
+
+            pending.data[0] = runningStatus;
+            pending.length = messageLength(runningStatus);
+            pendingIndex = 1;
+            runningStatusEnabled = true;
+        }
+
+        pending.data[pendingIndex++] = data;
+    }
+
+    if (pendingIndex == pending.length)
+    {
+        pendingIndex = 0;
+
+        //dropped note off would leave note hanging, wait for free space instead
+        if (messageNoteOff(pending))
+        {
+            while (!enqueue(uartLaneNotes, pending, true));
+            return true;
+        }
+
+        return enqueue(messageLane(pending.data[0]), pending);
+    }
+
+    return true;
+}
+
+uint8_t uartQueueFree(uartLane_t lane)
+{
+    return laneSize[lane] - laneCount[lane];
+}
+
+int16_t uartQueueRead()
+{
+    if (currentIndex < current.length)
+        return current.data[currentIndex++];
+
+    if (sysExRead && !laneCount[uartLaneNotes])
+    {
+        //wait for rest of SysEx
+        if (sysExOpen)
+            return -1;
+
+        sysExRead = false;
+    }
+
+    uint8_t lane;
+
+    for (lane=0; lane<UART_LANES; lane++)
+    {
+        if (laneCount[lane])
+            break;
+    }
+
+    if (lane == UART_LANES)
+        return -1;
+
+    current = queue[laneStart[lane]+laneHead[lane]];
+
+    if (++laneHead[lane] == laneSize[lane])
+        laneHead[lane] = 0;
+
+    laneCount[lane]--;
+
+    uint8_t status = current.data[0];
+
+    if (status == 0xF0)
+        sysExRead = true;
+    else if ((status & 0x80) && (status < 0xF8))
+        sysExRead = false;
+
+    currentIndex = 1;
+
+    if ((status & 0x80) && (status < 0xF0))
+    {
+        //lanes are interleaved, so status is compared with the one sent last instead of the one written last
+        if (runningStatusEnabled && (status == sentStatus))
+            return current.data[currentIndex++];
+
+        sentStatus = status;
+    }
+    else if ((status & 0x80) && (status < 0xF8))
+    {
+        //SysEx and system common messages cancel running status, real time messages don't
+        sentStatus = 0;
+    }
+
+    return status;
+}
+
+/// @}
@@ -0,0 +1,106 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#pragma once
+
+#include <inttypes.h>
+
+///
+/// \ingroup board
+/// @{
+
+///
+/// \brief Outgoing UART (DIN) MIDI queue.
+/// MIDI library writes messages byte by byte. Bytes are collected into complete messages
+/// which are then stored into one of the lanes based on message type. UDRE ISR always
+/// sends messages from note lane first, then pitch bend and controller lanes, and never
+/// interleaves bytes of two messages. Writing channel messages doesn't wait for free space:
+/// once lane is full, message is dropped and counted in uartQueueOverflow. Note lane drops
+/// new message, while pitch bend and controller lanes drop oldest one so that controller
+/// data is only thinned and most recent values are still sent. Note off messages and SysEx
+/// are the only exceptions: they wait for free space in note lane instead (see
+/// uartQueueWrite). Running status is kept across lanes if MIDI library uses it: status
+/// byte is left out whenever it's the same as the status of message sent last.
+/// @{
+
+///
+/// \brief List of queue lanes, in order of priority.
+///
+typedef enum
+{
+    uartLaneNotes,      ///< Note on/off, program change, system messages and SysEx.
+    uartLanePitchBend,  ///< Pitch bend.
+    uartLaneControl,    ///< Control change and aftertouch.
+    UART_LANES
+} uartLane_t;
+
+///
+/// \brief Number of messages which can be stored in each lane.
+/// Single three-byte message takes 0.96 ms on 31250 baud.
+/// @{
+
+#define UART_QUEUE_NOTE_SIZE        32
+#define UART_QUEUE_PITCH_BEND_SIZE  8
+#define UART_QUEUE_CONTROL_SIZE     16
+
+/// @}
+
+///
+/// \brief Number of messages dropped on each lane since queue initialization.
+///
+extern volatile uint16_t uartQueueOverflow[UART_LANES];
+
+///
+/// \brief Empties all lanes and resets overflow counters.
+///
+void uartQueueInit();
+
+///
+/// \brief Adds outgoing byte to queue.
+/// Byte is stored into lane once message it belongs to is complete. SysEx bytes are
+/// stored one by one and wait for free space in note lane, and so do note off messages
+/// since dropping one would leave note hanging. Needs to be called from main loop only,
+/// with interrupts enabled.
+/// @param [in] data    Byte written by MIDI library.
+/// \returns True if byte has been accepted (message is queued or not yet complete), false if message has been dropped.
+///
+bool uartQueueWrite(uint8_t data);
+
+///
+/// \brief Returns number of messages which can be stored into lane without dropping any.
+/// @param [in] lane    Lane which is being checked.
+///
+uint8_t uartQueueFree(uartLane_t lane);
+
+///
+/// \brief Retrieves next byte to send.
+/// Needs to be called from UDRE ISR (or with interrupts disabled).
+/// \returns Next byte or -1 if there is nothing to send.
+///
+int16_t uartQueueRead();
+
+/// @}
+
+/// @}
@@ -0,0 +1,212 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#include <stdio.h>
+#include "Host.h"
+#include "database/Database.h"
+
+///
+/// \ingroup boardHost
+/// @{
+
+//parameter reads with address known at compile time (see Database::read<blockID, sectionID>).
+//Random values are written to checked sections (some of which are still in write cache when
+//read), after which every parameter of each section is read with both methods and compared.
+//Parameters outside of section need to be read the same as well, and so do parameters of
+//log ring sections, which are read with Database::readLog instead. Time spent on reading all parameters with each method is reported.
+//Compare is repeated once write cache has been flushed, when compile time reads skip write
+//cache lookup and default map overlay for parameters outside of default chunks.
+
+///
+/// \brief Number of random settings changes before compare.
+///
+#define ACCESS_RANDOM_WRITES    500
+
+///
+/// \brief Number of times all parameters are read with each method.
+///
+#define ACCESS_READ_ROUNDS      200
+
+///
+/// \brief Time spent on reading with each method in nanoseconds and number of reads.
+/// @{
+
+static uint64_t accessRuntime_ns;
+static uint64_t accessStatic_ns;
+static uint32_t accessReads;
+
+/// @}
+
+///
+/// \brief Seed of pseudo-random numbers (see hostRandom).
+///
+static uint32_t accessSeed = 7;
+
+///
+/// \brief Returns number of parameters in section.
+///
+static uint16_t accessParameters(uint8_t blockID, uint8_t sectionID)
+{
+    int32_t value;
+    uint16_t parameters = 0;
+
+    while (database.read(blockID, sectionID, parameters, value))
+        parameters++;
+
+    return parameters;
+}
+
+///
+/// \brief Writes random values to random parameters of section.
+///
+static void accessWriteRandom(uint8_t blockID, uint8_t sectionID, uint8_t mask)
+{
+    uint16_t parameters = accessParameters(blockID, sectionID);
+
+    for (int i=0; i<ACCESS_RANDOM_WRITES; i++)
+        database.update(blockID, sectionID, hostRandom(accessSeed) % parameters, hostRandom(accessSeed) & mask);
+}
+
+///
+/// \brief Reads parameter with address known at compile time, or from RAM if section is stored in log ring.
+/// @{
+
+template<uint8_t blockID, uint8_t sectionID, bool log = dbLogSection(blockID, sectionID)>
+struct accessStatic
+{
+    static int32_t read(uint16_t parameterID)
+    {
+        return database.read<blockID, sectionID>(parameterID);
+    }
+};
+
+template<uint8_t blockID, uint8_t sectionID>
+struct accessStatic<blockID, sectionID, true>
+{
+    static int32_t read(uint16_t parameterID)
+    {
+        return database.readLog<blockID, sectionID>(parameterID);
+    }
+};
+
+/// @}
+
+///
+/// \brief Compares all parameters of section read with both methods and times both methods.
+/// \returns Number of parameters which differ.
+///
+template<uint8_t blockID, uint8_t sectionID>
+static uint32_t accessCompare()
+{
+    uint16_t parameters = accessParameters(blockID, sectionID);
+    uint32_t mismatches = 0;
+    int32_t sum = 0;
+
+    //one past last parameter is read as well
+    for (uint16_t i=0; i<=parameters; i++)
+    {
+        if (database.read(blockID, sectionID, i) != accessStatic<blockID, sectionID>::read(i))
+            mismatches++;
+    }
+
+    uint64_t start_ns = hostTime_ns();
+
+    for (int r=0; r<ACCESS_READ_ROUNDS; r++)
+    {
+        for (uint16_t i=0; i<parameters; i++)
+            sum += database.read(blockID, sectionID, i);
+    }
+
+    accessRuntime_ns += hostTime_ns() - start_ns;
+    start_ns = hostTime_ns();
+
+    for (int r=0; r<ACCESS_READ_ROUNDS; r++)
+    {
+        for (uint16_t i=0; i<parameters; i++)
+            sum -= accessStatic<blockID, sectionID>::read(i);
+    }
+
+    accessStatic_ns += hostTime_ns() - start_ns;
+    accessReads += (uint32_t)parameters*ACCESS_READ_ROUNDS;
+
+    //both methods need to read the same
+    if (sum)
+        mismatches++;
+
+    return mismatches;
+}
+
+/// @}
+
+///
+/// \brief Compares all checked sections and reports read times.
+/// @param [in] state   Write cache state, used in report only.
+/// \returns Number of parameters which differ.
+///
+static uint32_t accessCompareAll(const char *state)
+{
+    uint32_t mismatches = 0;
+
+    accessRuntime_ns = 0;
+    accessStatic_ns = 0;
+    accessReads = 0;
+
+    mismatches += accessCompare<DB_BLOCK_PROGRAM, programLastActiveProgramSection>();
+    mismatches += accessCompare<DB_BLOCK_PROGRAM, programLastActiveScaleSection>();
+    mismatches += accessCompare<DB_BLOCK_PROGRAM, programGlobalSettingsSection>();
+    mismatches += accessCompare<DB_BLOCK_PROGRAM, programLocalSettingsSection>();
+    mismatches += accessCompare<DB_BLOCK_SCALE, scalePredefinedSection>();
+    mismatches += accessCompare<DB_BLOCK_SCALE, scaleUserSection>();
+    mismatches += accessCompare<DB_BLOCK_PAD_CALIBRATION, padCalibrationPressureUpperSection>();
+    mismatches += accessCompare<DB_BLOCK_PAD_CALIBRATION, padCalibrationXlowerSection>();
+    mismatches += accessCompare<DB_BLOCK_PAD_CALIBRATION, padCalibrationXupperSection>();
+    mismatches += accessCompare<DB_BLOCK_PAD_CALIBRATION, padCalibrationYlowerSection>();
+    mismatches += accessCompare<DB_BLOCK_PAD_CALIBRATION, padCalibrationYupperSection>();
+    mismatches += accessCompare<DB_BLOCK_GLOBAL_SETTINGS, globalSettingsMIDI>();
+    mismatches += accessCompare<DB_BLOCK_GLOBAL_SETTINGS, globalSettingsVelocitySensitivity>();
+    mismatches += accessCompare<DB_BLOCK_PROGRAM_EXTENDED, programExtendedSettingsSection>();
+
+    fprintf(stderr, "parameter reads, %s write cache: %u reads, runtime address %.1f ns/read, compile time address %.1f ns/read, %u mismatches\n",
+        state, accessReads, (double)accessRuntime_ns/accessReads, (double)accessStatic_ns/accessReads, mismatches);
+
+    return mismatches;
+}
+
+uint32_t hostAccessBenchmark()
+{
+    uint32_t mismatches = 0;
+
+    accessWriteRandom(DB_BLOCK_PROGRAM, programLocalSettingsSection, 0x7F);
+    accessWriteRandom(DB_BLOCK_SCALE, scalePredefinedSection, 0x7F);
+    accessWriteRandom(DB_BLOCK_PAD_CALIBRATION, padCalibrationXlowerSection, 0xFF);
+    accessWriteRandom(DB_BLOCK_GLOBAL_SETTINGS, globalSettingsMIDI, 0x01);
+
+    mismatches += accessCompareAll("dirty");
+
+    writeCache.flush();
+    mismatches += accessCompareAll("empty");
+
+    return mismatches;
+}
@@ -0,0 +1,272 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <avr/interrupt.h>
+#include "Host.h"
+#include "board/Board.h"
+#include "core/src/general/Misc.h"
+#include "database/Database.h"
+#include "database/WriteCache.h"
+#include "util/delay.h"
+#include "interface/analog/pads/Scaler.h"
+#include "interface/analog/pads/curves/Curves.h"
+
+///
+/// \ingroup boardHost
+/// @{
+
+//harness which runs host benchmarks listed in benchList, followed by microbenchmark of
+//pad value scaling: division based range mapping (Curves::map) against precomputed
+//fixed-point multipliers (Scaler.h). Both paths are first compared for every input
+//range for which multiplier is defined and every value in that range, after which
+//both are timed on same set of values.
+
+///
+/// \brief Number of scaled values per timed pass.
+///
+#define BENCH_TIMED_VALUES      4000000
+
+///
+/// \brief Compares both scaling paths for all ranges and values for specified output range.
+/// @param [in] outRange    Largest output value.
+/// @param [in] shift       Fixed-point shift.
+/// \returns Number of mismatched values.
+///
+static uint32_t benchVerify(uint16_t outRange, uint8_t shift)
+{
+    uint32_t mismatches = 0;
+    uint32_t checked = 0;
+    int32_t range;
+
+    for (range=1; ; range++)
+    {
+        uint32_t multiplier = scalerMultiplier(range, outRange, shift);
+
+        if (!multiplier)
+            break;
+
+        //constant lower limit, values outside limits are constrained the same way on both paths
+        for (int32_t value=0; value<=range; value++)
+        {
+            int32_t expected = curves.map(value, 0, range, 0, outRange);
+            uint16_t result = scalerApply(value, multiplier, shift);
+
+            checked++;
+
+            if (result != expected)
+            {
+                if (!mismatches)
+                    fprintf(stderr, "mismatch: range %d, value %d, expected %d, got %d\n", range, value, expected, result);
+
+                mismatches++;
+            }
+        }
+    }
+
+    fprintf(stderr, "output 0-%d: input ranges 1-%d, %u values compared, %u mismatches\n", outRange, range-1, checked, mismatches);
+
+    return mismatches;
+}
+
+///
+/// \brief Times both scaling paths on pseudo-random pad readings.
+/// @param [in] outRange    Largest output value.
+/// @param [in] shift       Fixed-point shift.
+///
+static void benchTime(uint16_t outRange, uint8_t shift)
+{
+    //typical calibrated pad: limits within 0-1023
+    const uint16_t lower = 85;
+    const uint16_t upper = 950;
+    uint32_t multiplier = scalerMultiplier(upper - lower, outRange, shift);
+    volatile uint32_t sink = 0;
+    uint32_t seed = 1;
+    uint64_t start, mapTime, scalerTime;
+
+    start = hostTime_ns();
+
+    for (uint32_t i=0; i<BENCH_TIMED_VALUES; i++)
+    {
+        uint16_t value = hostRandom(seed) & 0x3FF;
+        sink += curves.map(CONSTRAIN(value, lower, upper), lower, upper, 0, outRange);
+    }
+
+    mapTime = hostTime_ns() - start;
+    seed = 1;
+    start = hostTime_ns();
+
+    for (uint32_t i=0; i<BENCH_TIMED_VALUES; i++)
+    {
+        uint16_t value = hostRandom(seed) & 0x3FF;
+        sink += scalerApply(CONSTRAIN(value, lower, upper) - lower, multiplier, shift);
+    }
+
+    scalerTime = hostTime_ns() - start;
+
+    fprintf(stderr, "output 0-%d: map %.2f ns/value, scaler %.2f ns/value\n", outRange,
+        (double)mapTime/BENCH_TIMED_VALUES, (double)scalerTime/BENCH_TIMED_VALUES);
+}
+
+///
+/// \brief Runs scaler microbenchmark.
+/// \returns Number of values which differ.
+///
+static uint32_t benchScaler()
+{
+    uint32_t mismatches = 0;
+
+    mismatches += benchVerify(127, SCALER_SHIFT_7B);
+    mismatches += benchVerify(1023, SCALER_SHIFT_RAW);
+
+    benchTime(127, SCALER_SHIFT_7B);
+    benchTime(1023, SCALER_SHIFT_RAW);
+
+    return mismatches;
+}
+
+///
+/// \brief Single host benchmark.
+///
+typedef struct
+{
+    const char *name;       ///< Name with which benchmark is selected in ZVUK9_BENCH.
+    uint32_t (*run)();      ///< Runs benchmark and returns number of failed checks.
+    bool database;          ///< Set if benchmark accesses database. Database is initialized and interrupts are enabled, as in firmware.
+} benchEntry_t;
+
+///
+/// \brief List of all host benchmarks in order in which they're run.
+///
+static const benchEntry_t benchList[] =
+{
+    { "scaler",     benchScaler,                false },
+    { "settle",     hostSettleBenchmark,        false },
+    { "strike",     hostStrikeBenchmark,        false },
+    { "swipe",      hostSwipeBenchmark,         false },
+    { "program",    hostProgramBenchmark,       true },
+    { "settings",   hostSettingsBenchmark,      true },
+    { "log",        hostLogBenchmark,           true },
+    { "reset",      hostResetBenchmark,         true },
+    { "access",     hostAccessBenchmark,        true },
+    { "migration",  hostMigrationBenchmark,     true },
+    { "storage",    hostStorageBenchmark,       true },
+};
+
+///
+/// \brief Checks if benchmark is selected in ZVUK9_BENCH.
+/// @param [in] list    Value of ZVUK9_BENCH: "1" or "all" for all benchmarks, or comma-separated names.
+/// @param [in] name    Benchmark name.
+///
+static bool benchSelected(const char *list, const char *name)
+{
+    if (!strcmp(list, "1") || !strcmp(list, "all"))
+        return true;
+
+    size_t length = strlen(name);
+
+    while (*list)
+    {
+        if (!strncmp(list, name, length) && ((list[length] == ',') || !list[length]))
+            return true;
+
+        list = strchr(list, ',');
+
+        if (list == NULL)
+            break;
+
+        list++;
+    }
+
+    return false;
+}
+
+/// @}
+
+uint32_t hostRandom(uint32_t &seed)
+{
+    seed = seed*1103515245 + 12345;
+    return seed >> 16;
+}
+
+uint64_t hostTime_ns()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec*1000000000ULL + ts.tv_nsec;
+}
+
+void hostDrain()
+{
+    writeCache.flush();
+
+    while (!Board::memoryReady())
+        hostDelay_us(1000);
+}
+
+void hostBenchmark()
+{
+    const char *list = getenv("ZVUK9_BENCH");
+
+    if (list == NULL)
+        return;
+
+    uint32_t failed = 0;
+    uint8_t count = 0;
+
+    for (size_t i=0; i<sizeof(benchList)/sizeof(benchList[0]); i++)
+    {
+        if (!benchSelected(list, benchList[i].name))
+            continue;
+
+        if (benchList[i].database)
+        {
+            //firmware accesses database with interrupts enabled
+            sei();
+            database.init();
+        }
+        else
+        {
+            cli();
+        }
+
+        uint64_t start_ns = hostTime_ns();
+        uint32_t result = benchList[i].run();
+
+        fprintf(stderr, "bench %s: %u failed checks, %.0f ms\n", benchList[i].name, result, (hostTime_ns() - start_ns)/1e6);
+
+        failed += result;
+        count++;
+    }
+
+    if (!count)
+        fprintf(stderr, "ZVUK9_BENCH: no benchmark named %s\n", list);
+
+    exit((failed || !count) ? EXIT_FAILURE : EXIT_SUCCESS);
+}
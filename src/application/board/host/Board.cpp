@@ -0,0 +1,86 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#include "Host.h"
+#include "board/Board.h"
+#include "board/common/analog/Variables.h"
+#include "profiler/Profiler.h"
+
+///
+/// \ingroup boardHost
+/// @{
+
+Board::Board()
+{
+
+}
+
+void Board::init()
+{
+    initPins();
+    initPads();
+    hostBenchmark();
+    hostEEPROMinit();
+    hostScriptInit();
+    initUSB_MIDI();
+    initUART_MIDI();
+    initTimers();
+}
+
+void Board::initPins()
+{
+    //nothing to do on host
+}
+
+void Board::initTimers()
+{
+    //timers are simulated, see hostDelay_us
+}
+
+void Board::initPads()
+{
+    padReadingIndex = readPressure0;
+    activePad = 0;
+}
+
+void Board::reboot()
+{
+    //there is nothing to reboot into - end simulation instead
+    hostExit();
+}
+
+bool Board::checkNewRevision()
+{
+    return false;
+}
+
+uint32_t Board::getProfilerTicks()
+{
+    return hostTime_us()*PROFILER_TICKS_PER_US;
+}
+
+Board board;
+
+/// @}
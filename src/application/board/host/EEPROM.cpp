@@ -0,0 +1,160 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <avr/eeprom.h>
+#include "Host.h"
+
+///
+/// \ingroup boardHost
+/// @{
+
+///
+/// \brief Simulated EEPROM contents.
+///
+static uint8_t eepromMemory[EEPROM_SIZE];
+
+uint32_t hostEEPROMreads;
+uint32_t hostEEPROMwrites;
+
+///
+/// \brief Number of writes of each simulated EEPROM byte.
+///
+static uint32_t eepromCellWrites[EEPROM_SIZE];
+
+///
+/// \brief Path to EEPROM image file or NULL if contents shouldn't persist.
+///
+static const char *eepromImagePath;
+
+///
+/// \brief Wraps address into simulated EEPROM range, same as hardware does.
+///
+static inline uint16_t eepromAddress(const void *address)
+{
+    return (uint16_t)((uintptr_t)address % EEPROM_SIZE);
+}
+
+/// @}
+
+void hostEEPROMinit()
+{
+    memset(eepromMemory, 0xFF, sizeof(eepromMemory));
+
+    eepromImagePath = getenv("ZVUK9_EEPROM");
+
+    if (eepromImagePath == NULL)
+        return;
+
+    FILE *image = fopen(eepromImagePath, "rb");
+
+    if (image == NULL)
+        return;
+
+    if (fread(eepromMemory, 1, sizeof(eepromMemory), image) != sizeof(eepromMemory))
+        fprintf(stderr, "EEPROM image %s is incomplete\n", eepromImagePath);
+
+    fclose(image);
+}
+
+void hostEEPROMsave()
+{
+    if (eepromImagePath == NULL)
+        return;
+
+    FILE *image = fopen(eepromImagePath, "wb");
+
+    if (image == NULL)
+    {
+        fprintf(stderr, "Unable to write EEPROM image %s\n", eepromImagePath);
+        return;
+    }
+
+    fwrite(eepromMemory, 1, sizeof(eepromMemory), image);
+    fclose(image);
+}
+
+uint32_t hostEEPROMcellWrites(uint16_t address)
+{
+    return eepromCellWrites[address % EEPROM_SIZE];
+}
+
+uint8_t eeprom_read_byte(const uint8_t *address)
+{
+    hostEEPROMreads++;
+    return eepromMemory[eepromAddress(address)];
+}
+
+uint16_t eeprom_read_word(const uint16_t *address)
+{
+    uint16_t value = 0;
+
+    for (int i=1; i>=0; i--)
+        value = (value << 8) | eeprom_read_byte((const uint8_t*)address + i);
+
+    return value;
+}
+
+uint32_t eeprom_read_dword(const uint32_t *address)
+{
+    uint32_t value = 0;
+
+    for (int i=3; i>=0; i--)
+        value = (value << 8) | eeprom_read_byte((const uint8_t*)address + i);
+
+    return value;
+}
+
+void eeprom_read_block(void *data, const void *address, size_t size)
+{
+    for (size_t i=0; i<size; i++)
+        ((uint8_t*)data)[i] = eeprom_read_byte((const uint8_t*)address + i);
+}
+
+void eeprom_update_byte(uint8_t *address, uint8_t value)
+{
+    //same as on hardware, byte is written only if it differs
+    if (eepromMemory[eepromAddress(address)] == value)
+        return;
+
+    hostEEPROMwrites++;
+    hostEEPROMstartWrite();
+    eepromCellWrites[eepromAddress(address)]++;
+    eepromMemory[eepromAddress(address)] = value;
+}
+
+void eeprom_update_word(uint16_t *address, uint16_t value)
+{
+    for (int i=0; i<2; i++)
+        eeprom_update_byte((uint8_t*)address + i, value >> (8*i));
+}
+
+void eeprom_update_dword(uint32_t *address, uint32_t value)
+{
+    for (int i=0; i<4; i++)
+        eeprom_update_byte((uint8_t*)address + i, value >> (8*i));
+}
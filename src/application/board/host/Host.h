@@ -0,0 +1,383 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#pragma once
+
+#include <inttypes.h>
+#include "board/common/DataTypes.h"
+#include "board/common/analog/Variables.h"
+#include "board/common/constants/DigitalIn.h"
+
+///
+/// \brief Host (x86-64) simulation of the board.
+/// Used to run complete firmware deterministically on a PC. Pad and button
+/// readings are fed from input script (or recorded pad trace) instead of ADC
+/// and button matrix, and all outgoing MIDI data is written to standard output.
+/// \defgroup boardHost Host
+/// \ingroup board
+/// @{
+
+///
+/// \brief Simulated time in microseconds spent on single main loop pass.
+/// Can be overriden with ZVUK9_LOOP_US environment variable.
+///
+#define HOST_LOOP_TIME_US_DEFAULT   100
+
+///
+/// \brief Period of main timer ISR in microseconds.
+///
+#define HOST_TIMER_PERIOD_US        1000
+
+///
+/// \brief Duration of single ADC conversion in microseconds.
+/// ADC clock is F_CPU/128 and conversion takes 13 ADC clock cycles.
+///
+#define HOST_ADC_CONVERSION_TIME_US ((13UL*128UL*1000000UL)/F_CPU)
+
+///
+/// \brief Duration of single complete pad scan in microseconds (all coordinates on all pads).
+/// Each coordinate reading is preceded by one discarded conversion. Adaptive scans
+/// (see PAD_SCAN_ADAPTIVE) are shorter.
+///
+#define HOST_ADC_FRAME_TIME_US      (HOST_ADC_CONVERSION_TIME_US*PAD_READINGS*2*NUMBER_OF_PADS)
+
+///
+/// \brief Time in microseconds needed to send single byte over UART (DIN) MIDI.
+/// Start bit, 8 data bits and stop bit on 31250 baud.
+///
+#define HOST_UART_BYTE_TIME_US      320
+
+///
+/// \brief Time in microseconds needed to write single byte to EEPROM.
+///
+#define HOST_EEPROM_WRITE_TIME_US   3300
+
+///
+/// \brief Simulated time in microseconds which passes on each entry to atomic block.
+///
+#define HOST_ATOMIC_TIME_US         1
+
+///
+/// \brief Simulated time in milliseconds after which simulation exits once
+/// input script has been fully processed.
+///
+#define HOST_SCRIPT_TAIL_MS         100
+
+///
+/// \brief Width of single latency histogram bin in microseconds.
+///
+#define HOST_LATENCY_BIN_US         2000
+
+///
+/// \brief Number of latency histogram bins.
+/// Last bin also counts all latencies which don't fit into histogram.
+///
+#define HOST_LATENCY_BINS           32
+
+///
+/// \brief List of outgoing pad events for which latency is measured.
+///
+typedef enum
+{
+    hostLatencyNoteOn,
+    hostLatencyX,
+    hostLatencyY,
+    HOST_LATENCY_EVENTS
+} hostLatencyEvent_t;
+
+///
+/// \brief Raw pad readings which simulated ADC stores into ring buffer on each scan.
+///
+extern padData_t    hostPadData;
+
+///
+/// \brief Raw button matrix state which simulated timer ISR stores into ring buffer.
+///
+extern uint8_t      hostDigitalIn[DIGITAL_IN_ARRAY_SIZE];
+
+///
+/// \brief EEPROM ready ISR, see avr/EEPROM.cpp.
+/// Simulation fires it while EERIE is set, as soon as previous byte has been written.
+///
+extern "C" void EE_READY_vect(void);
+
+///
+/// \brief Marks simulated EEPROM as busy for HOST_EEPROM_WRITE_TIME_US.
+/// Called on each byte written to simulated EEPROM.
+///
+void hostEEPROMstartWrite();
+
+///
+/// \brief Checks whether simulated EEPROM is done writing last byte.
+///
+bool hostEEPROMready();
+
+///
+/// \brief Waits until simulated EEPROM is done writing last byte.
+/// With interrupts enabled, ISRs which are due run meanwhile, so EEPROM ready ISR can
+/// start writing next byte as soon as last one is written, and waiting continues.
+/// With interrupts disabled, simulated time only passes.
+///
+void hostEEPROMwait();
+
+///
+/// \brief Returns current simulated time in microseconds.
+/// Time is counted from first main loop pass (script start).
+///
+uint32_t hostTime_us();
+
+///
+/// \brief Advances simulated time by single main loop pass and applies
+/// input script events which are due. Called from main loop.
+///
+void hostUpdate();
+
+///
+/// \brief Opens input script defined with ZVUK9_SCRIPT environment variable
+/// (or standard input if variable isn't set and pad trace isn't replayed).
+///
+void hostScriptInit();
+
+///
+/// \brief Applies all input script events which are due at current simulated time.
+/// \returns False once script has been fully processed, true otherwise.
+///
+bool hostScriptUpdate();
+
+///
+/// \brief Opens pad trace defined with ZVUK9_TRACE environment variable, if set.
+/// Trace replay starts with first main loop pass. Replay speed can be
+/// multiplied with ZVUK9_TRACE_SPEED environment variable.
+///
+void hostTraceInit();
+
+///
+/// \brief Checks whether pad trace is being replayed.
+/// \returns True if trace is opened and it still has unread frames, false otherwise.
+///
+bool hostTraceActive();
+
+///
+/// \brief Returns trace replay speed factor (ZVUK9_TRACE_SPEED).
+/// Simulated ADC conversions are accelerated by the same factor.
+///
+uint32_t hostTraceSpeed();
+
+///
+/// \brief Reads next pad state from trace.
+/// @param [in,out] frame   Frame in which trace readings are stored.
+/// \returns True if frame has been read, false if trace isn't active.
+///
+bool hostTraceFrame(padData_t &frame);
+
+///
+/// \brief Returns time in microseconds for which single trace frame is applied.
+/// Equals HOST_ADC_FRAME_TIME_US unless trace is replayed at accelerated speed.
+///
+uint32_t hostTraceFramePeriod_us();
+
+///
+/// \brief Registers change of pad readings (trace frame or script event).
+/// Starting points of latency measurements (pad press, X/Y change) are taken from here.
+///
+void hostLatencyFrame(const padData_t &frame);
+
+///
+/// \brief Registers outgoing pad event and measures its latency.
+/// @param [in] pad     Pad which has sent the event.
+/// @param [in] event   Event type (see hostLatencyEvent_t).
+///
+void hostLatencyEvent(uint8_t pad, hostLatencyEvent_t event);
+
+///
+/// \brief Prints per-pad latency histograms to standard error.
+///
+void hostLatencyReport();
+
+///
+/// \brief Queues SysEx message as incoming USB MIDI data.
+/// @param [in] array   Message including start (0xF0) and end (0xF7) bytes.
+/// @param [in] size    Size of message.
+///
+void hostSysExReceive(const uint8_t *array, uint16_t size);
+
+///
+/// \brief Advances simulated encoder quadrature signals by one step.
+/// Called from simulated timer ISR before button matrix is stored.
+///
+void hostEncoderUpdate();
+
+///
+/// \brief Number of bytes read from and written to simulated EEPROM.
+/// Bytes which already hold written value aren't counted as written.
+/// @{
+
+extern uint32_t hostEEPROMreads;
+extern uint32_t hostEEPROMwrites;
+
+/// @}
+
+///
+/// \brief Returns number of writes of single simulated EEPROM byte.
+/// Writes which don't change value aren't counted.
+///
+uint32_t hostEEPROMcellWrites(uint16_t address);
+
+///
+/// \brief Loads EEPROM image defined with ZVUK9_EEPROM environment variable.
+/// If variable isn't set or file doesn't exist, EEPROM starts erased (0xFF).
+///
+void hostEEPROMinit();
+
+///
+/// \brief Writes simulated EEPROM contents back to image file, if defined.
+///
+void hostEEPROMsave();
+
+///
+/// \brief Runs host benchmarks if ZVUK9_BENCH environment variable is set.
+/// ZVUK9_BENCH is either "1" (or "all") for all benchmarks or comma-separated list of
+/// benchmark names (scaler, settle, strike, swipe, program, settings, log, reset, access,
+/// migration, storage). Fixed-point scalers are compared against division based mapping for all
+/// supported input ranges and both paths are timed, pipelined pad readout is
+/// checked against settle model, velocity engines are compared on pad strikes and X/Y
+/// filter is compared against previous X/Y debounce on gestures. Program image is compared against
+/// settings read parameter by parameter, settings written through write cache are checked, log ring
+/// of high-churn settings is checked after simulated restarts, settings are checked after factory
+/// reset, parameters read with address known at compile time are compared against regular reads,
+/// settings are checked after migration from older layout and EEPROM write queue is checked for
+/// read-after-write consistency and write ordering.
+/// Results are printed to standard error, followed by number of failed checks for each benchmark,
+/// and simulation exits with failure status if any check has failed.
+///
+void hostBenchmark();
+
+///
+/// \brief Returns next pseudo-random number used by host benchmarks.
+/// @param [in,out] seed    Seed of sequence, owned by caller.
+/// \returns Pseudo-random number in range 0-65535.
+///
+uint32_t hostRandom(uint32_t &seed);
+
+///
+/// \brief Returns monotonic host time in nanoseconds used to time benchmarked code.
+///
+uint64_t hostTime_ns();
+
+///
+/// \brief Writes all pending settings and waits until EEPROM is idle.
+///
+void hostDrain();
+
+///
+/// \brief Compares pad readings of pipelined readout against readout with discarded
+/// conversions using modelled settling of pad inputs. Called from hostBenchmark.
+/// \returns Number of readings which differ.
+///
+uint32_t hostSettleBenchmark();
+
+///
+/// \brief Compares latency and velocity of slope velocity engine against default engine
+/// on synthetic strikes and on strikes from pad trace (if set), and checks that release
+/// velocity is graded by lift-off speed with all velocity curves. Called from hostBenchmark.
+/// \returns Number of strikes on which slope engine hasn't sent note or has sent it later,
+/// plus number of failed release velocity checks.
+///
+uint32_t hostStrikeBenchmark();
+
+///
+/// \brief Compares number of CC messages and lag of X/Y filter against previous X/Y
+/// debounce on synthetic gestures and on gestures from pad trace (if set).
+/// Called from hostBenchmark.
+/// \returns Number of gestures after which filtered value hasn't settled on finger position,
+/// plus number of synthetic gesture types on which filter sends more CC messages than debounce.
+///
+uint32_t hostSwipeBenchmark();
+
+///
+/// \brief Compares program images against settings read parameter by parameter and
+/// reports cost of program load with both methods, then checks program cache on random
+/// program changes. Called from hostBenchmark.
+/// \returns Number of settings which differ.
+///
+uint32_t hostProgramBenchmark();
+
+///
+/// \brief Compares settings written through write cache against expected values and
+/// reports number of EEPROM writes done while settings are being changed and later on.
+/// Main loop is expected not to wait for memory when cache is drained on program change.
+/// Called from hostBenchmark.
+/// \returns Number of settings which differ, plus one if drain blocks main loop.
+///
+uint32_t hostSettingsBenchmark();
+
+///
+/// \brief Checks that high-churn settings stored in log ring are restored after simulated
+/// restarts, including restarts after interrupted slot write, and reports EEPROM wear
+/// caused by program and scale changes. Called from hostBenchmark.
+/// \returns Number of settings which differ.
+///
+uint32_t hostLogBenchmark();
+
+///
+/// \brief Checks that all settings hold default values after full and partial factory reset,
+/// and after simulated restart, and reports duration of factory reset along with number of
+/// EEPROM bytes written. Called from hostBenchmark.
+/// \returns Number of settings which differ.
+///
+uint32_t hostResetBenchmark();
+
+///
+/// \brief Compares parameters read with address known at compile time against parameters
+/// read with address resolved by DBMS and reports cost of both reads. Called from hostBenchmark.
+/// \returns Number of parameters which differ.
+///
+uint32_t hostAccessBenchmark();
+
+///
+/// \brief Checks that settings written with older layout keep their values once memory is
+/// migrated to current layout, including migration interrupted by simulated power losses,
+/// and reports time for which startup is blocked along with number of EEPROM bytes written
+/// on startup and from main loop.
+/// Called from hostBenchmark.
+/// \returns Number of settings which differ.
+///
+uint32_t hostMigrationBenchmark();
+
+///
+/// \brief Checks that EEPROM write queue returns last written values on reads and
+/// writes bytes to EEPROM in order in which they've been written. Called from hostBenchmark.
+/// \returns Number of failed checks.
+///
+uint32_t hostStorageBenchmark();
+
+///
+/// \brief Stops simulation.
+/// EEPROM image is saved, captured MIDI output flushed and latency report
+/// printed before exiting.
+///
+void hostExit();
+
+/// @}
@@ -0,0 +1,358 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <avr/interrupt.h>
+#include <util/delay.h>
+#include <util/atomic.h>
+#include "Host.h"
+#include "board/Board.h"
+#include "board/common/analog/Variables.h"
+#include "board/common/analog/Scan.h"
+#include "board/common/digital/input/Variables.h"
+#include "board/common/uart/Queue.h"
+#include "database/WriteCache.h"
+
+///
+/// \ingroup boardHost
+/// @{
+
+///
+/// \brief Implementation of core variable used to keep track of run time in milliseconds.
+///
+volatile uint32_t   rTime_ms;
+
+///
+/// \brief Current simulated time in microseconds.
+///
+static uint32_t     simTime_us;
+
+///
+/// \brief Simulated time at which main loop has been entered.
+/// Script and output timestamps are relative to this point.
+///
+static uint32_t     loopStart_us;
+
+///
+/// \brief Simulated time at which next timer ISR is due.
+///
+static uint32_t     nextTimerTick_us = HOST_TIMER_PERIOD_US;
+
+///
+/// \brief Simulated time at which ADC ISR completes next pad scan.
+///
+static uint32_t     nextADCframe_us = HOST_ADC_FRAME_TIME_US;
+
+///
+/// \brief Simulated time at which next trace frame is applied to pad readings.
+///
+static uint32_t     nextTraceFrame_us = UINT32_MAX;
+
+///
+/// \brief Simulated time at which UART is able to accept next byte.
+///
+static uint32_t     nextUARTbyte_us;
+
+///
+/// \brief Simulated time at which EEPROM is ready for next write.
+///
+static uint32_t     nextEEPROMwrite_us;
+
+///
+/// \brief Simulated time spent on single main loop pass.
+///
+static uint32_t     loopTime_us;
+
+///
+/// \brief Set while simulated ISRs are running.
+/// Used to avoid advancing time from code called by ISRs.
+///
+static bool         isrActive;
+
+///
+/// \brief Simulated time at which simulation ends after script and trace have been processed.
+/// Set to 0 while script is still active.
+///
+static uint32_t     exitTime_us;
+
+
+///
+/// \brief Stand-in for main timer ISR.
+/// Updates run time and stores button matrix state.
+/// LED matrix isn't simulated.
+///
+ISR(TIMER3_COMPA_vect)
+{
+    //update run time
+    rTime_ms++;
+
+    hostEncoderUpdate();
+
+    //read input matrix
+    if (dIn_count < DIGITAL_IN_BUFFER_SIZE)
+    {
+        if (++dIn_head == DIGITAL_IN_BUFFER_SIZE)
+            dIn_head = 0;
+
+        for (int i=0; i<DIGITAL_IN_ARRAY_SIZE; i++)
+            digitalInBuffer[dIn_head][i] = hostDigitalIn[i];
+
+        dIn_count++;
+    }
+}
+
+///
+/// \brief Stand-in for ADC ISR.
+/// Called once complete pad scan would be finished. Stores current pad readings
+/// for pads and coordinates selected for the scan and selects pads for next scan.
+///
+ISR(ADC_vect)
+{
+    if (aIn_count < ANALOG_IN_BUFFER_SIZE)
+    {
+        uint8_t previousHead = aIn_head;
+
+        if (++aIn_head == ANALOG_IN_BUFFER_SIZE)
+            aIn_head = 0;
+
+        padScanCopy(analogInBuffer[aIn_head], analogInBuffer[previousHead]);
+
+        for (int i=0; i<NUMBER_OF_PADS; i++)
+        {
+            if (BIT_READ(padScanPressure, i))
+            {
+                analogInBuffer[aIn_head].zReading[i] = hostPadData.zReading[i];
+                padScanStorePressure(i, hostPadData.zReading[i]);
+            }
+
+            if (BIT_READ(padScanXY, i))
+            {
+                analogInBuffer[aIn_head].xReading[i] = hostPadData.xReading[i];
+                analogInBuffer[aIn_head].yReading[i] = hostPadData.yReading[i];
+            }
+        }
+
+        analogInBuffer[aIn_head].ticks = Board::getProfilerTicks();
+        aIn_count++;
+        padScanPlan();
+    }
+}
+
+///
+/// \brief Stand-in for UART data register empty ISR.
+/// Writes next queued DIN MIDI byte to standard output together with simulated
+/// time in microseconds at which it has been handed over to UART.
+///
+ISR(USART1_UDRE_vect)
+{
+    int16_t data = uartQueueRead();
+
+    if (data < 0)
+    {
+        //queue is empty, disable transmit interrupt
+        UCSR1B &= ~(1<<UDRIE1);
+        return;
+    }
+
+    printf("%u din %02X\n", hostTime_us(), data);
+}
+
+///
+/// \brief Returns duration of current pad scan in microseconds.
+///
+static uint32_t scanTime_us()
+{
+    uint32_t time_us = (padScanConversions() * HOST_ADC_CONVERSION_TIME_US) / hostTraceSpeed();
+    return time_us ? time_us : 1;
+}
+
+/// @}
+
+uint32_t hostTime_us()
+{
+    return simTime_us - loopStart_us;
+}
+
+void hostDelay_us(uint32_t us)
+{
+    if (isrActive)
+        return;
+
+    isrActive = true;
+
+    uint32_t target_us = simTime_us + us;
+
+    //run all interrupts which are due in order
+    while (true)
+    {
+        uint32_t next_us = (nextTimerTick_us < nextADCframe_us) ? nextTimerTick_us : nextADCframe_us;
+
+        if (nextTraceFrame_us < next_us)
+            next_us = nextTraceFrame_us;
+
+        //idle UART accepts byte as soon as transmit interrupt is enabled
+        uint32_t uart_us = UINT32_MAX;
+
+        if (UCSR1B & (1<<UDRIE1))
+            uart_us = (nextUARTbyte_us > simTime_us) ? nextUARTbyte_us : simTime_us;
+
+        if (uart_us < next_us)
+            next_us = uart_us;
+
+        //eeprom ready interrupt fires while eeprom isn't being written to
+        uint32_t eeprom_us = UINT32_MAX;
+
+        if (EECR & (1<<EERIE))
+            eeprom_us = (nextEEPROMwrite_us > simTime_us) ? nextEEPROMwrite_us : simTime_us;
+
+        if (eeprom_us < next_us)
+            next_us = eeprom_us;
+
+        if (next_us > target_us)
+            break;
+
+        //interrupts which became due while interrupts were disabled run late
+        if (next_us > simTime_us)
+            simTime_us = next_us;
+
+        if (next_us == nextTimerTick_us)
+        {
+            TIMER3_COMPA_vect();
+            nextTimerTick_us += HOST_TIMER_PERIOD_US;
+        }
+
+        if (next_us == nextTraceFrame_us)
+        {
+            //trace frame represents pad state, scans sample it at their own pace
+            if (hostTraceFrame(hostPadData))
+            {
+                hostLatencyFrame(hostPadData);
+                nextTraceFrame_us += hostTraceFramePeriod_us();
+            }
+            else
+            {
+                nextTraceFrame_us = UINT32_MAX;
+            }
+        }
+
+        if (next_us == nextADCframe_us)
+        {
+            ADC_vect();
+            nextADCframe_us += scanTime_us();
+        }
+
+        if (next_us == uart_us)
+        {
+            USART1_UDRE_vect();
+
+            //interrupt remains enabled only if byte has been sent
+            if (UCSR1B & (1<<UDRIE1))
+                nextUARTbyte_us = simTime_us + HOST_UART_BYTE_TIME_US;
+        }
+
+        //bytes which already hold queued value aren't written and don't make eeprom busy
+        if (next_us == eeprom_us)
+            EE_READY_vect();
+    }
+
+    simTime_us = target_us;
+    isrActive = false;
+}
+
+void hostEEPROMstartWrite()
+{
+    nextEEPROMwrite_us = simTime_us + HOST_EEPROM_WRITE_TIME_US;
+}
+
+bool hostEEPROMready()
+{
+    return simTime_us >= nextEEPROMwrite_us;
+}
+
+void hostEEPROMwait()
+{
+    while (!hostEEPROMready())
+    {
+        if ((SREG & (1<<SREG_I)) && !isrActive)
+            hostDelay_us(nextEEPROMwrite_us - simTime_us);
+        else
+            simTime_us = nextEEPROMwrite_us;
+    }
+}
+
+void hostAtomicEnter()
+{
+    hostDelay_us(HOST_ATOMIC_TIME_US);
+}
+
+void hostUpdate()
+{
+    if (!loopTime_us)
+    {
+        const char *loopTime = getenv("ZVUK9_LOOP_US");
+        loopTime_us = (loopTime != NULL) ? strtoul(loopTime, NULL, 10) : 0;
+
+        if (!loopTime_us)
+            loopTime_us = HOST_LOOP_TIME_US_DEFAULT;
+
+        //firmware is initialized, start script and trace replay
+        loopStart_us = simTime_us;
+        hostTraceInit();
+        nextADCframe_us = simTime_us + scanTime_us();
+
+        if (hostTraceActive())
+            nextTraceFrame_us = simTime_us;
+    }
+
+    if (!hostScriptUpdate() && !hostTraceActive() && !exitTime_us)
+        exitTime_us = simTime_us + HOST_SCRIPT_TAIL_MS*1000UL;
+
+    if (exitTime_us && (simTime_us >= exitTime_us))
+        hostExit();
+
+    hostDelay_us(loopTime_us);
+}
+
+void hostExit()
+{
+    //keep settings which haven't been written yet in image as well
+    writeCache.flush();
+
+    while (EECR & (1<<EERIE))
+        EE_READY_vect();
+    hostEEPROMsave();
+    Board::flushUSBMIDI();
+    fflush(stdout);
+    hostLatencyReport();
+
+    if (uartQueueOverflow[uartLaneNotes] || uartQueueOverflow[uartLanePitchBend] || uartQueueOverflow[uartLaneControl])
+    {
+        fprintf(stderr, "DIN MIDI messages dropped: notes %u, pitch bend %u, control %u\n",
+            uartQueueOverflow[uartLaneNotes], uartQueueOverflow[uartLanePitchBend], uartQueueOverflow[uartLaneControl]);
+    }
+
+    exit(0);
+}
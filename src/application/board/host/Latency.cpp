@@ -0,0 +1,193 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#include <stdio.h>
+#include "Host.h"
+#include "constants/Pads.h"
+
+///
+/// \ingroup boardHost
+/// @{
+
+//latency is measured from the moment change appears on pad (trace frame or script event)
+//to the moment firmware sends MIDI message caused by that change, so time needed for
+//scan to pick the change up is included:
+//     note on:    first pad state with pressure above PAD_PRESS_PRESSURE -> note on leaving Pads::sendNotes
+//     X/Y:        first pad state with changed X/Y reading since last sent value -> CC/PB leaving Pads::sendX/sendY
+//measurements are reset once pad is released in trace.
+
+///
+/// \brief Holds latency histogram for single pad and event type.
+///
+typedef struct
+{
+    uint32_t bin[HOST_LATENCY_BINS];
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t sum_us;
+} latencyHistogram_t;
+
+static latencyHistogram_t   histogram[NUMBER_OF_PADS][HOST_LATENCY_EVENTS];
+
+///
+/// \brief Time of scan from which latency of next event is measured, per pad and event type.
+///
+static uint32_t             eventStart_us[NUMBER_OF_PADS][HOST_LATENCY_EVENTS];
+
+///
+/// \brief Set while latency measurement is pending, per pad and event type.
+///
+static bool                 eventPending[NUMBER_OF_PADS][HOST_LATENCY_EVENTS];
+
+///
+/// \brief Set while pad is pressed in scanned data.
+///
+static bool                 tracePadPressed[NUMBER_OF_PADS];
+
+///
+/// \brief Last scanned X and Y readings for each pad.
+/// @{
+
+static int16_t              lastX[NUMBER_OF_PADS];
+static int16_t              lastY[NUMBER_OF_PADS];
+
+/// @}
+
+static const char * const   eventName[HOST_LATENCY_EVENTS] =
+{
+    "note on",
+    "x",
+    "y"
+};
+
+///
+/// \brief Starts latency measurement unless one is already pending.
+///
+static void startMeasurement(uint8_t pad, hostLatencyEvent_t event)
+{
+    if (eventPending[pad][event])
+        return;
+
+    eventStart_us[pad][event] = hostTime_us();
+    eventPending[pad][event] = true;
+}
+
+/// @}
+
+void hostLatencyFrame(const padData_t &frame)
+{
+    for (int i=0; i<NUMBER_OF_PADS; i++)
+    {
+        if (frame.zReading[i] > PAD_PRESS_PRESSURE)
+        {
+            if (!tracePadPressed[i])
+            {
+                tracePadPressed[i] = true;
+                startMeasurement(i, hostLatencyNoteOn);
+            }
+        }
+        else if (frame.zReading[i] < PAD_RELEASE_PRESSURE)
+        {
+            tracePadPressed[i] = false;
+
+            for (int j=0; j<HOST_LATENCY_EVENTS; j++)
+                eventPending[i][j] = false;
+        }
+
+        if (tracePadPressed[i])
+        {
+            if (frame.xReading[i] != lastX[i])
+                startMeasurement(i, hostLatencyX);
+
+            if (frame.yReading[i] != lastY[i])
+                startMeasurement(i, hostLatencyY);
+        }
+
+        lastX[i] = frame.xReading[i];
+        lastY[i] = frame.yReading[i];
+    }
+}
+
+void hostLatencyEvent(uint8_t pad, hostLatencyEvent_t event)
+{
+    if ((pad >= NUMBER_OF_PADS) || !eventPending[pad][event])
+        return;
+
+    eventPending[pad][event] = false;
+
+    uint32_t latency_us = hostTime_us() - eventStart_us[pad][event];
+    uint32_t bin = latency_us / HOST_LATENCY_BIN_US;
+
+    if (bin >= HOST_LATENCY_BINS)
+        bin = HOST_LATENCY_BINS-1;
+
+    latencyHistogram_t &hist = histogram[pad][event];
+
+    if (!hist.count || (latency_us < hist.min_us))
+        hist.min_us = latency_us;
+
+    if (latency_us > hist.max_us)
+        hist.max_us = latency_us;
+
+    hist.bin[bin]++;
+    hist.count++;
+    hist.sum_us += latency_us;
+}
+
+void hostLatencyReport()
+{
+    bool header = false;
+
+    for (int i=0; i<NUMBER_OF_PADS; i++)
+    {
+        for (int j=0; j<HOST_LATENCY_EVENTS; j++)
+        {
+            latencyHistogram_t &hist = histogram[i][j];
+
+            if (!hist.count)
+                continue;
+
+            if (!header)
+            {
+                fprintf(stderr, "Latency report (%u us bins)\n", HOST_LATENCY_BIN_US);
+                header = true;
+            }
+
+            fprintf(stderr, "pad %d %s: count %u, min %u us, avg %u us, max %u us\n", i, eventName[j], hist.count, hist.min_us, (uint32_t)(hist.sum_us / hist.count), hist.max_us);
+
+            for (int k=0; k<HOST_LATENCY_BINS; k++)
+            {
+                if (!hist.bin[k])
+                    continue;
+
+                if (k == HOST_LATENCY_BINS-1)
+                    fprintf(stderr, "    >=%5u us: %u\n", k*HOST_LATENCY_BIN_US, hist.bin[k]);
+                else
+                    fprintf(stderr, "    %7u us: %u\n", k*HOST_LATENCY_BIN_US, hist.bin[k]);
+            }
+        }
+    }
+}
@@ -0,0 +1,222 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#include <stdio.h>
+#include <avr/eeprom.h>
+#include "Host.h"
+#include "board/Board.h"
+#include "database/Database.h"
+#include "util/delay.h"
+
+///
+/// \ingroup boardHost
+/// @{
+
+//log ring of high-churn settings. Random program and scale changes are made with time passing
+//in between, the same way firmware makes them. Database is periodically restarted once all
+//writes are done and restored values are compared against expected ones. Before every second
+//restart, check byte of slot written last is corrupted, same as if power has been lost while
+//slot was written, in which case value from previous write is expected. Number of writes of
+//most written EEPROM byte in log ring and in rest of database is reported. Database needs to
+//be initialized already (see hostProgramBenchmark).
+
+///
+/// \brief Number of random program and scale changes.
+///
+#define LOG_CHANGES             6000
+
+///
+/// \brief Number of changes between two simulated restarts.
+///
+#define LOG_RESTART_INTERVAL    100
+
+///
+/// \brief Time in milliseconds between two changes.
+///
+#define LOG_CHANGE_TIME         20
+
+///
+/// \brief Size of single log slot in bytes.
+///
+#define LOG_SLOT_SIZE           4
+
+///
+/// \brief Expected values of high-churn settings.
+/// @{
+
+static uint8_t expectedProgram;
+static uint8_t expectedScale[NUMBER_OF_PROGRAMS];
+
+/// @}
+
+///
+/// \brief Seed of pseudo-random numbers (see hostRandom).
+///
+static uint32_t logSeed = 5;
+
+///
+/// \brief Restarts database and compares restored values against expected ones.
+/// \returns Number of values which differ.
+///
+static uint32_t logRestart()
+{
+    uint32_t mismatches = 0;
+
+    database.init();
+
+    if (database.read(DB_BLOCK_PROGRAM, programLastActiveProgramSection, 0) != expectedProgram)
+        mismatches++;
+
+    for (int i=0; i<NUMBER_OF_PROGRAMS; i++)
+    {
+        if (database.read(DB_BLOCK_PROGRAM, programLastActiveScaleSection, i) != expectedScale[i])
+            mismatches++;
+    }
+
+    return mismatches;
+}
+
+/// @}
+
+uint32_t hostLogBenchmark()
+{
+    static uint32_t cellWrites[EEPROM_SIZE];
+    uint8_t ring[DB_LOG_SLOTS*LOG_SLOT_SIZE];
+    uint16_t ringAddress = database.getDBsize() - sizeof(ring);
+    uint32_t mismatches = 0;
+    uint32_t restarts = 0;
+    uint32_t interrupted = 0;
+    uint32_t programChanges = 0;
+    uint32_t scaleChanges = 0;
+    uint32_t slotWrites, movedWrites;
+
+    hostDrain();
+
+    for (int i=0; i<EEPROM_SIZE; i++)
+        cellWrites[i] = hostEEPROMcellWrites(i);
+
+    expectedProgram = database.read(DB_BLOCK_PROGRAM, programLastActiveProgramSection, 0);
+
+    for (int i=0; i<NUMBER_OF_PROGRAMS; i++)
+        expectedScale[i] = database.read(DB_BLOCK_PROGRAM, programLastActiveScaleSection, i);
+
+    for (int i=1; i<=LOG_CHANGES; i++)
+    {
+        bool interrupt = !(i % (LOG_RESTART_INTERVAL*2));
+        uint8_t *expected;
+        uint8_t previous;
+
+        if (interrupt)
+        {
+            hostDrain();
+
+            for (uint16_t j=0; j<sizeof(ring); j++)
+                ring[j] = eeprom_read_byte((const uint8_t*)(uintptr_t)(ringAddress+j));
+        }
+
+        if (hostRandom(logSeed) % 4)
+        {
+            //program change, all pending settings are written (see Pads::setProgram)
+            uint8_t program = (expectedProgram + 1 + hostRandom(logSeed) % (NUMBER_OF_PROGRAMS-1)) % NUMBER_OF_PROGRAMS;
+
+            expected = &expectedProgram;
+            previous = expectedProgram;
+            expectedProgram = program;
+            database.update(DB_BLOCK_PROGRAM, programLastActiveProgramSection, 0, program);
+            writeCache.flush();
+            programChanges++;
+        }
+        else
+        {
+            uint8_t scale = hostRandom(logSeed) % (PREDEFINED_SCALES+NUMBER_OF_USER_SCALES);
+
+            expected = &expectedScale[expectedProgram];
+            previous = *expected;
+            *expected = scale;
+            database.update(DB_BLOCK_PROGRAM, programLastActiveScaleSection, expectedProgram, scale);
+            scaleChanges++;
+        }
+
+        for (int j=0; j<LOG_CHANGE_TIME; j++)
+        {
+            hostDelay_us(1000);
+            writeCache.update(true);
+        }
+
+        if (interrupt)
+        {
+            hostDrain();
+
+            //corrupt check byte (written last) of slot which has just been written
+            for (uint16_t j=0; j<sizeof(ring); j++)
+            {
+                if (eeprom_read_byte((const uint8_t*)(uintptr_t)(ringAddress+j)) != ring[j])
+                {
+                    uint16_t check = ringAddress + (j/LOG_SLOT_SIZE)*LOG_SLOT_SIZE + (LOG_SLOT_SIZE-1);
+
+                    eeprom_update_byte((uint8_t*)(uintptr_t)check, ~eeprom_read_byte((const uint8_t*)(uintptr_t)check));
+                    *expected = previous;
+                    interrupted++;
+                    break;
+                }
+            }
+        }
+
+        if (!(i % LOG_RESTART_INTERVAL))
+        {
+            hostDrain();
+            mismatches += logRestart();
+            restarts++;
+        }
+    }
+
+    hostDrain();
+    database.getLogStats(slotWrites, movedWrites);
+
+    uint32_t maxRing = 0;
+    uint32_t maxOther = 0;
+
+    for (int i=0; i<EEPROM_SIZE; i++)
+    {
+        uint32_t writes = hostEEPROMcellWrites(i) - cellWrites[i];
+
+        if ((i >= ringAddress) && (i < (ringAddress+(int)sizeof(ring))))
+        {
+            if (writes > maxRing)
+                maxRing = writes;
+        }
+        else if (writes > maxOther)
+        {
+            maxOther = writes;
+        }
+    }
+
+    fprintf(stderr, "log ring: %u program and %u scale changes, %u restarts (%u after interrupted write), %u mismatches\n",
+        programChanges, scaleChanges, restarts, interrupted, mismatches);
+    fprintf(stderr, "log ring: %u slot writes, %u values moved, most written byte: %u writes in ring, %u writes elsewhere\n",
+        slotWrites, movedWrites, maxRing, maxOther);
+
+    return mismatches;
+}
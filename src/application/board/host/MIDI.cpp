@@ -0,0 +1,180 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#include <stdio.h>
+#include <avr/io.h>
+#include "Host.h"
+#include "board/Board.h"
+#include "board/common/constants/USB.h"
+#include "board/common/uart/Queue.h"
+#include "core/src/general/Timing.h"
+
+///
+/// \ingroup boardHost
+/// @{
+
+///
+/// \brief Simulated MIDI IN endpoint.
+/// @{
+
+static USBMIDIpacket_t  usbTxBatch[USB_MIDI_BATCH_SIZE];
+static uint8_t          usbTxCount;
+static uint32_t         usbTxPendingTime;
+
+/// @}
+
+///
+/// \brief Captures outgoing USB MIDI packet.
+/// Packets are batched in the same way as on board and written to standard
+/// output once batch is sent, together with simulated time in microseconds
+/// at which transfer has occured.
+/// @param [in] USBMIDIpacket       Structure holding USB MIDI data.
+/// \returns                        Always true.
+///
+static bool usbWrite(USBMIDIpacket_t& USBMIDIpacket)
+{
+    if (!usbTxCount)
+        usbTxPendingTime = rTimeMs();
+
+    usbTxBatch[usbTxCount++] = USBMIDIpacket;
+
+    if (usbTxCount == USB_MIDI_BATCH_SIZE)
+        Board::flushUSBMIDI();
+
+    return true;
+}
+
+///
+/// \brief Size of incoming USB MIDI packet queue.
+///
+#define USB_RX_QUEUE_SIZE   64
+
+static USBMIDIpacket_t  usbRxQueue[USB_RX_QUEUE_SIZE];
+static uint8_t          usbRxHead;
+static uint8_t          usbRxCount;
+
+///
+/// \brief Returns incoming USB MIDI packet queued from input script.
+/// @param [in,out] USBMIDIpacket   Structure in which packet is stored.
+/// \returns                        True if packet has been read, false if queue is empty.
+///
+static bool usbRead(USBMIDIpacket_t& USBMIDIpacket)
+{
+    if (!usbRxCount)
+        return false;
+
+    USBMIDIpacket = usbRxQueue[usbRxHead];
+
+    if (++usbRxHead == USB_RX_QUEUE_SIZE)
+        usbRxHead = 0;
+
+    usbRxCount--;
+    return true;
+}
+
+///
+/// \brief Stores single incoming USB MIDI packet into queue.
+///
+static void usbQueue(uint8_t event, uint8_t data1, uint8_t data2, uint8_t data3)
+{
+    if (usbRxCount == USB_RX_QUEUE_SIZE)
+    {
+        fprintf(stderr, "Incoming USB MIDI queue full\n");
+        return;
+    }
+
+    USBMIDIpacket_t &packet = usbRxQueue[(usbRxHead + usbRxCount) % USB_RX_QUEUE_SIZE];
+
+    packet.Event = event;
+    packet.Data1 = data1;
+    packet.Data2 = data2;
+    packet.Data3 = data3;
+
+    usbRxCount++;
+}
+
+///
+/// \brief Queues outgoing UART (DIN) MIDI byte.
+/// Bytes are written to standard output from simulated UDRE ISR at UART rate.
+/// @param [in] data    Byte being sent.
+/// \returns            False if message to which byte belongs has been dropped, true otherwise.
+///
+static bool UARTwrite(uint8_t data)
+{
+    bool result = uartQueueWrite(data);
+
+    UCSR1B |= (1<<UDRIE1);
+    return result;
+}
+
+/// @}
+
+void hostSysExReceive(const uint8_t *array, uint16_t size)
+{
+    //split message into USB MIDI packets, cable 0
+    //code index 0x04 continues message, 0x05-0x07 end it with 1-3 bytes
+    while (size > 3)
+    {
+        usbQueue(0x04, array[0], array[1], array[2]);
+        array += 3;
+        size -= 3;
+    }
+
+    usbQueue(0x04+size, array[0], (size > 1) ? array[1] : 0, (size > 2) ? array[2] : 0);
+}
+
+void Board::initUSB_MIDI()
+{
+    midi.handleUSBread(usbRead);
+    midi.handleUSBwrite(usbWrite);
+}
+
+void Board::initUART_MIDI()
+{
+    uartQueueInit();
+    midi.handleUARTwrite(UARTwrite);
+}
+
+void Board::flushUSBMIDI()
+{
+    for (int i=0; i<usbTxCount; i++)
+        printf("%u usb %02X %02X %02X %02X\n", hostTime_us(), usbTxBatch[i].Event, usbTxBatch[i].Data1, usbTxBatch[i].Data2, usbTxBatch[i].Data3);
+
+    usbTxCount = 0;
+}
+
+uint8_t Board::getUSBMIDIcapacity()
+{
+    return USB_MIDI_BATCH_SIZE - usbTxCount;
+}
+
+void Board::updateUSBMIDI()
+{
+    if (!usbTxCount)
+        return;
+
+    if ((rTimeMs() - usbTxPendingTime) >= USB_MIDI_FLUSH_TIMEOUT)
+        flushUSBMIDI();
+}
@@ -0,0 +1,455 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <avr/eeprom.h>
+#include <avr/interrupt.h>
+#include "Host.h"
+#include "board/Board.h"
+#include "board/common/eeprom/Queue.h"
+#include "database/Database.h"
+#include "util/delay.h"
+
+///
+/// \ingroup boardHost
+/// @{
+
+//migration of memory written with older layout (see Schema.h). Memory is first filled with
+//random settings in older layout. Memory is migrated step by step while power is randomly
+//lost: bytes which are still queued are discarded and database is started again. Steps
+//which block startup are done first, after which parameters which exist in both layouts
+//need to keep their values and all other parameters need to hold default values, both
+//while rest of migration is done and after it, as well as after simulated restart.
+//Migration of current layout to itself is checked the same way on memory with default
+//chunks and log ring in use, which needs to keep all values. Database needs to be
+//initialized already (see hostProgramBenchmark).
+
+///
+/// \brief Number of random settings changes before migration of current layout.
+///
+#define MIGRATION_RANDOM_WRITES         1000
+
+///
+/// \brief Probability of power loss after migration step, as 1/MIGRATION_POWER_LOSS.
+///
+#define MIGRATION_POWER_LOSS            8
+
+///
+/// \brief Largest number of EEPROM bytes written and time in microseconds for which migration
+/// can block startup. Time is checked only if power isn't lost, since every power loss
+/// repeats part of migration.
+/// @{
+
+#define MIGRATION_STARTUP_WRITES        128
+#define MIGRATION_STARTUP_US            500000
+
+/// @}
+
+///
+/// \brief Single checked section.
+///
+typedef struct
+{
+    uint8_t block;
+    uint8_t section;
+} migrationSection_t;
+
+///
+/// \brief Checked sections. ID, log ring and default map aren't accessed directly.
+///
+static constexpr migrationSection_t migrationSections[] =
+{
+    { DB_BLOCK_PROGRAM, programLastActiveProgramSection },
+    { DB_BLOCK_PROGRAM, programLastActiveScaleSection },
+    { DB_BLOCK_PROGRAM, programGlobalSettingsSection },
+    { DB_BLOCK_PROGRAM, programLocalSettingsSection },
+    { DB_BLOCK_SCALE, scalePredefinedSection },
+    { DB_BLOCK_SCALE, scaleUserSection },
+    { DB_BLOCK_PAD_CALIBRATION, padCalibrationPressureUpperSection },
+    { DB_BLOCK_PAD_CALIBRATION, padCalibrationXlowerSection },
+    { DB_BLOCK_PAD_CALIBRATION, padCalibrationXupperSection },
+    { DB_BLOCK_PAD_CALIBRATION, padCalibrationYlowerSection },
+    { DB_BLOCK_PAD_CALIBRATION, padCalibrationYupperSection },
+    { DB_BLOCK_GLOBAL_SETTINGS, globalSettingsMIDI },
+    { DB_BLOCK_GLOBAL_SETTINGS, globalSettingsVelocitySensitivity },
+    { DB_BLOCK_PROGRAM_EXTENDED, programExtendedSettingsSection },
+};
+
+#define MIGRATION_SECTIONS  (sizeof(migrationSections)/sizeof(migrationSection_t))
+
+///
+/// \brief Returns number of parameters in checked section.
+///
+static constexpr uint16_t migrationParameters(uint8_t section)
+{
+    return dbFormat(migrationSections[section].block, migrationSections[section].section).numberOfParameters;
+}
+
+///
+/// \brief Returns position of first expected value of checked section (see migrationExpected).
+///
+static constexpr uint16_t migrationStart(uint8_t section)
+{
+    return section ? (migrationStart(section-1) + migrationParameters(section-1)) : 0;
+}
+
+///
+/// \brief Expected value of each parameter of all checked sections, one section after another.
+///
+static int32_t migrationExpected[migrationStart(MIGRATION_SECTIONS)];
+
+///
+/// \brief Seed of pseudo-random numbers (see hostRandom).
+///
+static uint32_t migrationSeed = 13;
+
+///
+/// \brief Simulates power loss: bytes which haven't been written to EEPROM yet are lost.
+///
+static void migrationPowerLoss()
+{
+    uint16_t address;
+    uint8_t value;
+
+    cli();
+
+    while (eepromQueueNext(address, value));
+
+    sei();
+}
+
+///
+/// \brief Writes memory with random settings in older layout and sets expected values
+/// of all sections once memory is migrated.
+/// @param [in] version     Schema version of older layout (see dbSchemaHistory).
+///
+static void migrationWriteSchema(uint8_t version)
+{
+    static uint8_t image[EEPROM_SIZE];
+    dbSchema_t schema = {};
+    dbSectionFormat_t format[DB_SECTIONS];
+    uint8_t target[DB_SECTIONS];
+    uint16_t start[DB_SECTIONS];
+    uint16_t address = 0;
+
+    for (int i=0; i<DB_SCHEMA_HISTORY; i++)
+    {
+        if (pgm_read_byte(&dbSchemaHistory[i].version) == version)
+            memcpy_P(&schema, &dbSchemaHistory[i], sizeof(dbSchema_t));
+    }
+
+    hostDrain();
+
+    //schema records are erased as well
+    for (uint16_t i=0; i<(DB_SCHEMA_ADDRESS+DB_SCHEMA_RECORDS*DB_SCHEMA_RECORD_SIZE); i++)
+        eeprom_update_byte((uint8_t*)(uintptr_t)i, 0xFF);
+
+    for (uint8_t i=0; i<schema.numberOfSections; i++)
+    {
+        memcpy_P(&format[i], &schema.format[i], sizeof(dbSectionFormat_t));
+        target[i] = pgm_read_byte(&schema.target[i]);
+        start[i] = address;
+
+        for (uint16_t j=0; j<dbFormatSize(format[i]); j++)
+        {
+            //log ring and default map are empty
+            if (target[i] == dbSectionIndex(DB_BLOCK_ID, 0))
+                image[address] = UNIQUE_ID;
+            else if ((target[i] == dbSectionIndex(DB_BLOCK_LOG, logSlotSection)) || (target[i] == dbSectionIndex(DB_BLOCK_DEFAULT_MAP, defaultMapSection)))
+                image[address] = 0;
+            else
+                image[address] = hostRandom(migrationSeed) & 0x7F;
+
+            eeprom_update_byte((uint8_t*)(uintptr_t)address, image[address]);
+            address++;
+        }
+    }
+
+    for (uint8_t i=0; i<MIGRATION_SECTIONS; i++)
+    {
+        uint8_t index = dbSectionIndex(migrationSections[i].block, migrationSections[i].section);
+        uint16_t recordSize = dbSectionFormat[index].numberOfParameters / dbSectionFormat[index].records;
+        uint8_t size = dbParameterSize(dbSectionFormat[index].parameterType);
+        int8_t source = -1;
+
+        for (uint8_t j=0; j<schema.numberOfSections; j++)
+        {
+            if (target[j] == index)
+                source = j;
+        }
+
+        for (uint16_t j=0; j<migrationParameters(i); j++)
+        {
+            int32_t &expected = migrationExpected[migrationStart(i)+j];
+            //parameter keeps its record and its place in record
+            uint16_t record = j / recordSize;
+            uint16_t place = j % recordSize;
+
+            if ((source == -1) || (record >= format[source].records) || (place >= (format[source].numberOfParameters / format[source].records)))
+            {
+                expected = database.getDefaultValue(migrationSections[i].block, migrationSections[i].section, j);
+                continue;
+            }
+
+            uint16_t parameter = record*(format[source].numberOfParameters / format[source].records) + place;
+
+            expected = 0;
+
+            for (int k=size-1; k>=0; k--)
+                expected = (expected << 8) | image[start[source]+parameter*size+k];
+        }
+    }
+}
+
+///
+/// \brief Sets expected values of all sections to current values.
+///
+static void migrationExpectCurrent()
+{
+    for (uint8_t i=0; i<MIGRATION_SECTIONS; i++)
+    {
+        for (uint16_t j=0; j<migrationParameters(i); j++)
+            migrationExpected[migrationStart(i)+j] = database.read(migrationSections[i].block, migrationSections[i].section, j);
+    }
+}
+
+///
+/// \brief Compares all settings and program images against expected values.
+/// \returns Number of values which differ.
+///
+static uint32_t migrationCompare()
+{
+    uint32_t mismatches = 0;
+
+    if (!database.signatureValid())
+        mismatches++;
+
+    for (uint8_t i=0; i<MIGRATION_SECTIONS; i++)
+    {
+        for (uint16_t j=0; j<migrationParameters(i); j++)
+        {
+            if (database.read(migrationSections[i].block, migrationSections[i].section, j) != migrationExpected[migrationStart(i)+j])
+                mismatches++;
+        }
+    }
+
+    for (int i=0; i<NUMBER_OF_PROGRAMS; i++)
+    {
+        const programImage_t &image = database.getProgram(i);
+
+        for (int j=0; j<GLOBAL_PROGRAM_SETTINGS; j++)
+        {
+            if (image.global[j] != migrationExpected[migrationStart(2)+GLOBAL_PROGRAM_SETTINGS*i+j])
+                mismatches++;
+        }
+
+        for (int j=0; j<EXTENDED_PROGRAM_SETTINGS; j++)
+        {
+            if (image.extended[j] != migrationExpected[migrationStart(13)+EXTENDED_PROGRAM_SETTINGS*i+j])
+                mismatches++;
+        }
+
+        for (int j=0; j<NUMBER_OF_PADS*LOCAL_PROGRAM_SETTINGS; j++)
+        {
+            if (image.local[j/LOCAL_PROGRAM_SETTINGS][j%LOCAL_PROGRAM_SETTINGS] != migrationExpected[migrationStart(3)+LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*i+j])
+                mismatches++;
+        }
+
+        if (image.scale != migrationExpected[migrationStart(1)+i])
+            mismatches++;
+    }
+
+    return mismatches;
+}
+
+///
+/// \brief Performs single migration step, after which power is randomly lost.
+/// @param [in] losses          Set to true if power can be lost.
+/// @param [in,out] lossCount   Number of power losses.
+/// \returns True if migration is done, false otherwise.
+///
+static bool migrationStep(bool losses, uint32_t &lossCount)
+{
+    if (database.migrate())
+        return true;
+
+    if (!losses || (hostRandom(migrationSeed) % MIGRATION_POWER_LOSS))
+        return false;
+
+    //some of queued bytes are written before power is lost
+    hostDelay_us(hostRandom(migrationSeed) % 50000);
+    migrationPowerLoss();
+    database.init();
+    lossCount++;
+
+    return false;
+}
+
+///
+/// \brief Starts database and migrates memory, then reports number of steps done on startup
+/// and from main loop, time for which startup is blocked and number of written EEPROM bytes.
+/// @param [in] name    Name of migrated layout.
+/// @param [in] losses  Set to true if power is randomly lost after migration steps.
+/// @param [in] update  Set to true if setting is changed while default map is being written.
+/// \returns Number of values which differ during migration, after it and after simulated restart,
+/// increased by one if startup has been blocked for too long.
+///
+static uint32_t migrationRun(const char *name, bool losses, bool update)
+{
+    uint32_t writes = hostEEPROMwrites;
+    uint32_t start_us = hostTime_us();
+    uint32_t startupSteps = 0;
+    uint32_t loopSteps = 0;
+    uint32_t lossCount = 0;
+    uint32_t mismatches = 0;
+
+    database.init();
+
+    if (!database.migrationPending())
+        mismatches++;
+
+    while (database.migrationBlocked())
+    {
+        migrationStep(losses, lossCount);
+        startupSteps++;
+    }
+
+    uint32_t blocked_us = hostTime_us() - start_us;
+    uint32_t startupWrites = hostEEPROMwrites - writes;
+
+    if ((startupWrites > MIGRATION_STARTUP_WRITES) || (!losses && (blocked_us > MIGRATION_STARTUP_US)))
+        mismatches++;
+
+    //settings are used while default map is being written
+    mismatches += migrationCompare();
+
+    if (update && database.migrationPending())
+    {
+        uint8_t section = hostRandom(migrationSeed) % MIGRATION_SECTIONS;
+        uint16_t parameter = hostRandom(migrationSeed) % migrationParameters(section);
+        int32_t value = hostRandom(migrationSeed) & 0x7F;
+
+        database.update(migrationSections[section].block, migrationSections[section].section, parameter, value);
+        migrationExpected[migrationStart(section)+parameter] = value;
+
+        //migration is finished first
+        if (database.migrationPending())
+            mismatches++;
+    }
+
+    writes = hostEEPROMwrites;
+
+    while (database.migrationPending())
+    {
+        hostDelay_us(1000);
+
+        if (!database.updateMigration())
+            continue;
+
+        loopSteps++;
+
+        if (!database.migrationPending() || !losses || (hostRandom(migrationSeed) % MIGRATION_POWER_LOSS))
+            continue;
+
+        hostDelay_us(hostRandom(migrationSeed) % 50000);
+        migrationPowerLoss();
+        database.init();
+        lossCount++;
+    }
+
+    hostDrain();
+
+    writes = hostEEPROMwrites - writes;
+    mismatches += migrationCompare();
+    //restart
+    database.init();
+    mismatches += migrationCompare();
+
+    fprintf(stderr, "migration (%s): startup %u steps blocked %u us with %u EEPROM bytes written, main loop %u steps with %u EEPROM bytes written, %u power losses, %u mismatches\n",
+        name, startupSteps, blocked_us, startupWrites, loopSteps, writes, lossCount, mismatches);
+
+    return mismatches;
+}
+
+///
+/// \brief Writes schema record which requests migration of current layout to itself.
+///
+static void migrationRequestCurrent()
+{
+    uint8_t sequence = 0;
+
+    hostDrain();
+
+    for (int i=0; i<DB_SCHEMA_RECORDS; i++)
+    {
+        uint8_t value = eeprom_read_byte((const uint8_t*)(uintptr_t)(DB_SCHEMA_ADDRESS+i*DB_SCHEMA_RECORD_SIZE));
+
+        if (!i || ((int8_t)(value - sequence) > 0))
+            sequence = value;
+    }
+
+    sequence++;
+
+    uint8_t record[DB_SCHEMA_RECORD_SIZE] = { sequence, DB_SCHEMA_VERSION, DB_SCHEMA_VERSION, dbMigrationDefaults, 0, 0, DB_SCHEMA_CHECK_MASK };
+
+    for (int i=0; i<(DB_SCHEMA_RECORD_SIZE-1); i++)
+        record[DB_SCHEMA_RECORD_SIZE-1] ^= record[i];
+
+    for (int i=0; i<DB_SCHEMA_RECORD_SIZE; i++)
+        eeprom_update_byte((uint8_t*)(uintptr_t)(DB_SCHEMA_ADDRESS+(sequence%DB_SCHEMA_RECORDS)*DB_SCHEMA_RECORD_SIZE+i), record[i]);
+}
+
+/// @}
+
+uint32_t hostMigrationBenchmark()
+{
+    uint32_t mismatches = 0;
+
+    migrationWriteSchema(0);
+    mismatches += migrationRun("schema 0", false, false);
+    migrationWriteSchema(0);
+    mismatches += migrationRun("schema 0, power losses", true, false);
+    migrationWriteSchema(0);
+    mismatches += migrationRun("schema 0, power losses, update", true, true);
+
+    //default chunks and log ring in use
+    database.factoryReset(initFull);
+
+    for (int i=0; i<MIGRATION_RANDOM_WRITES; i++)
+    {
+        uint8_t section = hostRandom(migrationSeed) % MIGRATION_SECTIONS;
+        uint16_t parameter = hostRandom(migrationSeed) % (migrationParameters(section)/8+1);
+
+        database.update(migrationSections[section].block, migrationSections[section].section, parameter, hostRandom(migrationSeed) & 0x7F);
+    }
+
+    hostDrain();
+    migrationExpectCurrent();
+    migrationRequestCurrent();
+    mismatches += migrationRun("current schema, power losses", true, false);
+
+    return mismatches;
+}
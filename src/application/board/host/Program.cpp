@@ -0,0 +1,275 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#include <stdio.h>
+#include "Host.h"
+#include "database/Database.h"
+#include "util/delay.h"
+
+///
+/// \ingroup boardHost
+/// @{
+
+//program switch cost. Settings of every program are loaded parameter by parameter
+//(as pads used to load them on each program switch) and as program image (see
+//Database::getProgram). EEPROM reads and time spent on both are reported and
+//values from both are compared. Program cache is then checked on random encoder
+//walk with main loop prefetch between steps and settings changed along the way. Database is
+//initialized on simulated EEPROM with random program settings, so benchmark needs
+//to run before EEPROM image is loaded.
+
+///
+/// \brief Number of times all programs are loaded with each method.
+///
+#define PROGRAM_LOAD_ROUNDS     200
+
+///
+/// \brief Number of program changes in random encoder walk.
+///
+#define PROGRAM_WALK_STEPS      5000
+
+///
+/// \brief Time in milliseconds between two program changes in encoder walk.
+///
+#define PROGRAM_WALK_STEP_TIME  50
+
+///
+/// \brief Seed of pseudo-random numbers (see hostRandom).
+///
+static uint32_t programSeed = 1;
+
+///
+/// \brief Reads settings of requested program parameter by parameter.
+///
+static void programLoadParameters(uint8_t program, programImage_t &image)
+{
+    for (int i=0; i<GLOBAL_PROGRAM_SETTINGS; i++)
+        image.global[i] = database.read(DB_BLOCK_PROGRAM, programGlobalSettingsSection, i+(GLOBAL_PROGRAM_SETTINGS*(uint16_t)program));
+
+    for (int i=0; i<EXTENDED_PROGRAM_SETTINGS; i++)
+        image.extended[i] = database.read(DB_BLOCK_PROGRAM_EXTENDED, programExtendedSettingsSection, i+(EXTENDED_PROGRAM_SETTINGS*(uint16_t)program));
+
+    for (int i=0; i<NUMBER_OF_PADS; i++)
+    {
+        for (int j=0; j<LOCAL_PROGRAM_SETTINGS; j++)
+            image.local[i][j] = database.read(DB_BLOCK_PROGRAM, programLocalSettingsSection, (LOCAL_PROGRAM_SETTINGS*i+j)+(LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*(uint16_t)program));
+    }
+
+    image.scale = database.read(DB_BLOCK_PROGRAM, programLastActiveScaleSection, program);
+
+    for (int i=0; i<PREDEFINED_SCALES; i++)
+    {
+        for (int j=0; j<PREDEFINED_SCALE_PARAMETERS; j++)
+            image.predefinedScale[i][j] = database.read(DB_BLOCK_SCALE, scalePredefinedSection, (PREDEFINED_SCALE_PARAMETERS*i+j)+(PREDEFINED_SCALE_PARAMETERS*PREDEFINED_SCALES*(uint16_t)program));
+    }
+}
+
+///
+/// \brief Writes random value to random program setting of requested program.
+///
+static void programChangeSetting(uint8_t program)
+{
+    uint8_t value = hostRandom(programSeed) & 0x7F;
+
+    switch(hostRandom(programSeed) % 5)
+    {
+        case 0:
+        database.update(DB_BLOCK_PROGRAM, programGlobalSettingsSection, (hostRandom(programSeed) % GLOBAL_PROGRAM_SETTINGS)+(GLOBAL_PROGRAM_SETTINGS*(uint16_t)program), value);
+        break;
+
+        case 1:
+        database.update(DB_BLOCK_PROGRAM, programLocalSettingsSection, (hostRandom(programSeed) % (LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS))+(LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*(uint16_t)program), value);
+        break;
+
+        case 2:
+        database.update(DB_BLOCK_PROGRAM, programLastActiveScaleSection, program, value);
+        break;
+
+        case 3:
+        database.update(DB_BLOCK_PROGRAM_EXTENDED, programExtendedSettingsSection, (hostRandom(programSeed) % EXTENDED_PROGRAM_SETTINGS)+(EXTENDED_PROGRAM_SETTINGS*(uint16_t)program), value);
+        break;
+
+        default:
+        database.update(DB_BLOCK_SCALE, scalePredefinedSection, (hostRandom(programSeed) % (PREDEFINED_SCALE_PARAMETERS*PREDEFINED_SCALES))+(PREDEFINED_SCALE_PARAMETERS*PREDEFINED_SCALES*(uint16_t)program), value);
+        break;
+    }
+}
+
+///
+/// \brief Compares program image against settings read parameter by parameter.
+/// \returns Number of settings which differ.
+///
+static uint32_t programCompare(uint8_t program)
+{
+    programImage_t image;
+    uint32_t mismatches = 0;
+
+    programLoadParameters(program, image);
+    const programImage_t &loaded = database.getProgram(program);
+
+    for (size_t i=0; i<sizeof(image); i++)
+    {
+        if (((const uint8_t*)&image)[i] != ((const uint8_t*)&loaded)[i])
+            mismatches++;
+    }
+
+    return mismatches;
+}
+
+/// @}
+
+uint32_t hostProgramBenchmark()
+{
+    uint32_t mismatches = 0;
+
+    database.init();
+    database.factoryReset(initFull);
+
+    for (int i=0; i<NUMBER_OF_PROGRAMS; i++)
+    {
+        for (int j=0; j<GLOBAL_PROGRAM_SETTINGS; j++)
+            database.update(DB_BLOCK_PROGRAM, programGlobalSettingsSection, j+(GLOBAL_PROGRAM_SETTINGS*i), hostRandom(programSeed) & 0x7F);
+
+        for (int j=0; j<EXTENDED_PROGRAM_SETTINGS; j++)
+            database.update(DB_BLOCK_PROGRAM_EXTENDED, programExtendedSettingsSection, j+(EXTENDED_PROGRAM_SETTINGS*i), hostRandom(programSeed) & 0x7F);
+
+        for (int j=0; j<LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS; j++)
+            database.update(DB_BLOCK_PROGRAM, programLocalSettingsSection, j+(LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*i), hostRandom(programSeed) & 0x7F);
+
+        database.update(DB_BLOCK_PROGRAM, programLastActiveScaleSection, i, hostRandom(programSeed) & 0x7F);
+
+        for (int j=0; j<PREDEFINED_SCALE_PARAMETERS*PREDEFINED_SCALES; j++)
+            database.update(DB_BLOCK_SCALE, scalePredefinedSection, j+(PREDEFINED_SCALE_PARAMETERS*PREDEFINED_SCALES*i), hostRandom(programSeed) & 0x7F);
+    }
+
+    programImage_t image;
+    uint64_t start;
+    uint64_t parameterTime;
+    uint64_t imageTime;
+    uint32_t parameterReads;
+    uint32_t imageReads;
+
+    //compare first
+    for (int i=0; i<NUMBER_OF_PROGRAMS; i++)
+        mismatches += programCompare(i);
+
+    parameterReads = hostEEPROMreads;
+    start = hostTime_ns();
+
+    for (int i=0; i<PROGRAM_LOAD_ROUNDS; i++)
+    {
+        for (int j=0; j<NUMBER_OF_PROGRAMS; j++)
+            programLoadParameters(j, image);
+    }
+
+    parameterTime = hostTime_ns() - start;
+    parameterReads = hostEEPROMreads - parameterReads;
+
+    imageReads = hostEEPROMreads;
+    start = hostTime_ns();
+
+    for (int i=0; i<PROGRAM_LOAD_ROUNDS; i++)
+    {
+        //each program differs from previous one so image is always loaded
+        for (int j=0; j<NUMBER_OF_PROGRAMS; j++)
+            database.getProgram(j);
+    }
+
+    imageTime = hostTime_ns() - start;
+    imageReads = hostEEPROMreads - imageReads;
+
+    uint32_t loads = PROGRAM_LOAD_ROUNDS*NUMBER_OF_PROGRAMS;
+
+    fprintf(stderr, "program load (%u bytes): per parameter %u EEPROM reads %.0f ns, image %u EEPROM reads %.0f ns, %u mismatches\n",
+        (unsigned)sizeof(programImage_t),
+        parameterReads/loads, (double)parameterTime/loads,
+        imageReads/loads, (double)imageTime/loads,
+        mismatches);
+
+    //encoder walk
+    uint32_t hits, misses;
+    uint32_t walkHits = 0;
+    uint32_t walkMisses = 0;
+    uint32_t switchReads = 0;
+    uint32_t prefetchReads = 0;
+    uint32_t maxSwitchReads = 0;
+    uint32_t reads;
+    int8_t program = 0;
+
+    for (int i=0; i<PROGRAM_WALK_STEPS; i++)
+    {
+        //mostly single steps, sometimes a jump
+        if (hostRandom(programSeed) % 8)
+            program += (hostRandom(programSeed) & 0x01) ? 1 : -1;
+        else
+            program = hostRandom(programSeed) % NUMBER_OF_PROGRAMS;
+
+        if (program == NUMBER_OF_PROGRAMS)
+            program = 0;
+        else if (program < 0)
+            program = NUMBER_OF_PROGRAMS-1;
+
+        database.getProgramCacheStats(hits, misses);
+        walkHits -= hits;
+        walkMisses -= misses;
+        reads = hostEEPROMreads;
+        database.getProgram(program);
+        reads = hostEEPROMreads - reads;
+        database.getProgramCacheStats(hits, misses);
+        walkHits += hits;
+        walkMisses += misses;
+        switchReads += reads;
+
+        if (reads > maxSwitchReads)
+            maxSwitchReads = reads;
+
+        if (!(hostRandom(programSeed) % 4))
+            programChangeSetting((program + (hostRandom(programSeed) % 3) + NUMBER_OF_PROGRAMS-1) % NUMBER_OF_PROGRAMS);
+
+        //main loop passes until next change
+        reads = hostEEPROMreads;
+
+        for (int j=0; j<PROGRAM_WALK_STEP_TIME; j++)
+        {
+            hostDelay_us(1000);
+            writeCache.update(true);
+            database.prefetchPrograms();
+        }
+
+        prefetchReads += hostEEPROMreads - reads;
+
+        //neighbors are cached now so this doesn't load anything, active program is requested last again
+        mismatches += programCompare((program + 1) % NUMBER_OF_PROGRAMS);
+        mismatches += programCompare((program + NUMBER_OF_PROGRAMS-1) % NUMBER_OF_PROGRAMS);
+        mismatches += programCompare(program);
+    }
+
+    fprintf(stderr, "program walk: %u changes, cache hits %u, misses %u, EEPROM reads per change avg %.1f max %u, prefetch %.1f\n",
+        (unsigned)(walkHits+walkMisses), walkHits, walkMisses,
+        (double)switchReads/PROGRAM_WALK_STEPS, maxSwitchReads,
+        (double)prefetchReads/PROGRAM_WALK_STEPS);
+
+    return mismatches;
+}
@@ -0,0 +1,52 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#include <avr/io.h>
+
+///
+/// \ingroup boardHost
+/// @{
+
+#define HOST_DEFINE_REGISTER_8(name)    volatile uint8_t name;
+#define HOST_DEFINE_REGISTER_16(name)   volatile uint16_t name;
+
+volatile uint8_t hostPortRegisters[HOST_NUMBER_OF_PORTS][3];
+
+HOST_REGISTERS_8(HOST_DEFINE_REGISTER_8)
+HOST_REGISTERS_16(HOST_DEFINE_REGISTER_16)
+
+///
+/// \brief Presets register flags which hardware would set on its own.
+/// Runs before main so that registers are valid even for static initializers.
+///
+static void __attribute__((constructor)) initRegisters()
+{
+    //spi transfer is always complete
+    SPSR = (1<<SPIF);
+    //uart data register is always empty
+    UCSR1A = (1<<UDRE1);
+}
+
+/// @}
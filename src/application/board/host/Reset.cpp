@@ -0,0 +1,248 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#include <stdio.h>
+#include "Host.h"
+#include "board/Board.h"
+#include "database/Database.h"
+#include "util/delay.h"
+
+///
+/// \ingroup boardHost
+/// @{
+
+//factory reset with default values which aren't written to memory. Random settings are
+//written, after which full factory reset is timed and all settings are compared against
+//their default values, both read parameter by parameter and through program images.
+//Random settings are written again and checked after simulated restart, and then partial
+//reset is checked the same way: pad calibration needs to keep its written values. Database
+//needs to be initialized already (see hostProgramBenchmark).
+
+///
+/// \brief Number of random settings changes before each reset.
+///
+#define RESET_RANDOM_WRITES     3000
+
+///
+/// \brief Single checked section.
+///
+typedef struct
+{
+    uint8_t block;
+    uint8_t section;
+} resetSection_t;
+
+///
+/// \brief Checked sections. ID and log ring aren't accessed directly.
+///
+static constexpr resetSection_t resetSections[] =
+{
+    { DB_BLOCK_PROGRAM, programLastActiveProgramSection },
+    { DB_BLOCK_PROGRAM, programLastActiveScaleSection },
+    { DB_BLOCK_PROGRAM, programGlobalSettingsSection },
+    { DB_BLOCK_PROGRAM, programLocalSettingsSection },
+    { DB_BLOCK_SCALE, scalePredefinedSection },
+    { DB_BLOCK_SCALE, scaleUserSection },
+    { DB_BLOCK_PAD_CALIBRATION, padCalibrationPressureUpperSection },
+    { DB_BLOCK_PAD_CALIBRATION, padCalibrationXlowerSection },
+    { DB_BLOCK_PAD_CALIBRATION, padCalibrationXupperSection },
+    { DB_BLOCK_PAD_CALIBRATION, padCalibrationYlowerSection },
+    { DB_BLOCK_PAD_CALIBRATION, padCalibrationYupperSection },
+    { DB_BLOCK_GLOBAL_SETTINGS, globalSettingsMIDI },
+    { DB_BLOCK_GLOBAL_SETTINGS, globalSettingsVelocitySensitivity },
+    { DB_BLOCK_PROGRAM_EXTENDED, programExtendedSettingsSection },
+};
+
+#define RESET_SECTIONS  (sizeof(resetSections)/sizeof(resetSection_t))
+
+///
+/// \brief Returns number of parameters in checked section.
+///
+static constexpr uint16_t resetParameters(uint8_t section)
+{
+    return dbFormat(resetSections[section].block, resetSections[section].section).numberOfParameters;
+}
+
+///
+/// \brief Returns position of first expected value of checked section (see resetExpected).
+///
+static constexpr uint16_t resetStart(uint8_t section)
+{
+    return section ? (resetStart(section-1) + resetParameters(section-1)) : 0;
+}
+
+///
+/// \brief Expected value of each parameter of all checked sections, one section after another.
+///
+static int32_t resetExpected[resetStart(RESET_SECTIONS)];
+
+///
+/// \brief Seed of pseudo-random numbers (see hostRandom).
+///
+static uint32_t resetSeed = 3;
+
+///
+/// \brief Sets expected values of all sections (or of sections which aren't preserved
+/// on partial reset) to default values.
+///
+static void resetExpectDefaults(initType_t type)
+{
+    for (uint8_t i=0; i<RESET_SECTIONS; i++)
+    {
+        if ((type == initPartial) && (resetSections[i].block == DB_BLOCK_PAD_CALIBRATION))
+            continue;
+
+        for (uint16_t j=0; j<resetParameters(i); j++)
+            resetExpected[resetStart(i)+j] = database.getDefaultValue(resetSections[i].block, resetSections[i].section, j);
+    }
+}
+
+///
+/// \brief Writes random values to random settings.
+///
+static void resetWriteRandom()
+{
+    for (int i=0; i<RESET_RANDOM_WRITES; i++)
+    {
+        uint8_t section = hostRandom(resetSeed) % RESET_SECTIONS;
+        uint16_t parameter = hostRandom(resetSeed) % resetParameters(section);
+        int32_t value = hostRandom(resetSeed) & 0x7F;
+
+        database.update(resetSections[section].block, resetSections[section].section, parameter, value);
+        resetExpected[resetStart(section)+parameter] = value;
+
+        if (!(i % 16))
+            hostDelay_us(1000);
+    }
+
+    hostDrain();
+}
+
+///
+/// \brief Compares all settings and program images against expected values.
+/// \returns Number of values which differ.
+///
+static uint32_t resetCompare()
+{
+    uint32_t mismatches = 0;
+
+    for (uint8_t i=0; i<RESET_SECTIONS; i++)
+    {
+        for (uint16_t j=0; j<resetParameters(i); j++)
+        {
+            if (database.read(resetSections[i].block, resetSections[i].section, j) != resetExpected[resetStart(i)+j])
+                mismatches++;
+        }
+    }
+
+    for (int i=0; i<NUMBER_OF_PROGRAMS; i++)
+    {
+        const programImage_t &image = database.getProgram(i);
+
+        for (int j=0; j<GLOBAL_PROGRAM_SETTINGS; j++)
+        {
+            if (image.global[j] != resetExpected[resetStart(2)+GLOBAL_PROGRAM_SETTINGS*i+j])
+                mismatches++;
+        }
+
+        for (int j=0; j<EXTENDED_PROGRAM_SETTINGS; j++)
+        {
+            if (image.extended[j] != resetExpected[resetStart(13)+EXTENDED_PROGRAM_SETTINGS*i+j])
+                mismatches++;
+        }
+
+        for (int j=0; j<NUMBER_OF_PADS*LOCAL_PROGRAM_SETTINGS; j++)
+        {
+            if (image.local[j/LOCAL_PROGRAM_SETTINGS][j%LOCAL_PROGRAM_SETTINGS] != resetExpected[resetStart(3)+LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*i+j])
+                mismatches++;
+        }
+
+        if (image.scale != resetExpected[resetStart(1)+i])
+            mismatches++;
+
+        for (int j=0; j<PREDEFINED_SCALES*PREDEFINED_SCALE_PARAMETERS; j++)
+        {
+            if (image.predefinedScale[j/PREDEFINED_SCALE_PARAMETERS][j%PREDEFINED_SCALE_PARAMETERS] != resetExpected[resetStart(4)+PREDEFINED_SCALES*PREDEFINED_SCALE_PARAMETERS*i+j])
+                mismatches++;
+        }
+    }
+
+    return mismatches;
+}
+
+///
+/// \brief Performs factory reset and reports its duration and number of written EEPROM bytes.
+/// \returns Number of values which differ after reset and after simulated restart.
+///
+static uint32_t resetRun(initType_t type)
+{
+    uint32_t writes = hostEEPROMwrites;
+    uint32_t start_us = hostTime_us();
+    uint32_t mismatches = 0;
+
+    database.factoryReset(type);
+
+    uint32_t blocked_us = hostTime_us() - start_us;
+
+    hostDrain();
+
+    uint32_t total_us = hostTime_us() - start_us;
+
+    writes = hostEEPROMwrites - writes;
+    resetExpectDefaults(type);
+    mismatches += resetCompare();
+    //restart
+    database.init();
+    mismatches += resetCompare();
+
+    fprintf(stderr, "factory reset (%s): blocked %u us, done in %u us, %u EEPROM bytes written, %u mismatches\n",
+        (type == initPartial) ? "partial" : "full", blocked_us, total_us, writes, mismatches);
+
+    return mismatches;
+}
+
+/// @}
+
+uint32_t hostResetBenchmark()
+{
+    uint32_t mismatches = 0;
+    uint32_t restartMismatches;
+
+    hostDrain();
+    resetWriteRandom();
+    mismatches += resetRun(initFull);
+
+    resetWriteRandom();
+    database.init();
+    restartMismatches = resetCompare();
+    mismatches += restartMismatches;
+
+    fprintf(stderr, "factory reset: %u random writes after full reset, %u mismatches after restart\n", RESET_RANDOM_WRITES, restartMismatches);
+
+    resetWriteRandom();
+    mismatches += resetRun(initPartial);
+
+    return mismatches;
+}
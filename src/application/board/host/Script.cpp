@@ -0,0 +1,256 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Host.h"
+#include "core/src/general/BitManipulation.h"
+
+///
+/// \ingroup boardHost
+/// @{
+
+//input script is a plain text file with one event per line.
+//each line starts with simulated time in milliseconds at which event is applied,
+//followed by command and its arguments. Empty lines and lines starting with #
+//are ignored. Events must be sorted by time.
+//     <ms> pad <pad> <z> <x> <y>      Sets raw ADC readings for pad (held until changed).
+//     <ms> button <index> <0|1>       Sets state of button in button matrix.
+//     <ms> encoder <id> <steps>       Turns encoder by given amount of steps.
+//     <ms> sysex <F0 ... F7>          Receives SysEx message (hex bytes) over USB.
+//     <ms> end                        Ends simulation.
+
+padData_t       hostPadData;
+uint8_t         hostDigitalIn[DIGITAL_IN_ARRAY_SIZE];
+
+///
+/// \brief Maximum length of single script line.
+///
+#define SCRIPT_LINE_SIZE        128
+
+///
+/// \brief Amount of quadrature transitions needed for single encoder step.
+///
+#define ENCODER_TRANSITIONS     4
+
+///
+/// \brief Encoder A/B signal states in quadrature order.
+///
+static const uint8_t encoderQuadrature[ENCODER_TRANSITIONS] = { 0b00, 0b01, 0b11, 0b10 };
+
+static FILE         *script;
+static char         scriptLine[SCRIPT_LINE_SIZE];
+static bool         scriptLinePending;
+static bool         scriptEnd;
+static uint32_t     scriptLineTime_ms;
+static uint32_t     scriptLineNumber;
+
+///
+/// \brief Remaining quadrature transitions for all encoders (sign defines direction).
+///
+static int16_t      encoderTransitions[MAX_NUMBER_OF_ENCODERS];
+
+///
+/// \brief Current quadrature position for all encoders.
+///
+static uint8_t      encoderPhase[MAX_NUMBER_OF_ENCODERS];
+
+///
+/// \brief Reads next event from script.
+/// \returns True if event has been read, false on end of script.
+///
+static bool readScriptLine()
+{
+    while (fgets(scriptLine, SCRIPT_LINE_SIZE, script) != NULL)
+    {
+        scriptLineNumber++;
+
+        char *start = scriptLine + strspn(scriptLine, " \t");
+
+        if ((*start == '#') || (*start == '\n') || (*start == '\r') || (*start == '\0'))
+            continue;
+
+        char *end;
+        scriptLineTime_ms = strtoul(start, &end, 10);
+
+        if (end == start)
+        {
+            fprintf(stderr, "Script line %u: missing event time\n", scriptLineNumber);
+            continue;
+        }
+
+        memmove(scriptLine, end, strlen(end) + 1);
+        scriptLinePending = true;
+        return true;
+    }
+
+    return false;
+}
+
+///
+/// \brief Applies single script event.
+///
+static void applyScriptLine()
+{
+    char command[16];
+    int arg[4];
+
+    if (sscanf(scriptLine, "%15s", command) != 1)
+        return;
+
+    const char *args = strstr(scriptLine, command) + strlen(command);
+
+    if (!strcmp(command, "pad"))
+    {
+        if ((sscanf(args, "%d %d %d %d", &arg[0], &arg[1], &arg[2], &arg[3]) == 4) && (arg[0] >= 0) && (arg[0] < NUMBER_OF_PADS))
+        {
+            hostPadData.zReading[arg[0]] = arg[1];
+            hostPadData.xReading[arg[0]] = arg[2];
+            hostPadData.yReading[arg[0]] = arg[3];
+            hostLatencyFrame(hostPadData);
+            return;
+        }
+    }
+    else if (!strcmp(command, "button"))
+    {
+        if ((sscanf(args, "%d %d", &arg[0], &arg[1]) == 2) && (arg[0] >= 0) && (arg[0] < MAX_NUMBER_OF_BUTTONS))
+        {
+            BIT_WRITE(hostDigitalIn[arg[0] % NUMBER_OF_BUTTON_COLUMNS], arg[0] / NUMBER_OF_BUTTON_COLUMNS, arg[1] ? 1 : 0);
+            return;
+        }
+    }
+    else if (!strcmp(command, "encoder"))
+    {
+        if ((sscanf(args, "%d %d", &arg[0], &arg[1]) == 2) && (arg[0] >= 0) && (arg[0] < MAX_NUMBER_OF_ENCODERS))
+        {
+            encoderTransitions[arg[0]] += arg[1]*ENCODER_TRANSITIONS;
+            return;
+        }
+    }
+    else if (!strcmp(command, "sysex"))
+    {
+        uint8_t sysEx[SCRIPT_LINE_SIZE/2];
+        uint16_t size = 0;
+        char *end;
+
+        while (size < sizeof(sysEx))
+        {
+            long value = strtol(args, &end, 16);
+
+            if (end == args)
+                break;
+
+            sysEx[size++] = value;
+            args = end;
+        }
+
+        if ((size >= 2) && (sysEx[0] == 0xF0) && (sysEx[size-1] == 0xF7))
+        {
+            hostSysExReceive(sysEx, size);
+            return;
+        }
+    }
+    else if (!strcmp(command, "end"))
+    {
+        scriptEnd = true;
+        return;
+    }
+
+    fprintf(stderr, "Script line %u: invalid event \"%s\"\n", scriptLineNumber, command);
+}
+
+/// @}
+
+void hostScriptInit()
+{
+    const char *path = getenv("ZVUK9_SCRIPT");
+
+    if (path == NULL)
+    {
+        //script is optional when pad trace is replayed
+        if (getenv("ZVUK9_TRACE") != NULL)
+        {
+            scriptEnd = true;
+            return;
+        }
+
+        script = stdin;
+    }
+    else
+    {
+        script = fopen(path, "r");
+    }
+
+    if (script == NULL)
+    {
+        fprintf(stderr, "Unable to open script %s\n", path);
+        exit(1);
+    }
+}
+
+bool hostScriptUpdate()
+{
+    while (!scriptEnd)
+    {
+        if (!scriptLinePending && !readScriptLine())
+            return false;
+
+        if ((uint64_t)scriptLineTime_ms*1000 > hostTime_us())
+            return true;
+
+        applyScriptLine();
+        scriptLinePending = false;
+    }
+
+    return false;
+}
+
+void hostEncoderUpdate()
+{
+    for (int i=0; i<MAX_NUMBER_OF_ENCODERS; i++)
+    {
+        if (!encoderTransitions[i])
+            continue;
+
+        if (encoderTransitions[i] > 0)
+        {
+            encoderPhase[i]++;
+            encoderTransitions[i]--;
+        }
+        else
+        {
+            encoderPhase[i]--;
+            encoderTransitions[i]++;
+        }
+
+        uint8_t column = i % NUMBER_OF_BUTTON_COLUMNS;
+        uint8_t row = (i/NUMBER_OF_BUTTON_COLUMNS)*2;
+        uint8_t pairState = encoderQuadrature[encoderPhase[i] % ENCODER_TRANSITIONS];
+
+        hostDigitalIn[column] &= ~(0x03 << row);
+        hostDigitalIn[column] |= (pairState << row);
+    }
+}
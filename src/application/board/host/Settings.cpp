@@ -0,0 +1,284 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#include <stdio.h>
+#include "Host.h"
+#include "database/Database.h"
+#include "util/delay.h"
+
+///
+/// \ingroup boardHost
+/// @{
+
+//settings writes. Encoder sweep and user scale write are run through write cache and
+//time for which main loop is blocked while settings are being changed is measured, along
+//with number of EEPROM bytes written. Program is then changed right after user scale write,
+//with full cache and EEPROM queue, once with cache flush and once with cache drained from
+//main loop while pads are pressed, and longest time for which main loop is blocked is compared. Random settings are then written and read back with
+//random passing of time in between and compared against expected values, before and after
+//cache is flushed. Database needs to be initialized already (see hostProgramBenchmark).
+
+///
+/// \brief Time in milliseconds between two encoder steps in sweep.
+///
+#define SETTINGS_SWEEP_STEP_TIME    10
+
+///
+/// \brief Time in milliseconds after which all changed settings are expected to be written.
+///
+#define SETTINGS_SETTLE_TIME        (WRITE_CACHE_QUIET_TIME+500)
+
+///
+/// \brief Number of random settings changes.
+///
+#define SETTINGS_RANDOM_WRITES      5000
+
+///
+/// \brief Number of randomly changed settings of each kind.
+///
+#define SETTINGS_RANDOM_RANGE       64
+
+///
+/// \brief Seed of pseudo-random numbers (see hostRandom).
+///
+static uint32_t settingsSeed = 7;
+
+///
+/// \brief Advances time by requested number of milliseconds while calling main loop write cache update.
+///
+static void settingsWait(uint32_t time_ms, bool idle)
+{
+    for (uint32_t i=0; i<time_ms; i++)
+    {
+        hostDelay_us(1000);
+        writeCache.update(idle);
+    }
+}
+
+///
+/// \brief Total and longest time in microseconds spent in settings updates.
+/// @{
+
+static uint32_t blocked_us;
+static uint32_t maxBlocked_us;
+
+/// @}
+
+///
+/// \brief Updates setting and measures time spent in update.
+///
+static void settingsUpdate(uint8_t blockID, uint8_t sectionID, uint16_t parameterID, int32_t value)
+{
+    uint32_t start_us = hostTime_us();
+
+    database.update(blockID, sectionID, parameterID, value);
+
+    uint32_t time_us = hostTime_us() - start_us;
+
+    blocked_us += time_us;
+
+    if (time_us > maxBlocked_us)
+        maxBlocked_us = time_us;
+}
+
+///
+/// \brief Writes all notes of user scale, leaving write cache and EEPROM queue full.
+///
+static void settingsWriteUserScale()
+{
+    for (int i=0; i<NUMBER_OF_PADS*NOTES_PER_PAD; i++)
+        database.update(DB_BLOCK_SCALE, scaleUserSection, i, hostRandom(settingsSeed) & 0x7F);
+}
+
+///
+/// \brief Expected values of randomly changed settings.
+/// @{
+
+static uint8_t  expectedLocal[SETTINGS_RANDOM_RANGE];
+static uint16_t expectedCalibration[NUMBER_OF_PADS];
+
+/// @}
+
+///
+/// \brief Compares randomly changed settings against expected values.
+/// \returns Number of settings which differ.
+///
+static uint32_t settingsCompare()
+{
+    uint32_t mismatches = 0;
+
+    for (int i=0; i<SETTINGS_RANDOM_RANGE; i++)
+    {
+        if (database.read(DB_BLOCK_PROGRAM, programLocalSettingsSection, i) != expectedLocal[i])
+            mismatches++;
+    }
+
+    for (int i=0; i<NUMBER_OF_PADS; i++)
+    {
+        if (database.read(DB_BLOCK_PAD_CALIBRATION, padCalibrationXlowerSection, i) != expectedCalibration[i])
+            mismatches++;
+    }
+
+    //bulk read
+    const programImage_t &image = database.getProgram(0);
+
+    for (int i=0; i<SETTINGS_RANDOM_RANGE; i++)
+    {
+        if (image.local[i / LOCAL_PROGRAM_SETTINGS][i % LOCAL_PROGRAM_SETTINGS] != expectedLocal[i])
+            mismatches++;
+    }
+
+    return mismatches;
+}
+
+/// @}
+
+uint32_t hostSettingsBenchmark()
+{
+    uint32_t mismatches = 0;
+    uint32_t updates = 0;
+    uint32_t writes;
+
+    writeCache.flush();
+    settingsWait(WRITE_CACHE_QUIET_TIME, true);
+
+    //encoder sweep over lower and upper X limit and X curve of first pad, up and back down
+    writes = hostEEPROMwrites;
+    blocked_us = 0;
+    maxBlocked_us = 0;
+
+    for (int i=0; i<3; i++)
+    {
+        for (int j=0; j<256; j++)
+        {
+            settingsUpdate(DB_BLOCK_PROGRAM, programLocalSettingsSection, LOCAL_PROGRAM_SETTING_X_MIN_ID+i, (j < 128) ? j : 255-j);
+            updates++;
+            settingsWait(SETTINGS_SWEEP_STEP_TIME, true);
+        }
+    }
+
+    settingsWait(SETTINGS_SETTLE_TIME, true);
+
+    fprintf(stderr, "settings sweep: %u updates, blocked avg %u us max %u us, %u EEPROM bytes written, %u dirty left\n",
+        updates, blocked_us/updates, maxBlocked_us, hostEEPROMwrites - writes, writeCache.getDirtyCount());
+
+    //user scale, all notes of all pads
+    updates = 0;
+    writes = hostEEPROMwrites;
+    blocked_us = 0;
+    maxBlocked_us = 0;
+
+    for (int i=0; i<NUMBER_OF_PADS*NOTES_PER_PAD; i++)
+    {
+        settingsUpdate(DB_BLOCK_SCALE, scaleUserSection, i, hostRandom(settingsSeed) & 0x7F);
+        updates++;
+    }
+
+    uint32_t loop_us = blocked_us;
+
+    settingsWait(SETTINGS_SETTLE_TIME, true);
+
+    fprintf(stderr, "settings user scale: %u updates, blocked %u us total max %u us, %u EEPROM bytes written, %u dirty left\n",
+        updates, loop_us, maxBlocked_us, hostEEPROMwrites - writes, writeCache.getDirtyCount());
+
+    //program change after user scale write, cache written at once
+    settingsWriteUserScale();
+
+    uint32_t start_us = hostTime_us();
+
+    writeCache.flush();
+
+    uint32_t flush_us = hostTime_us() - start_us;
+
+    settingsWait(SETTINGS_SETTLE_TIME, true);
+
+    //and drained from main loop while pads are pressed
+    settingsWriteUserScale();
+
+    uint8_t dirty = writeCache.getDirtyCount();
+
+    writeCache.drain();
+
+    uint32_t drainTime = 0;
+
+    maxBlocked_us = 0;
+
+    for (; writeCache.getDirtyCount() && (drainTime < SETTINGS_SETTLE_TIME); drainTime++)
+    {
+        hostDelay_us(1000);
+        start_us = hostTime_us();
+        writeCache.update(false);
+
+        uint32_t time_us = hostTime_us() - start_us;
+
+        if (time_us > maxBlocked_us)
+            maxBlocked_us = time_us;
+    }
+
+    fprintf(stderr, "settings program change: %u dirty, flush blocked %u us, drain blocked max %u us over %u ms, %u dirty left\n",
+        dirty, flush_us, maxBlocked_us, drainTime, writeCache.getDirtyCount());
+
+    //single parameter at a time is written to empty queue, which never waits
+    if (writeCache.getDirtyCount() || (maxBlocked_us >= 1000))
+        mismatches++;
+
+    //random changes, with pads used most of the time
+    for (int i=0; i<SETTINGS_RANDOM_RANGE; i++)
+        expectedLocal[i] = database.read(DB_BLOCK_PROGRAM, programLocalSettingsSection, i);
+
+    for (int i=0; i<NUMBER_OF_PADS; i++)
+        expectedCalibration[i] = database.read(DB_BLOCK_PAD_CALIBRATION, padCalibrationXlowerSection, i);
+
+    for (int i=0; i<SETTINGS_RANDOM_WRITES; i++)
+    {
+        if (hostRandom(settingsSeed) & 0x01)
+        {
+            uint8_t index = hostRandom(settingsSeed) % SETTINGS_RANDOM_RANGE;
+
+            expectedLocal[index] = hostRandom(settingsSeed) & 0x7F;
+            settingsUpdate(DB_BLOCK_PROGRAM, programLocalSettingsSection, index, expectedLocal[index]);
+        }
+        else
+        {
+            uint8_t index = hostRandom(settingsSeed) % NUMBER_OF_PADS;
+
+            expectedCalibration[index] = hostRandom(settingsSeed) & 0x3FF;
+            settingsUpdate(DB_BLOCK_PAD_CALIBRATION, padCalibrationXlowerSection, index, expectedCalibration[index]);
+        }
+
+        settingsWait(hostRandom(settingsSeed) % 100, (hostRandom(settingsSeed) % 8) == 0);
+
+        if (!(i % 64))
+            mismatches += settingsCompare();
+    }
+
+    mismatches += settingsCompare();
+    writeCache.flush();
+    mismatches += settingsCompare();
+
+    fprintf(stderr, "settings random: %u writes, %u mismatches\n", SETTINGS_RANDOM_WRITES, mismatches);
+
+    return mismatches;
+}
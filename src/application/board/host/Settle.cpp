@@ -0,0 +1,237 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#include <stdio.h>
+#include <math.h>
+#include "Host.h"
+#include "board/common/analog/Scan.h"
+
+///
+/// \ingroup boardHost
+/// @{
+
+//model of pad readout timing used to check pipelined readout (PAD_SCAN_PIPELINE).
+//ADC input is modelled as single node which approaches voltage of newly set up reading
+//exponentially, with time constant chosen per reading so that node settles within
+//half of LSB in padSettleTime_us. Same sequence of readings (padScanAdvance) is
+//converted with one discarded conversion after each setup and with pipelined readout
+//(next reading set up PAD_SCAN_SAMPLE_HOLD_US after conversion start), and ADC results
+//of both are compared.
+
+///
+/// \brief Number of readouts converted with each readout type.
+///
+#define SETTLE_READOUTS         200
+
+///
+/// \brief Time from conversion start to the moment ADC samples its input (1.5 ADC clock cycles).
+///
+#define SETTLE_SAMPLE_TIME_US   (HOST_ADC_CONVERSION_TIME_US*3.0/26.0)
+
+///
+/// \brief Ratio between settle time and time constant of modelled input.
+/// Remaining error after settle time is 1023*e^(-8), which is less than half of LSB.
+///
+#define SETTLE_TIME_CONSTANTS   8.0
+
+///
+/// \brief State of modelled ADC input node.
+///
+typedef struct
+{
+    double startValue;
+    double target;
+    double tau_us;
+    double start_us;
+} settleNode_t;
+
+///
+/// \brief ADC results for all readings of all readouts.
+///
+typedef uint16_t settleResults_t[SETTLE_READOUTS][NUMBER_OF_PADS][PAD_READINGS];
+
+static settleResults_t  discardResults;
+static settleResults_t  pipelineResults;
+
+///
+/// \brief Returns modelled node voltage (in ADC steps) at specified time.
+///
+static double nodeValue(const settleNode_t &node, double time_us)
+{
+    return node.target + (node.startValue - node.target) * exp(-(time_us - node.start_us) / node.tau_us);
+}
+
+///
+/// \brief Switches node to specified reading at specified time.
+/// @param [in] settleScale     Multiplier applied to settle time used in model.
+///
+static void nodeSetup(settleNode_t &node, double time_us, uint8_t readout, uint8_t pad, uint8_t reading, double settleScale)
+{
+    //synthetic reading which slowly changes between readouts
+    uint32_t seed = (readout/8)*977 + pad*131 + reading*17 + 12345;
+
+    node.startValue = nodeValue(node, time_us);
+    node.target = hostRandom(seed) % 1024;
+    node.tau_us = (padSettleTime_us[reading] * settleScale) / SETTLE_TIME_CONSTANTS;
+    node.start_us = time_us;
+}
+
+///
+/// \brief Returns ADC result for node sampled at specified time.
+///
+static uint16_t nodeSample(const settleNode_t &node, double time_us)
+{
+    double value = floor(nodeValue(node, time_us) + 0.5);
+
+    if (value < 0)
+        return 0;
+
+    if (value > 1023)
+        return 1023;
+
+    return value;
+}
+
+///
+/// \brief Converts readouts with one discarded conversion after each setup.
+/// \returns Time needed for all readouts in microseconds.
+///
+static double settleRunDiscard(settleResults_t &results)
+{
+    settleNode_t node = { 0, 0, 1, 0 };
+    uint8_t pad = 0;
+    uint8_t reading = readPressure0;
+    uint8_t readout = 0;
+    double time_us = 0;
+
+    padScanPlan();
+    pad = padScanNext(-1);
+    nodeSetup(node, time_us, readout, pad, reading, 1);
+
+    while (readout < SETTLE_READOUTS)
+    {
+        //first conversion is discarded, second one is stored
+        results[readout][pad][reading] = nodeSample(node, time_us + HOST_ADC_CONVERSION_TIME_US + SETTLE_SAMPLE_TIME_US);
+        time_us += 2*HOST_ADC_CONVERSION_TIME_US;
+
+        if (padScanAdvance(pad, reading))
+            readout++;
+
+        nodeSetup(node, time_us, readout, pad, reading, 1);
+    }
+
+    return time_us;
+}
+
+///
+/// \brief Converts readouts with pipelined readout.
+/// @param [in] settleScale     Multiplier applied to modelled settle time.
+/// \returns Time needed for all readouts in microseconds.
+///
+static double settleRunPipeline(settleResults_t &results, double settleScale)
+{
+    settleNode_t node = { 0, 0, 1, 0 };
+    uint8_t pad = 0;
+    uint8_t reading = readPressure0;
+    uint8_t readout = 0;
+    double setup_us = 0;
+    double start_us;
+
+    padScanPlan();
+    pad = padScanNext(-1);
+    nodeSetup(node, setup_us, readout, pad, reading, settleScale);
+    start_us = setup_us + padSettleTime_us[reading];
+
+    while (true)
+    {
+        uint16_t result = nodeSample(node, start_us + SETTLE_SAMPLE_TIME_US);
+        results[readout][pad][reading] = result;
+
+        if (padScanAdvance(pad, reading))
+            readout++;
+
+        if (readout == SETTLE_READOUTS)
+            break;
+
+        //next reading is set up once current one has been sampled
+        setup_us = start_us + PAD_SCAN_SAMPLE_HOLD_US;
+        nodeSetup(node, setup_us, readout, pad, reading, settleScale);
+
+        //conversion is started once previous one is done and setup has settled
+        double settled_us = setup_us + padSettleTime_us[reading];
+        start_us += HOST_ADC_CONVERSION_TIME_US;
+
+        if (settled_us > start_us)
+            start_us = settled_us;
+    }
+
+    return start_us + HOST_ADC_CONVERSION_TIME_US;
+}
+
+///
+/// \brief Counts readings which differ between two runs.
+///
+static uint32_t settleCompare(const settleResults_t &first, const settleResults_t &second)
+{
+    uint32_t mismatches = 0;
+
+    for (int i=0; i<SETTLE_READOUTS; i++)
+    {
+        for (int j=0; j<NUMBER_OF_PADS; j++)
+        {
+            for (int k=0; k<PAD_READINGS; k++)
+            {
+                if (first[i][j][k] != second[i][j][k])
+                    mismatches++;
+            }
+        }
+    }
+
+    return mismatches;
+}
+
+/// @}
+
+uint32_t hostSettleBenchmark()
+{
+    //model full readouts (all coordinates on all pads)
+    uint16_t touched = padTouched;
+    padTouched = PAD_SCAN_ALL_PADS;
+
+    double discardTime_us = settleRunDiscard(discardResults);
+    double pipelineTime_us = settleRunPipeline(pipelineResults, 1);
+    uint32_t mismatches = settleCompare(discardResults, pipelineResults);
+
+    fprintf(stderr, "pad readout: discarded conversions %.0f us, pipelined %.0f us per readout (%.2fx), %u readings differ\n",
+        discardTime_us/SETTLE_READOUTS, pipelineTime_us/SETTLE_READOUTS, discardTime_us/pipelineTime_us, mismatches);
+
+    //sanity check of the model itself: inputs which need twice as long to settle have to be detected
+    settleRunPipeline(pipelineResults, 2);
+    fprintf(stderr, "pad readout: with settle times underestimated by half, %u readings differ\n", settleCompare(discardResults, pipelineResults));
+
+    padTouched = touched;
+
+    return mismatches;
+}
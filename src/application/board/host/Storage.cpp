@@ -0,0 +1,285 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <avr/eeprom.h>
+#include <avr/interrupt.h>
+#include "Host.h"
+#include "board/Board.h"
+#include "board/common/eeprom/Queue.h"
+#include "util/delay.h"
+
+///
+/// \ingroup boardHost
+/// @{
+
+//eeprom write queue. Random byte and word writes to small memory area are mixed with
+//reads and random passing of time. Every read needs to return last written value. Simulated
+//EEPROM contents are checked after each step as well: they always need to match contents
+//after some prefix of all writes, in order in which they've been made, so that writes are
+//never reordered even if power is lost. Reads must not wait for more than single byte
+//write for each read chunk, even though EEPROM ready ISR starts next write as soon as
+//EEPROM is done with previous one, and this is checked with full queue as well. Database
+//contents are overwritten, so this needs to run after other database benchmarks.
+
+///
+/// \brief Number of memory addresses used.
+///
+#define STORAGE_ADDRESSES       24
+
+///
+/// \brief Number of random operations.
+///
+#define STORAGE_OPERATIONS      20000
+
+///
+/// \brief Longest time in microseconds for which read of single chunk may wait.
+/// Only byte which is already being written needs to be waited for.
+///
+#define STORAGE_READ_WAIT_US    (HOST_EEPROM_WRITE_TIME_US+2*HOST_ATOMIC_TIME_US)
+
+///
+/// \brief Written bytes, in order in which they've been written.
+/// @{
+
+static uint16_t storageHistoryAddress[STORAGE_OPERATIONS*2];
+static uint8_t  storageHistoryValue[STORAGE_OPERATIONS*2];
+static uint32_t storageHistoryCount;
+
+/// @}
+
+///
+/// \brief Seed of pseudo-random numbers (see hostRandom).
+///
+static uint32_t storageSeed = 11;
+
+///
+/// \brief Longest time in microseconds for which read has waited.
+///
+static uint32_t storageReadWait_us;
+
+///
+/// \brief Reads single parameter and measures how long read has waited.
+/// \returns True if read has waited for longer than allowed, false otherwise.
+///
+static bool storageRead(uint16_t address, sectionParameterType_t type, int32_t &value)
+{
+    uint32_t start_us = hostTime_us();
+
+    Board::memoryRead(address, type, value);
+
+    uint32_t wait_us = hostTime_us() - start_us;
+
+    if (wait_us > storageReadWait_us)
+        storageReadWait_us = wait_us;
+
+    return (wait_us > STORAGE_READ_WAIT_US);
+}
+
+///
+/// \brief Reads first STORAGE_ADDRESSES bytes with bulk read and measures how long read has waited.
+/// \returns True if read has waited for longer than allowed, false otherwise.
+///
+static bool storageReadBlock(uint8_t *data)
+{
+    uint32_t start_us = hostTime_us();
+
+    Board::memoryReadBlock(0, data, STORAGE_ADDRESSES);
+
+    uint32_t wait_us = hostTime_us() - start_us;
+
+    if (wait_us > storageReadWait_us)
+        storageReadWait_us = wait_us;
+
+    return (wait_us > (uint32_t)STORAGE_READ_WAIT_US*((STORAGE_ADDRESSES+EEPROM_READ_CHUNK_SIZE-1)/EEPROM_READ_CHUNK_SIZE));
+}
+
+/// @}
+
+uint32_t hostStorageBenchmark()
+{
+    uint8_t expected[STORAGE_ADDRESSES];
+    uint8_t replay[STORAGE_ADDRESSES];
+    uint8_t raw[STORAGE_ADDRESSES];
+    uint32_t replayIndex = 0;
+    uint32_t reads = 0;
+    uint32_t readMismatches = 0;
+    uint32_t orderViolations = 0;
+    uint32_t slowReads = 0;
+    uint32_t writes = hostEEPROMwrites;
+    uint32_t start_us = hostTime_us();
+    uint8_t maxQueued = 0;
+
+    //let previous writes complete
+    while (!Board::memoryReady())
+        hostDelay_us(1000);
+
+    for (int i=0; i<STORAGE_ADDRESSES; i++)
+    {
+        expected[i] = eeprom_read_byte((const uint8_t*)(uintptr_t)i);
+        replay[i] = expected[i];
+    }
+
+    for (int i=0; i<STORAGE_OPERATIONS; i++)
+    {
+        uint8_t operation = hostRandom(storageSeed) % 8;
+
+        if (operation < 4)
+        {
+            uint16_t address = hostRandom(storageSeed) % STORAGE_ADDRESSES;
+            //small range of values so that some bytes already hold written value
+            uint8_t value = hostRandom(storageSeed) % 4;
+            bool disabled = !(hostRandom(storageSeed) % 16);
+
+            //writes are also made before interrupts are enabled
+            if (disabled)
+                cli();
+
+            Board::memoryWrite(address, value, BYTE_PARAMETER);
+
+            if (disabled)
+                sei();
+
+            expected[address] = value;
+            storageHistoryAddress[storageHistoryCount] = address;
+            storageHistoryValue[storageHistoryCount++] = value;
+        }
+        else if (operation < 6)
+        {
+            uint16_t address = hostRandom(storageSeed) % (STORAGE_ADDRESSES-1);
+            uint16_t value = hostRandom(storageSeed);
+
+            Board::memoryWrite(address, value, WORD_PARAMETER);
+
+            for (int j=0; j<2; j++)
+            {
+                expected[address+j] = value >> (8*j);
+                storageHistoryAddress[storageHistoryCount] = address+j;
+                storageHistoryValue[storageHistoryCount++] = value >> (8*j);
+            }
+        }
+        else if (operation == 6)
+        {
+            uint16_t address = hostRandom(storageSeed) % (STORAGE_ADDRESSES-1);
+            int32_t value;
+
+            if (storageRead(address, BYTE_PARAMETER, value))
+                slowReads++;
+
+            if (value != expected[address])
+                readMismatches++;
+
+            if (storageRead(address, WORD_PARAMETER, value))
+                slowReads++;
+
+            if (value != (expected[address] | (expected[address+1] << 8)))
+                readMismatches++;
+
+            reads += 2;
+        }
+        else
+        {
+            uint8_t data[STORAGE_ADDRESSES];
+
+            if (storageReadBlock(data))
+                slowReads++;
+
+            if (memcmp(data, expected, STORAGE_ADDRESSES))
+                readMismatches++;
+
+            reads++;
+        }
+
+        if (eepromQueueCount() > maxQueued)
+            maxQueued = eepromQueueCount();
+
+        //less than single byte write time passes at once
+        uint8_t steps = hostRandom(storageSeed) % 4;
+
+        for (int j=0; j<=steps; j++)
+        {
+            if (j)
+                hostDelay_us(1000);
+
+            for (int k=0; k<STORAGE_ADDRESSES; k++)
+                raw[k] = eeprom_read_byte((const uint8_t*)(uintptr_t)k);
+
+            while (memcmp(raw, replay, STORAGE_ADDRESSES) && (replayIndex < storageHistoryCount))
+            {
+                replay[storageHistoryAddress[replayIndex]] = storageHistoryValue[replayIndex];
+                replayIndex++;
+            }
+
+            if (memcmp(raw, replay, STORAGE_ADDRESSES))
+            {
+                orderViolations++;
+                memcpy(replay, raw, STORAGE_ADDRESSES);
+            }
+        }
+    }
+
+    while (!Board::memoryReady())
+        hostDelay_us(1000);
+
+    //fill queue, each write changes its byte, last address isn't written
+    for (int i=0; i<EEPROM_QUEUE_SIZE; i++)
+    {
+        uint16_t address = i % (STORAGE_ADDRESSES-1);
+
+        expected[address] ^= 0x80;
+        Board::memoryWrite(address, expected[address], BYTE_PARAMETER);
+    }
+
+    if (eepromQueueCount() > maxQueued)
+        maxQueued = eepromQueueCount();
+
+    {
+        int32_t value;
+
+        if (storageRead(STORAGE_ADDRESSES-2, WORD_PARAMETER, value))
+            slowReads++;
+
+        if (value != (expected[STORAGE_ADDRESSES-2] | (expected[STORAGE_ADDRESSES-1] << 8)))
+            readMismatches++;
+
+        reads++;
+    }
+
+    while (!Board::memoryReady())
+        hostDelay_us(1000);
+
+    for (int i=0; i<STORAGE_ADDRESSES; i++)
+    {
+        if (eeprom_read_byte((const uint8_t*)(uintptr_t)i) != expected[i])
+            readMismatches++;
+    }
+
+    fprintf(stderr, "eeprom queue: %u bytes written in %u ms, %u reads, max %u bytes queued, %u read mismatches, %u ordering violations\n",
+        hostEEPROMwrites - writes, (hostTime_us() - start_us)/1000, reads, maxQueued, readMismatches, orderViolations);
+    fprintf(stderr, "eeprom queue: reads waited max %u us, %u reads waited for more than single write per chunk\n", storageReadWait_us, slowReads);
+
+    return readMismatches + orderViolations + slowReads;
+}
@@ -0,0 +1,479 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "Host.h"
+#include "board/common/analog/Scan.h"
+#include "core/src/general/Misc.h"
+#include "interface/analog/pads/Config.h"
+#include "interface/analog/pads/Velocity.h"
+#include "interface/analog/pads/curves/Curves.h"
+
+///
+/// \ingroup boardHost
+/// @{
+
+//replay of pad strikes through both velocity engines (see velocityEngine_t).
+//Each strike is a sequence of pressure readings starting with first reading above press
+//threshold. Default engine ignores that reading and takes maximum of readings during next
+//STABLE_SAMPLE_TIME_US, after which note is held for PAD_NOTE_SEND_DELAY. Slope engine sends note as
+//soon as its estimate is stable. Latency of both and difference between their velocities
+//is reported.
+//Synthetic strikes model pressure as P*(1-e^(-t/tau)), where harder strikes rise faster,
+//sampled at adaptive scan rate. If ZVUK9_TRACE is set, strikes recorded in pad trace are
+//replayed as well, one reading per trace frame.
+//Release velocity is checked on synthetic lift-offs modelled as P*e^(-t/tau): with every
+//velocity curve, faster lift-off needs to result in same or higher release velocity, and
+//lift-offs of different speed need to result in different release velocities unless curve
+//maps all of them to zero.
+
+///
+/// \brief Number of synthetic strikes.
+///
+#define STRIKE_COUNT            2000
+
+///
+/// \brief Number of readings kept per strike.
+/// Covers STABLE_SAMPLE_TIME_US at scan rate with touched pad.
+///
+#define STRIKE_READINGS         32
+
+///
+/// \brief Velocity difference up to which slope engine is considered to match default engine.
+///
+#define STRIKE_VELOCITY_MATCH   3
+
+///
+/// \brief Number of lift-off speeds on which release velocity is checked.
+///
+#define STRIKE_RELEASE_SPEEDS   6
+
+///
+/// \brief Single strike as seen by velocity engines.
+///
+typedef struct
+{
+    uint16_t reading[STRIKE_READINGS];
+    double time_us[STRIKE_READINGS];
+    uint8_t count;
+} strike_t;
+
+///
+/// \brief Accumulated results of all strikes.
+///
+typedef struct
+{
+    uint32_t strikes;
+    uint32_t missed;
+    uint32_t late;
+    uint32_t matched;
+    double latency_us[2];
+    double maxLatency_us[2];
+    uint32_t velocityError;
+    uint8_t maxVelocityError;
+} strikeStats_t;
+
+///
+/// \brief Converts raw pressure the way board does (see Board::getPadPressure).
+///
+static uint16_t strikeNormalize(int32_t raw)
+{
+    raw = CONSTRAIN(raw, 0, PRESSURE_VALUES-1);
+
+    if (raw <= PAD_PRESS_PRESSURE)
+        return 0;
+
+    return raw - PAD_PRESS_PRESSURE;
+}
+
+///
+/// \brief Converts pressure into velocity with default calibration.
+///
+static uint8_t strikeVelocity(uint16_t pressure)
+{
+    if (!pressure)
+        return 0;
+
+    return curves.map(CONSTRAIN(pressure, 1, VELOCITY_127_RAW_PRESSURE), 1, VELOCITY_127_RAW_PRESSURE, 0, 127);
+}
+
+///
+/// \brief Converts pressure into velocity the way pads do (see Pads::getVelocity).
+///
+static uint8_t strikeVelocity(uint16_t pressure, curve_t curve)
+{
+    return curves.getCurveValue(curve, strikeVelocity(pressure), 0, 127);
+}
+
+///
+/// \brief Converts strike time into profiler timer ticks used by velocity engines.
+///
+static uint32_t strikeTicks(double time_us)
+{
+    return lround(time_us*PROFILER_TICKS_PER_US);
+}
+
+///
+/// \brief Runs default (maximum of samples) engine on strike.
+/// @param [out] index      Reading on which note has been triggered.
+/// @param [out] velocity   Note velocity.
+/// \returns True if note has been triggered.
+///
+static bool strikeRunMax(const strike_t &strike, uint8_t &index, uint8_t &velocity)
+{
+    velocitySamples_t samples;
+    uint16_t maxVal;
+
+    //first reading is ignored
+    velocitySampleStart(samples, strike.reading[0], strikeTicks(strike.time_us[0]));
+
+    for (index=1; index<strike.count; index++)
+    {
+        if (!velocityMaxUpdate(samples, strike.reading[index], strikeTicks(strike.time_us[index]), maxVal))
+            continue;
+
+        velocity = strikeVelocity(maxVal);
+
+        if (velocity)
+            return true;
+    }
+
+    return false;
+}
+
+///
+/// \brief Runs slope engine on strike.
+/// @param [out] index      Reading on which note has been triggered.
+/// @param [out] velocity   Note velocity.
+/// \returns True if note has been triggered.
+///
+static bool strikeRunSlope(const strike_t &strike, uint8_t &index, uint8_t &velocity)
+{
+    velocitySamples_t samples = {};
+    uint16_t estimate;
+
+    for (index=0; index<strike.count; index++)
+    {
+        if (!strike.reading[index])
+        {
+            samples.count = 0;
+            continue;
+        }
+
+        if (!velocitySlopeUpdate(samples, strike.reading[index], strikeTicks(strike.time_us[index]), estimate))
+            continue;
+
+        velocity = strikeVelocity(estimate);
+
+        if (velocity)
+            return true;
+    }
+
+    return false;
+}
+
+///
+/// \brief Runs both engines on strike and adds results to statistics.
+/// @param [in] start_us    Time at which pressure has crossed press threshold.
+///
+static void strikeEvaluate(const strike_t &strike, double start_us, strikeStats_t &stats)
+{
+    uint8_t maxIndex, slopeIndex;
+    uint8_t maxVelocity, slopeVelocity;
+
+    if (!strikeRunMax(strike, maxIndex, maxVelocity))
+        return;
+
+    stats.strikes++;
+
+    if (!strikeRunSlope(strike, slopeIndex, slopeVelocity))
+    {
+        stats.missed++;
+        return;
+    }
+
+    double latency_us[2] =
+    {
+        strike.time_us[maxIndex] - start_us + PAD_NOTE_SEND_DELAY*1000.0,
+        strike.time_us[slopeIndex] - start_us
+    };
+
+    if (slopeIndex > maxIndex)
+        stats.late++;
+
+    for (int i=0; i<2; i++)
+    {
+        stats.latency_us[i] += latency_us[i];
+
+        if (latency_us[i] > stats.maxLatency_us[i])
+            stats.maxLatency_us[i] = latency_us[i];
+    }
+
+    uint8_t error = abs(maxVelocity - slopeVelocity);
+
+    stats.velocityError += error;
+
+    if (error > stats.maxVelocityError)
+        stats.maxVelocityError = error;
+
+    if (error <= STRIKE_VELOCITY_MATCH)
+        stats.matched++;
+}
+
+///
+/// \brief Prints strike statistics.
+///
+static void strikeReport(const char *name, const strikeStats_t &stats)
+{
+    uint32_t notes = stats.strikes - stats.missed;
+
+    if (!notes)
+    {
+        fprintf(stderr, "%s strikes: none\n", name);
+        return;
+    }
+
+    fprintf(stderr, "%s strikes: %u, note on latency: max engine (%.1f ms window) avg %.0f us max %.0f us, slope avg %.0f us max %.0f us\n",
+        name, stats.strikes, STABLE_SAMPLE_TIME_US/1000.0,
+        stats.latency_us[0]/notes, stats.maxLatency_us[0], stats.latency_us[1]/notes, stats.maxLatency_us[1]);
+
+    fprintf(stderr, "%s strikes: slope velocity error avg %.2f max %u, %.1f%% within %d, %u missed, %u late\n",
+        name, (double)stats.velocityError/notes, stats.maxVelocityError, 100.0*stats.matched/notes,
+        STRIKE_VELOCITY_MATCH, stats.missed, stats.late);
+}
+
+///
+/// \brief Returns duration of single adaptive scan in microseconds.
+/// @param [in] touched     Pads which are touched.
+///
+static double strikeScanTime_us(uint16_t touched)
+{
+    padTouched = touched;
+    padScanPlan();
+
+    return (double)padScanConversions()*HOST_ADC_CONVERSION_TIME_US;
+}
+
+///
+/// \brief Replays synthetic strikes.
+///
+static void strikeSynthetic(strikeStats_t &stats)
+{
+    uint16_t touched = padTouched;
+    double idle_us = strikeScanTime_us(0);
+    double active_us = strikeScanTime_us(1);
+    uint32_t seed = 1;
+
+    padTouched = touched;
+    padScanPlan();
+
+    for (int i=0; i<STRIKE_COUNT; i++)
+    {
+        strike_t strike;
+
+        double peak = 60 + (hostRandom(seed) % 1041);
+        double jitter = 0.7 + 0.6*(hostRandom(seed) % 1000)/1000.0;
+        double phase_us = idle_us*(hostRandom(seed) % 1000)/1000.0;
+
+        //rise time constant in microseconds, between 0.5ms (hardest) and 5ms (softest)
+        double tau_us = (500 + 4500*(1100 - peak)/1040) * jitter;
+        double start_us = -tau_us * log(1 - PAD_PRESS_PRESSURE/peak);
+        double time_us = phase_us;
+
+        //idle scans until pressure is seen
+        while (peak*(1 - exp(-time_us/tau_us)) <= PAD_PRESS_PRESSURE)
+            time_us += idle_us;
+
+        for (strike.count=0; strike.count<STRIKE_READINGS; strike.count++)
+        {
+            int32_t noise = (int32_t)(hostRandom(seed) % 5) - 2;
+
+            strike.time_us[strike.count] = time_us;
+            strike.reading[strike.count] = strikeNormalize(lround(peak*(1 - exp(-time_us/tau_us))) + noise);
+            time_us += active_us;
+        }
+
+        strikeEvaluate(strike, start_us, stats);
+    }
+
+    fprintf(stderr, "synthetic strikes: scan %.0f us idle, %.0f us with touched pad\n", idle_us, active_us);
+}
+
+///
+/// \brief Replays strikes recorded in pad trace (ZVUK9_TRACE).
+///
+static void strikeRecorded(strikeStats_t &stats)
+{
+    strike_t strike[NUMBER_OF_PADS];
+    bool active[NUMBER_OF_PADS] = { false };
+    bool released[NUMBER_OF_PADS];
+    padData_t frame;
+    double time_us = 0;
+
+    for (int i=0; i<NUMBER_OF_PADS; i++)
+        released[i] = true;
+
+    hostTraceInit();
+
+    while (hostTraceFrame(frame))
+    {
+        for (int i=0; i<NUMBER_OF_PADS; i++)
+        {
+            uint16_t reading = strikeNormalize(frame.zReading[i]);
+
+            if (!active[i] && reading && released[i])
+            {
+                active[i] = true;
+                strike[i].count = 0;
+            }
+
+            released[i] = !reading;
+
+            if (!active[i])
+                continue;
+
+            strike[i].reading[strike[i].count] = reading;
+            strike[i].time_us[strike[i].count] = time_us;
+            strike[i].count++;
+
+            if (!reading || (strike[i].count == STRIKE_READINGS))
+            {
+                //pressure has been crossed somewhere during scan before first reading
+                strikeEvaluate(strike[i], strike[i].time_us[0] - hostTraceFramePeriod_us(), stats);
+                active[i] = false;
+            }
+        }
+
+        time_us += hostTraceFramePeriod_us();
+    }
+
+    for (int i=0; i<NUMBER_OF_PADS; i++)
+    {
+        if (active[i])
+            strikeEvaluate(strike[i], strike[i].time_us[0] - hostTraceFramePeriod_us(), stats);
+    }
+}
+
+///
+/// \brief Runs release detection on lift-off from constant pressure.
+/// @param [in] peak        Raw pressure before lift-off.
+/// @param [in] tau_us      Decay time constant in microseconds.
+/// @param [in] scan_us     Time between two readings in microseconds.
+/// \returns Largest pressure drop between two readings, from which release velocity is taken.
+///
+static uint16_t strikeReleaseDrop(double peak, double tau_us, double scan_us)
+{
+    velocityRelease_t state;
+    uint16_t reading = strikeNormalize(lround(peak));
+
+    velocityReleaseStart(state, reading);
+
+    //pad is released either on decay or once pressure reaches zero
+    for (double time_us=scan_us; reading; time_us+=scan_us)
+    {
+        reading = strikeNormalize(lround(peak*exp(-time_us/tau_us)));
+
+        if (velocityReleaseUpdate(state, reading))
+            break;
+    }
+
+    return state.drop;
+}
+
+///
+/// \brief Checks release velocity on lift-offs of different speed with all velocity curves.
+/// \returns Number of failed checks.
+///
+static uint32_t strikeRelease()
+{
+    const double peak[] = { 250, 600, 1000 };
+    const double tau_ms[STRIKE_RELEASE_SPEEDS] = { 1, 2, 4, 8, 16, 32 };
+    const curve_t curve[] = { curve_linear_up, curve_log_up_1, curve_exp_up };
+    uint16_t touched = padTouched;
+    double scan_us = strikeScanTime_us(1);
+    uint32_t failed = 0;
+
+    padTouched = touched;
+    padScanPlan();
+    curves.init();
+
+    for (size_t i=0; i<sizeof(peak)/sizeof(peak[0]); i++)
+    {
+        for (size_t j=0; j<sizeof(curve)/sizeof(curve[0]); j++)
+        {
+            uint8_t velocity[STRIKE_RELEASE_SPEEDS];
+
+            for (int k=0; k<STRIKE_RELEASE_SPEEDS; k++)
+            {
+                velocity[k] = strikeVelocity(strikeReleaseDrop(peak[i], tau_ms[k]*1000.0, scan_us), curve[j]);
+
+                //slower lift-off can't be released faster
+                if (k && (velocity[k] > velocity[k-1]))
+                    failed++;
+            }
+
+            //curve can map soft lift-offs to zero, as it does with soft strikes
+            if (velocity[0] && (velocity[0] == velocity[STRIKE_RELEASE_SPEEDS-1]))
+                failed++;
+
+            if (curve[j] != curve_linear_up)
+                continue;
+
+            fprintf(stderr, "release velocity, peak %.0f:", peak[i]);
+
+            for (int k=0; k<STRIKE_RELEASE_SPEEDS; k++)
+                fprintf(stderr, " tau %.0fms %u%s", tau_ms[k], velocity[k], (k == STRIKE_RELEASE_SPEEDS-1) ? "\n" : ",");
+        }
+    }
+
+    fprintf(stderr, "release velocity: %u failed checks\n", failed);
+
+    return failed;
+}
+
+/// @}
+
+uint32_t hostStrikeBenchmark()
+{
+    strikeStats_t stats = {};
+    uint32_t failed = strikeRelease();
+
+    strikeSynthetic(stats);
+    strikeReport("synthetic", stats);
+
+    if (getenv("ZVUK9_TRACE") != NULL)
+    {
+        strikeStats_t recorded = {};
+
+        strikeRecorded(recorded);
+        strikeReport("recorded", recorded);
+        stats.missed += recorded.missed;
+        stats.late += recorded.late;
+    }
+
+    return stats.missed + stats.late + failed;
+}
@@ -0,0 +1,479 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "Host.h"
+#include "board/common/analog/Scan.h"
+#include "core/src/general/Misc.h"
+#include "database/blocks/Program.h"
+#include "interface/analog/pads/Config.h"
+#include "interface/analog/pads/Filter.h"
+#include "interface/analog/pads/HighRes.h"
+#include "interface/analog/pads/curves/Curves.h"
+
+///
+/// \ingroup boardHost
+/// @{
+
+//replay of X/Y gestures through previous X/Y debounce (any change sent within
+//SWIPE_DEBOUNCE_TIMEOUT ms after last sent value, change larger than SWIPE_DEBOUNCE_STEP
+//needed after that), through adaptive X/Y filter (see Filter.h) with default program
+//parameters and through the same filter with 14-bit CC output (see HighRes.h). Number of
+//CC messages is counted for all, along with average difference between last sent value
+//and noise-free value (in 7-bit CC steps), separately while finger rests and while it
+//moves (lag), and average and largest single change of sent value while finger moves
+//(audible step).
+//If ZVUK9_TRACE is set, X and Y readings of pressed pads in pad trace are replayed as
+//well, with unfiltered readings taken as noise-free values.
+
+///
+/// \brief Previous X/Y debounce parameters.
+/// @{
+
+#define SWIPE_DEBOUNCE_TIMEOUT  5
+#define SWIPE_DEBOUNCE_STEP     3
+
+/// @}
+
+///
+/// \brief Raw X/Y range scaled to full CC range (see XY_RAW_VALUE_CHECK).
+/// @{
+
+#define SWIPE_RAW_MIN           85
+#define SWIPE_RAW_MAX           950
+
+/// @}
+
+///
+/// \brief Number of repetitions of each synthetic gesture (with different noise).
+///
+#define SWIPE_REPEATS           20
+
+///
+/// \brief Value of last sent CC before first value has been sent.
+///
+#define SWIPE_UNSENT            0xFFFF
+
+///
+/// \brief List of replayed X/Y processing methods.
+///
+typedef enum
+{
+    swipeDebounce,
+    swipeFilter,
+    swipeFilter14b,
+    SWIPE_METHODS
+} swipeMethod_t;
+
+///
+/// \brief Replay state of single gesture on one coordinate for single method.
+///
+typedef struct
+{
+    xyFilter_t filter;
+    uint16_t last;
+    uint8_t lsb;
+    uint32_t sendTime_ms;
+    uint32_t lsbTime_ms;
+    uint32_t readings;
+} swipeState_t;
+
+///
+/// \brief Synthetic gesture on one coordinate.
+/// Finger rests at start position, moves linearly to end position in specified number
+/// of readings and rests again. Readings are generated as gesture is replayed.
+///
+typedef struct
+{
+    uint16_t start;
+    uint16_t end;
+    uint16_t rest;
+    uint16_t move;
+    uint8_t noise;
+} swipeGesture_t;
+
+///
+/// \brief Accumulated results of all gestures for single method.
+///
+typedef struct
+{
+    uint32_t messages;
+    uint32_t readings[2];
+    double error[2];
+    double step;
+    double stepSum;
+    uint32_t steps;
+    uint32_t unsettled;
+} swipeStats_t;
+
+///
+/// \brief Converts raw reading into CC value with full pad range.
+///
+static uint8_t swipeScale(uint16_t raw)
+{
+    return curves.map(CONSTRAIN(raw, SWIPE_RAW_MIN, SWIPE_RAW_MAX), SWIPE_RAW_MIN, SWIPE_RAW_MAX, 0, 127);
+}
+
+///
+/// \brief Converts filtered reading (with fraction bits) into 14-bit CC value with full pad range.
+/// Linear curve is used, same as in firmware with default program.
+///
+static uint16_t swipeScale14b(uint16_t value)
+{
+    uint16_t position = curves.map(CONSTRAIN(value, SWIPE_RAW_MIN << XY_FILTER_FRACTION_BITS, SWIPE_RAW_MAX << XY_FILTER_FRACTION_BITS), SWIPE_RAW_MIN << XY_FILTER_FRACTION_BITS, SWIPE_RAW_MAX << XY_FILTER_FRACTION_BITS, 0, CURVE_POSITION_MAX);
+
+    return curves.getCurveValue14b(curve_linear_up, position, 0, 127);
+}
+
+///
+/// \brief Converts noise-free position into exact CC value with full pad range (in 7-bit CC steps).
+///
+static double swipeTarget(double position)
+{
+    return 127.0*(CONSTRAIN(position, SWIPE_RAW_MIN, SWIPE_RAW_MAX) - SWIPE_RAW_MIN)/(SWIPE_RAW_MAX - SWIPE_RAW_MIN);
+}
+
+///
+/// \brief Starts replay of gesture.
+///
+static void swipeStart(swipeState_t &state)
+{
+    //filter is restarted on first reading, keep it defined for methods which don't use it
+    xyFilterReset(state.filter, 0, 0);
+    state.last = SWIPE_UNSENT;
+    state.lsb = 0;
+    state.sendTime_ms = 0;
+    state.lsbTime_ms = 0;
+    state.readings = 0;
+}
+
+///
+/// \brief Replays single reading of gesture with specified method.
+/// @param [in] raw         Raw reading.
+/// @param [in] target      Noise-free value of reading (in 7-bit CC steps).
+/// @param [in] time_us     Time of reading since start of gesture.
+/// @param [in] moving      Set if finger moves (or movement hasn't settled yet).
+///
+static void swipeStep(swipeState_t &state, swipeMethod_t method, uint16_t raw, double target, double time_us, bool moving, swipeStats_t &stats)
+{
+    uint32_t time_ms = time_us/1000;
+    uint32_t ticks = lround(time_us*PROFILER_TICKS_PER_US);
+    bool send = false;
+    uint16_t value;
+
+    if (method == swipeDebounce)
+    {
+        value = swipeScale(raw);
+
+        if ((time_ms - state.sendTime_ms) > SWIPE_DEBOUNCE_TIMEOUT)
+            send = (abs(value - state.last) > SWIPE_DEBOUNCE_STEP);
+        else
+            send = (value != state.last);
+
+        stats.messages += send;
+    }
+    else
+    {
+        if (!state.readings)
+            xyFilterReset(state.filter, raw, ticks);
+
+        uint16_t filtered = xyFilterUpdate(state.filter, raw, ticks, EXTENDED_PROGRAM_SETTING_XY_FILTER_CUTOFF, EXTENDED_PROGRAM_SETTING_XY_FILTER_BETA);
+
+        if (method == swipeFilter)
+        {
+            value = swipeScale(filtered);
+            send = (value != state.last) && xyFilterMoved(state.filter, filtered);
+            stats.messages += send;
+        }
+        else
+        {
+            value = swipeScale14b(state.filter.value);
+            filtered = state.filter.value;
+
+            uint8_t parts = cc14bitCheck(value, (state.last == SWIPE_UNSENT) ? 0xFF : (state.last >> 7), state.lsb, time_ms - state.lsbTime_ms);
+
+            send = parts && xyFilterMoved(state.filter, filtered, XY_FILTER_HYSTERESIS_14B);
+
+            if (send)
+            {
+                if (parts & CC_14BIT_SEND_MSB)
+                {
+                    state.lsb = 0;
+                    stats.messages++;
+                }
+
+                if (parts & CC_14BIT_SEND_LSB)
+                {
+                    state.lsb = value & 0x7F;
+                    state.lsbTime_ms = time_ms;
+                    stats.messages++;
+                }
+
+                //value as known to receiver
+                value = (value & ~0x7F) | state.lsb;
+            }
+        }
+
+        if (send)
+            state.filter.sent = filtered;
+    }
+
+    if (send)
+    {
+        if (moving && (state.last != SWIPE_UNSENT))
+        {
+            double step = (method == swipeFilter14b) ? fabs((double)value - state.last)*127/16383 : abs(value - state.last);
+
+            if (step > stats.step)
+                stats.step = step;
+
+            stats.stepSum += step;
+            stats.steps++;
+        }
+
+        state.last = value;
+        state.sendTime_ms = time_ms;
+    }
+
+    double sent = (method == swipeFilter14b) ? (double)state.last*127/16383 : state.last;
+
+    stats.readings[moving]++;
+    stats.error[moving] += fabs(sent - target);
+    state.readings++;
+}
+
+///
+/// \brief Ends replay of gesture.
+/// Last sent value needs to be within one CC step from where finger rests.
+/// @param [in] target      Noise-free value of last reading (in 7-bit CC steps).
+///
+static void swipeEnd(const swipeState_t &state, swipeMethod_t method, double target, swipeStats_t &stats)
+{
+    if (!state.readings)
+        return;
+
+    double sent = (method == swipeFilter14b) ? (double)state.last*127/16383 : state.last;
+
+    if ((state.last == SWIPE_UNSENT) || (fabs(sent - target) > 1))
+        stats.unsettled++;
+}
+
+///
+/// \brief Generates reading of synthetic gesture.
+/// @param [in] index       Reading index.
+/// @param [in,out] seed    Seed of noise added to raw reading.
+/// @param [out] raw        Raw reading.
+/// \returns Noise-free value of reading (in 7-bit CC steps).
+///
+static double swipeReading(const swipeGesture_t &gesture, uint16_t index, uint32_t &seed, uint16_t &raw)
+{
+    double position;
+
+    if (index < gesture.rest)
+        position = gesture.start;
+    else if (index < (gesture.rest + gesture.move))
+        position = gesture.start + ((double)gesture.end - gesture.start)*(index - gesture.rest)/gesture.move;
+    else
+        position = gesture.end;
+
+    int16_t offset = (int16_t)(hostRandom(seed) % (2*gesture.noise + 1)) - gesture.noise;
+
+    raw = CONSTRAIN((int16_t)(position + 0.5) + offset, 0, 1023);
+    return swipeTarget(position);
+}
+
+///
+/// \brief Prints results of all methods.
+///
+static void swipeReport(const char *name, const swipeStats_t *stats, uint32_t gestures)
+{
+    static const char *methodName[SWIPE_METHODS] = { "debounce", "filter", "filter 14-bit" };
+    static const char *errorName[2] = { "resting", "moving" };
+
+    for (int i=0; i<SWIPE_METHODS; i++)
+    {
+        fprintf(stderr, "%s swipes (%s): %u gestures, %.1f CC messages per gesture", name, methodName[i], gestures, (double)stats[i].messages/gestures);
+
+        for (int j=0; j<2; j++)
+        {
+            if (stats[i].readings[j])
+                fprintf(stderr, ", %s error %.2f", errorName[j], stats[i].error[j]/stats[i].readings[j]);
+        }
+
+        if (stats[i].steps)
+            fprintf(stderr, ", step avg %.2f max %.2f", stats[i].stepSum/stats[i].steps, stats[i].step);
+
+        fprintf(stderr, ", %u unsettled\n", stats[i].unsettled);
+    }
+}
+
+///
+/// \brief Replays synthetic gestures.
+/// @param [in] move_us     Duration of movement across the pad.
+/// \returns Number of gestures on which filtered value hasn't settled, increased by one if
+/// filter sends more CC messages than previous debounce.
+///
+static uint32_t swipeSynthetic(const char *name, uint16_t start, uint16_t end, double move_us, double period_us)
+{
+    swipeStats_t stats[SWIPE_METHODS] = {};
+    swipeGesture_t gesture = { start, end, (uint16_t)(100000/period_us), (uint16_t)(move_us/period_us), 4 };
+    uint16_t count = gesture.rest*2 + gesture.move;
+    //lag is measured until movement has settled
+    uint16_t settled = gesture.rest + gesture.move + gesture.move/2;
+    uint32_t seed = 1;
+
+    for (int i=0; i<SWIPE_REPEATS; i++)
+    {
+        swipeState_t state[SWIPE_METHODS];
+        double target = 0;
+
+        for (int j=0; j<SWIPE_METHODS; j++)
+            swipeStart(state[j]);
+
+        for (uint16_t k=0; k<count; k++)
+        {
+            uint16_t raw;
+            bool moving = (k >= gesture.rest) && (k < settled);
+
+            target = swipeReading(gesture, k, seed, raw);
+
+            for (int j=0; j<SWIPE_METHODS; j++)
+                swipeStep(state[j], (swipeMethod_t)j, raw, target, k*period_us, moving, stats[j]);
+        }
+
+        for (int j=0; j<SWIPE_METHODS; j++)
+            swipeEnd(state[j], (swipeMethod_t)j, target, stats[j]);
+    }
+
+    swipeReport(name, stats, SWIPE_REPEATS);
+
+    //previous debounce may legitimately stop up to SWIPE_DEBOUNCE_STEP away
+    uint32_t failed = stats[swipeFilter].unsettled + stats[swipeFilter14b].unsettled;
+
+    if (stats[swipeFilter].messages > stats[swipeDebounce].messages)
+        failed++;
+
+    return failed;
+}
+
+///
+/// \brief Replays X and Y readings of pressed pads recorded in pad trace (ZVUK9_TRACE).
+/// Each pressed pad is replayed while trace is read, whole gesture is considered movement.
+///
+static void swipeRecorded()
+{
+    swipeState_t state[NUMBER_OF_PADS][2][SWIPE_METHODS];
+    swipeStats_t stats[SWIPE_METHODS] = {};
+    bool active[NUMBER_OF_PADS] = { false };
+    uint16_t last[NUMBER_OF_PADS][2];
+    uint32_t gestures = 0;
+    padData_t frame;
+
+    hostTraceInit();
+
+    while (true)
+    {
+        bool available = hostTraceFrame(frame);
+
+        for (int i=0; i<NUMBER_OF_PADS; i++)
+        {
+            if (!available || (frame.zReading[i] <= PAD_PRESS_PRESSURE))
+            {
+                if (active[i])
+                {
+                    for (int j=0; j<2; j++)
+                    {
+                        for (int k=0; k<SWIPE_METHODS; k++)
+                            swipeEnd(state[i][j][k], (swipeMethod_t)k, swipeTarget(last[i][j]), stats[k]);
+                    }
+                }
+
+                active[i] = false;
+                continue;
+            }
+
+            if (!active[i])
+            {
+                active[i] = true;
+                gestures += 2;
+
+                for (int j=0; j<2; j++)
+                {
+                    for (int k=0; k<SWIPE_METHODS; k++)
+                        swipeStart(state[i][j][k]);
+                }
+            }
+
+            uint16_t raw[2] = { (uint16_t)(1023 - frame.xReading[i]), frame.yReading[i] };
+
+            for (int j=0; j<2; j++)
+            {
+                for (int k=0; k<SWIPE_METHODS; k++)
+                    swipeStep(state[i][j][k], (swipeMethod_t)k, raw[j], swipeTarget(raw[j]), state[i][j][k].readings*hostTraceFramePeriod_us(), true, stats[k]);
+
+                last[i][j] = raw[j];
+            }
+        }
+
+        if (!available)
+            break;
+    }
+
+    if (gestures)
+        swipeReport("recorded", stats, gestures);
+}
+
+/// @}
+
+uint32_t hostSwipeBenchmark()
+{
+    //curve limits are needed for 14-bit output
+    curves.init();
+
+    uint16_t touched = padTouched;
+
+    padTouched = 1;
+    padScanPlan();
+
+    double period_us = (double)padScanConversions()*HOST_ADC_CONVERSION_TIME_US;
+
+    padTouched = touched;
+    padScanPlan();
+
+    uint32_t failed = 0;
+
+    failed += swipeSynthetic("resting", 500, 500, 0, period_us);
+    failed += swipeSynthetic("slow", 200, 800, 1000000, period_us);
+    failed += swipeSynthetic("fast", 200, 800, 50000, period_us);
+    failed += swipeSynthetic("flick", 200, 800, 15000, period_us);
+
+    //recorded readings are noisy, so they're only reported
+    if (getenv("ZVUK9_TRACE") != NULL)
+        swipeRecorded();
+
+    return failed;
+}
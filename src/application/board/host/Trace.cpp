@@ -0,0 +1,147 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Host.h"
+
+///
+/// \ingroup boardHost
+/// @{
+
+//pad trace is a plain text file with one recorded pad scan per line.
+//each line contains z, x and y raw readings for all pads in pad order:
+//     <z0> <x0> <y0> <z1> <x1> <y1> ... <z8> <x8> <y8>
+//empty lines and lines starting with # are ignored. Lines are applied to pad readings
+//once per HOST_ADC_FRAME_TIME_US (duration of full scan) and simulated scans sample
+//them at their own pace. ZVUK9_TRACE_SPEED multiplies both rates to replay traces
+//faster than real time.
+
+///
+/// \brief Maximum length of single trace line.
+///
+#define TRACE_LINE_SIZE         512
+
+static FILE         *trace;
+static char         traceLine[TRACE_LINE_SIZE];
+static uint32_t     traceLineNumber;
+static uint32_t     traceFramePeriod_us = HOST_ADC_FRAME_TIME_US;
+static uint32_t     traceSpeed = 1;
+
+/// @}
+
+void hostTraceInit()
+{
+    const char *path = getenv("ZVUK9_TRACE");
+
+    if (path == NULL)
+        return;
+
+    trace = fopen(path, "r");
+
+    if (trace == NULL)
+    {
+        fprintf(stderr, "Unable to open trace %s\n", path);
+        exit(1);
+    }
+
+    const char *speed = getenv("ZVUK9_TRACE_SPEED");
+    uint32_t speedFactor = (speed != NULL) ? strtoul(speed, NULL, 10) : 1;
+
+    if (speedFactor > 1)
+    {
+        traceSpeed = speedFactor;
+        traceFramePeriod_us = HOST_ADC_FRAME_TIME_US / speedFactor;
+    }
+
+    if (!traceFramePeriod_us)
+        traceFramePeriod_us = 1;
+}
+
+bool hostTraceActive()
+{
+    return trace != NULL;
+}
+
+bool hostTraceFrame(padData_t &frame)
+{
+    while ((trace != NULL) && (fgets(traceLine, TRACE_LINE_SIZE, trace) != NULL))
+    {
+        traceLineNumber++;
+
+        char *start = traceLine + strspn(traceLine, " \t");
+
+        if ((*start == '#') || (*start == '\n') || (*start == '\r') || (*start == '\0'))
+            continue;
+
+        int16_t reading[NUMBER_OF_PADS*3];
+        int values = 0;
+
+        for (values=0; values<NUMBER_OF_PADS*3; values++)
+        {
+            char *end;
+            reading[values] = strtol(start, &end, 10);
+
+            if (end == start)
+                break;
+
+            start = end;
+        }
+
+        if (values != NUMBER_OF_PADS*3)
+        {
+            fprintf(stderr, "Trace line %u: expected %d readings, found %d\n", traceLineNumber, NUMBER_OF_PADS*3, values);
+            continue;
+        }
+
+        for (int i=0; i<NUMBER_OF_PADS; i++)
+        {
+            frame.zReading[i] = reading[i*3+0];
+            frame.xReading[i] = reading[i*3+1];
+            frame.yReading[i] = reading[i*3+2];
+        }
+
+        return true;
+    }
+
+    if (trace != NULL)
+    {
+        fclose(trace);
+        trace = NULL;
+    }
+
+    return false;
+}
+
+uint32_t hostTraceFramePeriod_us()
+{
+    return traceFramePeriod_us;
+}
+
+uint32_t hostTraceSpeed()
+{
+    return traceSpeed;
+}
@@ -0,0 +1,71 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#pragma once
+
+#include <inttypes.h>
+#include <stddef.h>
+
+///
+/// \ingroup boardHost
+/// @{
+
+///
+/// \brief Stand-ins for avr-libc EEPROM routines.
+/// Implemented on top of simulated EEPROM array.
+/// @{
+
+///
+/// \brief Simulated EEPROM is busy while byte is being written.
+/// Waiting advances simulated time (see hostEEPROMwait in Host.h).
+/// @{
+
+bool hostEEPROMready();
+void hostEEPROMwait();
+
+#define eeprom_is_ready()   hostEEPROMready()
+#define eeprom_busy_wait()  hostEEPROMwait()
+
+/// @}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint8_t eeprom_read_byte(const uint8_t *address);
+uint16_t eeprom_read_word(const uint16_t *address);
+uint32_t eeprom_read_dword(const uint32_t *address);
+void eeprom_read_block(void *data, const void *address, size_t size);
+void eeprom_update_byte(uint8_t *address, uint8_t value);
+void eeprom_update_word(uint16_t *address, uint16_t value);
+void eeprom_update_dword(uint32_t *address, uint32_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+/// @}
+
+/// @}
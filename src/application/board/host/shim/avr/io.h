@@ -0,0 +1,201 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#pragma once
+
+#include <inttypes.h>
+#include <stdlib.h>
+
+///
+/// \ingroup boardHost
+/// @{
+
+///
+/// \brief Stand-ins for at90usb1286 I/O registers.
+/// Registers are plain RAM variables on host. Values which AVR hardware sets on its own
+/// (SPI transfer complete, UART data register empty) are preset once so that
+/// polling loops in HAL code never block.
+/// @{
+
+///
+/// \brief Port registers keep AVR layout (PINx, DDRx, PORTx placed consecutively)
+/// since pin manipulation code derives DDRx and PINx addresses from PORTx.
+/// @{
+
+#define HOST_NUMBER_OF_PORTS    6
+
+extern volatile uint8_t hostPortRegisters[HOST_NUMBER_OF_PORTS][3];
+
+#define PINA    hostPortRegisters[0][0]
+#define DDRA    hostPortRegisters[0][1]
+#define PORTA   hostPortRegisters[0][2]
+#define PINB    hostPortRegisters[1][0]
+#define DDRB    hostPortRegisters[1][1]
+#define PORTB   hostPortRegisters[1][2]
+#define PINC    hostPortRegisters[2][0]
+#define DDRC    hostPortRegisters[2][1]
+#define PORTC   hostPortRegisters[2][2]
+#define PIND    hostPortRegisters[3][0]
+#define DDRD    hostPortRegisters[3][1]
+#define PORTD   hostPortRegisters[3][2]
+#define PINE    hostPortRegisters[4][0]
+#define DDRE    hostPortRegisters[4][1]
+#define PORTE   hostPortRegisters[4][2]
+#define PINF    hostPortRegisters[5][0]
+#define DDRF    hostPortRegisters[5][1]
+#define PORTF   hostPortRegisters[5][2]
+
+/// @}
+
+#define HOST_REGISTERS_8(REG) \
+REG(MCUSR) REG(MCUCR) REG(SREG) REG(WDTCSR) \
+REG(TCCR0A) REG(TCCR0B) REG(TCNT0) REG(TIMSK0) REG(TIFR0) REG(OCR0A) REG(OCR0B) \
+REG(TCCR1A) REG(TCCR1B) REG(TCCR1C) REG(TIMSK1) \
+REG(TCCR2A) REG(TCCR2B) REG(TCNT2) REG(TIMSK2) REG(OCR2A) REG(OCR2B) \
+REG(TCCR3A) REG(TCCR3B) REG(TCCR3C) REG(TIMSK3) \
+REG(ADMUX) REG(ADCSRA) REG(ADCSRB) REG(DIDR0) \
+REG(SPCR) REG(SPSR) REG(SPDR) \
+REG(UCSR1A) REG(UCSR1B) REG(UCSR1C) REG(UDR1) \
+REG(EECR) REG(EEDR)
+
+#define HOST_REGISTERS_16(REG) \
+REG(TCNT1) REG(OCR1A) REG(OCR1B) REG(OCR1C) \
+REG(TCNT3) REG(OCR3A) REG(OCR3B) REG(OCR3C) \
+REG(ADC) REG(ADCW) REG(UBRR1) REG(EEAR)
+
+#define HOST_DECLARE_REGISTER_8(name)   extern volatile uint8_t name;
+#define HOST_DECLARE_REGISTER_16(name)  extern volatile uint16_t name;
+
+HOST_REGISTERS_8(HOST_DECLARE_REGISTER_8)
+HOST_REGISTERS_16(HOST_DECLARE_REGISTER_16)
+
+/// @}
+
+///
+/// \brief Register bit positions used by application and HAL code.
+/// @{
+
+#define _BV(bit)    (1 << (bit))
+
+//MCUSR
+#define WDRF        3
+
+//timers
+#define CS00        0
+#define CS01        1
+#define CS02        2
+#define WGM00       0
+#define WGM01       1
+#define TOIE0       0
+#define OCIE0A      1
+#define TOV0        0
+#define OCF0A       1
+#define CS10        0
+#define CS11        1
+#define CS12        2
+#define WGM10       0
+#define WGM11       1
+#define WGM12       3
+#define WGM13       4
+#define COM1A1      7
+#define COM1B1      5
+#define COM1C1      3
+#define CS20        0
+#define CS21        1
+#define CS22        2
+#define WGM20       0
+#define WGM21       1
+#define COM2A1      7
+#define COM2B1      5
+#define CS30        0
+#define CS31        1
+#define CS32        2
+#define WGM32       3
+#define OCIE3A      1
+
+//adc
+#define MUX0        0
+#define MUX1        1
+#define MUX2        2
+#define MUX3        3
+#define MUX4        4
+#define ADLAR       5
+#define REFS0       6
+#define REFS1       7
+#define ADPS0       0
+#define ADPS1       1
+#define ADPS2       2
+#define ADIE        3
+#define ADIF        4
+#define ADATE       5
+#define ADSC        6
+#define ADEN        7
+#define MUX5        5
+
+//spi
+#define SPR0        0
+#define SPR1        1
+#define CPHA        2
+#define CPOL        3
+#define MSTR        4
+#define DORD        5
+#define SPE         6
+#define SPIE        7
+#define SPI2X       0
+#define WCOL        6
+#define SPIF        7
+
+//uart
+#define MPCM1       0
+#define U2X1        1
+#define UPE1        2
+#define DOR1        3
+#define FE1         4
+#define UDRE1       5
+#define TXC1        6
+#define RXC1        7
+#define TXB81       0
+#define RXB81       1
+#define UCSZ12      2
+#define TXEN1       3
+#define RXEN1       4
+#define UDRIE1      5
+#define TXCIE1      6
+#define RXCIE1      7
+#define UCSZ10      1
+#define UCSZ11      2
+
+//status register
+#define SREG_I      7
+
+//eeprom
+#define EERE        0
+#define EEPE        1
+#define EEMPE       2
+#define EERIE       3
+
+/// @}
+
+/// @}
@@ -0,0 +1,66 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#pragma once
+
+#include <inttypes.h>
+#include <string.h>
+#include <stdio.h>
+
+///
+/// \ingroup boardHost
+/// @{
+
+///
+/// \brief Host has single address space so program memory accessors
+/// map to regular memory accesses.
+/// @{
+
+#define PROGMEM
+#define PGM_P                       const char*
+#define PSTR(s)                     (s)
+
+#define pgm_read_byte(address)      (*(const uint8_t*)(address))
+#define pgm_read_dword(address)     (*(const uint32_t*)(address))
+#define pgm_read_ptr(address)       (*(void* const*)(address))
+
+///
+/// \brief Word reads are used on string pointer tables.
+/// Pointers are wider than 16 bits on host so value is read with its full type.
+///
+#define pgm_read_word(address)      (*(address))
+
+#define memcpy_P                    memcpy
+#define strcpy_P                    strcpy
+#define strncpy_P                   strncpy
+#define strlen_P                    strlen
+#define strcmp_P                    strcmp
+#define printf_P                    printf
+#define sprintf_P                   sprintf
+#define snprintf_P                  snprintf
+
+/// @}
+
+/// @}
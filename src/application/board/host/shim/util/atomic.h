@@ -0,0 +1,63 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#pragma once
+
+///
+/// \ingroup boardHost
+/// @{
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+///
+/// \brief Lets simulated time pass before entering atomic block.
+/// Atomic blocks guard data shared with ISRs, so entry to one is the point at which
+/// firmware observes interrupts. Advancing time here allows firmware code which polls
+/// run time or ISR data in a loop to make progress on host.
+///
+void hostAtomicEnter(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+///
+/// \brief Simulated ISRs run synchronously with main loop on host so atomic
+/// blocks only need to execute their body once.
+/// @{
+
+#define ATOMIC_RESTORESTATE
+#define ATOMIC_FORCEON
+#define NONATOMIC_RESTORESTATE
+#define NONATOMIC_FORCEOFF
+
+#define ATOMIC_BLOCK(type)      for (int __atomicOnce = (hostAtomicEnter(), 1); __atomicOnce; __atomicOnce = 0)
+#define NONATOMIC_BLOCK(type)   for (int __atomicOnce = 1; __atomicOnce; __atomicOnce = 0)
+
+/// @}
+
+/// @}
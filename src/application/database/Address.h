@@ -0,0 +1,211 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#pragma once
+
+#include "dbms/src/DataTypes.h"
+#include "blocks/Blocks.h"
+#include "Hardware.h"
+
+///
+/// \ingroup database
+/// @{
+
+///
+/// \brief Number of parameters, parameter type and number of records of single section.
+/// Parameters of section are stored record after record (for instance, program after
+/// program), each record holding numberOfParameters/records parameters. When layout
+/// changes, parameters keep their place in record (see Schema.h), so records can be
+/// added and parameters can be added to the end of each record.
+///
+typedef struct
+{
+    uint32_t                numberOfParameters;
+    sectionParameterType_t  parameterType;
+    uint8_t                 records;
+} dbSectionFormat_t;
+
+///
+/// \brief Format of all sections, in order of blocks and sections.
+/// Database layout (see Layout.h) takes number and type of parameters from here, so that
+/// memory address of each section is known at compile time (see dbSectionAddress).
+/// Any change here needs new schema version (see Schema.h).
+///
+constexpr dbSectionFormat_t dbSectionFormat[] =
+{
+    //program block
+    { 1,                                                                BYTE_PARAMETER,  1 },                       //programLastActiveProgramSection
+    { NUMBER_OF_PROGRAMS,                                               BYTE_PARAMETER,  NUMBER_OF_PROGRAMS },      //programLastActiveScaleSection
+    { GLOBAL_PROGRAM_SETTINGS*NUMBER_OF_PROGRAMS,                       BYTE_PARAMETER,  NUMBER_OF_PROGRAMS },      //programGlobalSettingsSection
+    { LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*NUMBER_OF_PROGRAMS,         BYTE_PARAMETER,  NUMBER_OF_PROGRAMS },      //programLocalSettingsSection
+
+    //scale block
+    { PREDEFINED_SCALE_PARAMETERS*PREDEFINED_SCALES*NUMBER_OF_PROGRAMS, BYTE_PARAMETER,  NUMBER_OF_PROGRAMS },      //scalePredefinedSection
+    { NUMBER_OF_PADS*NOTES_PER_PAD*NUMBER_OF_USER_SCALES,               BYTE_PARAMETER,  NUMBER_OF_USER_SCALES },   //scaleUserSection
+
+    //pad calibration block
+    { NUMBER_OF_PADS,                                                   WORD_PARAMETER,  1 },                       //padCalibrationPressureUpperSection
+    { NUMBER_OF_PADS,                                                   WORD_PARAMETER,  1 },                       //padCalibrationXlowerSection
+    { NUMBER_OF_PADS,                                                   WORD_PARAMETER,  1 },                       //padCalibrationXupperSection
+    { NUMBER_OF_PADS,                                                   WORD_PARAMETER,  1 },                       //padCalibrationYlowerSection
+    { NUMBER_OF_PADS,                                                   WORD_PARAMETER,  1 },                       //padCalibrationYupperSection
+
+    //global block
+    { MIDI_SETTINGS,                                                    BYTE_PARAMETER,  1 },                       //globalSettingsMIDI
+    { VELOCITY_SETTINGS,                                                BYTE_PARAMETER,  1 },                       //globalSettingsVelocitySensitivity
+
+    //id block
+    { NUM_OF_UID_BYTES,                                                 BYTE_PARAMETER,  1 },
+
+    //extended program block
+    { EXTENDED_PROGRAM_SETTINGS*NUMBER_OF_PROGRAMS,                     BYTE_PARAMETER,  NUMBER_OF_PROGRAMS },      //programExtendedSettingsSection
+
+    //log block
+    { DB_LOG_SLOTS,                                                     DWORD_PARAMETER, 1 },                       //logSlotSection
+
+    //default map block
+    { DB_DEFAULT_MAP_SIZE,                                              BYTE_PARAMETER,  1 },                       //defaultMapSection
+};
+
+static_assert((sizeof(dbSectionFormat)/sizeof(dbSectionFormat_t)) == DB_SECTIONS, "Format needs to be defined for all sections");
+
+///
+/// \brief Number of sections in each block.
+///
+constexpr uint8_t dbBlockSections[DB_BLOCKS] =
+{
+    PROGRAM_SECTIONS,
+    SCALE_SECTIONS,
+    PAD_CALIBRATION_SECTIONS,
+    GLOBAL_SETTINGS_SECTIONS,
+    1,
+    PROGRAM_EXTENDED_SECTIONS,
+    LOG_SECTIONS,
+    DEFAULT_MAP_SECTIONS
+};
+
+///
+/// \brief Sections which are rewritten often and are therefore stored in log ring
+/// instead of their own address (see Database::writeLog).
+///
+constexpr dbLogSection_t dbLogSections[] =
+{
+    { DB_BLOCK_PROGRAM, programLastActiveProgramSection },
+    { DB_BLOCK_PROGRAM, programLastActiveScaleSection },
+};
+
+///
+/// \brief Number of high-churn sections.
+///
+#define DB_LOG_SECTIONS (sizeof(dbLogSections)/sizeof(dbLogSection_t))
+
+///
+/// \brief Returns index of section among sections of all blocks.
+///
+constexpr uint8_t dbSectionIndex(uint8_t blockID, uint8_t sectionID)
+{
+    return blockID ? dbSectionIndex(blockID-1, sectionID+dbBlockSections[blockID-1]) : sectionID;
+}
+
+///
+/// \brief Returns format of section.
+///
+constexpr dbSectionFormat_t dbFormat(uint8_t blockID, uint8_t sectionID)
+{
+    return dbSectionFormat[dbSectionIndex(blockID, sectionID)];
+}
+
+///
+/// \brief Returns number of memory bytes used by single parameter of requested type.
+/// Bit and half-byte parameters share single byte.
+///
+constexpr uint8_t dbParameterSize(sectionParameterType_t type)
+{
+    return (type == DWORD_PARAMETER) ? 4 : (type == WORD_PARAMETER) ? 2 : 1;
+}
+
+///
+/// \brief Returns size of section with requested format in memory in bytes.
+///
+constexpr uint32_t dbFormatSize(const dbSectionFormat_t &format)
+{
+    return (format.parameterType == BIT_PARAMETER) ? (format.numberOfParameters+7)/8 :
+        (format.parameterType == HALFBYTE_PARAMETER) ? (format.numberOfParameters+1)/2 :
+        format.numberOfParameters*dbParameterSize(format.parameterType);
+}
+
+///
+/// \brief Returns size of section in memory in bytes.
+/// @param [in] index   Section index (see dbSectionIndex).
+///
+constexpr uint32_t dbSectionSize(uint8_t index)
+{
+    return dbFormatSize(dbSectionFormat[index]);
+}
+
+///
+/// \brief Returns memory address of section.
+/// Sections are placed one after another, in order of blocks and sections.
+/// @param [in] index   Section index (see dbSectionIndex).
+///
+constexpr uint32_t dbSectionAddress(uint8_t index)
+{
+    return index ? dbSectionAddress(index-1)+dbSectionSize(index-1) : 0;
+}
+
+///
+/// \brief Checks whether section is stored in log ring.
+/// @param [in] index   Index in dbLogSections from which check starts.
+///
+constexpr bool dbLogSection(uint8_t blockID, uint8_t sectionID, uint8_t index = 0)
+{
+    return (index < DB_LOG_SECTIONS) &&
+        (((dbLogSections[index].block == blockID) && (dbLogSections[index].section == sectionID)) || dbLogSection(blockID, sectionID, index+1));
+}
+
+///
+/// \brief Returns log key of first parameter of section stored in log ring (see Database::getLogKey).
+/// Keys are assigned to parameters of all high-churn sections in order.
+/// @param [in] index   Index in dbLogSections from which keys are counted.
+///
+constexpr uint8_t dbLogKey(uint8_t blockID, uint8_t sectionID, uint8_t index = 0)
+{
+    return ((index >= DB_LOG_SECTIONS) || ((dbLogSections[index].block == blockID) && (dbLogSections[index].section == sectionID))) ? 0 :
+        (dbFormat(dbLogSections[index].block, dbLogSections[index].section).numberOfParameters + dbLogKey(blockID, sectionID, index+1));
+}
+
+static_assert(dbLogKey(DB_BLOCKS, 0) == DB_LOG_KEYS, "Number of log keys needs to match parameters of all high-churn sections");
+
+///
+/// \brief Type in which value of parameter of requested type is returned.
+/// @{
+
+template<sectionParameterType_t parameterType> struct dbValue { typedef uint8_t type; };
+template<> struct dbValue<WORD_PARAMETER> { typedef uint16_t type; };
+template<> struct dbValue<DWORD_PARAMETER> { typedef int32_t type; };
+
+/// @}
+
+/// @}
@@ -23,9 +23,242 @@
     <https://www.gnu.org/licenses/gpl-3.0.txt>
 */
 
+#include <string.h>
 #include "Database.h"
 #include "Layout.h"
 #include "board/Board.h"
+#include "core/src/general/BitManipulation.h"
+
+///
+/// \brief Copy of default map (see DefaultMap.h).
+/// Bit is set for each memory chunk which holds default values.
+///
+static uint8_t  defaultMap[DB_DEFAULT_MAP_SIZE];
+
+///
+/// \brief Memory address of each section, in order of blocks (see Database::getSectionIndex).
+///
+static uint16_t sectionAddress[DB_SECTIONS];
+
+///
+/// \brief Memory address of default map.
+///
+static uint16_t defaultMapAddress;
+
+///
+/// \brief Set once section addresses and default map are loaded.
+/// Until then, all chunks are considered written.
+///
+static bool     defaultMapReady;
+
+///
+/// \brief Position of memory address in layout.
+/// Zero-initialized position points to start of first section.
+///
+typedef struct
+{
+    uint8_t index;      ///< Index of section among sections of all blocks.
+    uint8_t blockID;    ///< Block to which address belongs.
+    uint8_t sectionID;  ///< Section to which address belongs.
+    uint16_t offset;    ///< Address offset from start of section.
+} sectionPosition_t;
+
+///
+/// \brief Finds section to which memory address belongs.
+/// Sections are placed in ascending order of addresses, so search continues from
+/// section found last. This way, walking through memory in order checks each
+/// section only once. Search restarts from first section only if address is
+/// below current section.
+/// @param [in] address         Memory address.
+/// @param [in,out] position    Position of address in layout.
+/// \returns True if address belongs to any section, false otherwise.
+///
+static bool findSection(uint32_t address, sectionPosition_t &position)
+{
+    if ((position.index >= DB_SECTIONS) || (address < sectionAddress[position.index]))
+    {
+        position.index = 0;
+        position.blockID = 0;
+        position.sectionID = 0;
+    }
+
+    while (position.index < DB_SECTIONS)
+    {
+        if (address < sectionAddress[position.index])
+            return false;
+
+        if (address < (sectionAddress[position.index]+dbSectionSize(position.index)))
+        {
+            position.offset = address - sectionAddress[position.index];
+            return true;
+        }
+
+        position.index++;
+        position.sectionID++;
+
+        while ((position.blockID < DB_BLOCKS) && (position.sectionID >= dbLayout[position.blockID].numberOfSections))
+        {
+            position.blockID++;
+            position.sectionID = 0;
+        }
+    }
+
+    return false;
+}
+
+///
+/// \brief Checks whether memory chunk to which address belongs holds default values.
+///
+static inline bool isDefault(uint32_t address)
+{
+    if (!defaultMapReady)
+        return false;
+
+    uint16_t chunk = address / DB_DEFAULT_CHUNK_SIZE;
+
+    if (chunk >= DB_DEFAULT_CHUNKS)
+        return false;
+
+    return BIT_READ(defaultMap[chunk/8], chunk%8);
+}
+
+///
+/// \brief Returns default value of single memory byte.
+/// Default values of parameters are placed in memory the same way DBMS places them.
+/// @param [in] address         Memory address.
+/// @param [in,out] position    Position of previous address which has been checked (see findSection).
+///
+static uint8_t defaultByte(uint32_t address, sectionPosition_t &position)
+{
+    if (!findSection(address, position))
+        return 0;
+
+    uint8_t blockID = position.blockID;
+    uint8_t sectionID = position.sectionID;
+    uint32_t offset = position.offset;
+
+    uint32_t parameters = dbLayout[blockID].section[sectionID].numberOfParameters;
+    uint8_t value = 0;
+
+    switch(dbLayout[blockID].section[sectionID].parameterType)
+    {
+        case BIT_PARAMETER:
+        for (int i=0; i<8; i++)
+        {
+            if (((offset*8+i) < parameters) && (database.getDefaultValue(blockID, sectionID, offset*8+i) & 0x01))
+                BIT_SET(value, i);
+        }
+        return value;
+
+        case HALFBYTE_PARAMETER:
+        value = database.getDefaultValue(blockID, sectionID, offset*2) & 0x0F;
+
+        if ((offset*2+1) < parameters)
+            value |= (database.getDefaultValue(blockID, sectionID, offset*2+1) & 0x0F) << 4;
+
+        return value;
+
+        case BYTE_PARAMETER:
+        return database.getDefaultValue(blockID, sectionID, offset);
+
+        case WORD_PARAMETER:
+        return (uint32_t)database.getDefaultValue(blockID, sectionID, offset/2) >> (8*(offset%2));
+
+        default:
+        return (uint32_t)database.getDefaultValue(blockID, sectionID, offset/4) >> (8*(offset%4));
+    }
+}
+
+///
+/// \brief Writes default value of single memory byte to board memory.
+/// Nothing is written if byte already holds default value.
+///
+static void writeDefaultByte(uint32_t address, sectionPosition_t &position)
+{
+    uint8_t value = defaultByte(address, position);
+    int32_t current;
+
+    if (Board::memoryRead(address, BYTE_PARAMETER, current) && ((uint8_t)current == value))
+        return;
+
+    Board::memoryWrite(address, value, BYTE_PARAMETER);
+}
+
+///
+/// \brief Writes default values of memory chunk to which address belongs and
+/// marks chunk as written. Defaults are written to board memory directly, ahead
+/// of any value which goes to write cache, and default map is updated after them.
+///
+static void writeDefaults(uint32_t address)
+{
+    uint16_t chunk = address / DB_DEFAULT_CHUNK_SIZE;
+    uint32_t start = (uint32_t)chunk * DB_DEFAULT_CHUNK_SIZE;
+    uint32_t end = start + DB_DEFAULT_CHUNK_SIZE;
+    sectionPosition_t position = {};
+
+    if (end > database.getDBsize())
+        end = database.getDBsize();
+
+    for (uint32_t i=start; i<end; i++)
+        writeDefaultByte(i, position);
+
+    BIT_CLEAR(defaultMap[chunk/8], chunk%8);
+    Board::memoryWrite(defaultMapAddress+(chunk/8), defaultMap[chunk/8], BYTE_PARAMETER);
+}
+
+///
+/// \brief Reads value from write cache or board memory.
+/// Bytes in chunks which hold default values are replaced with defaults.
+///
+static bool memoryRead(uint32_t address, sectionParameterType_t type, int32_t &value)
+{
+    if (writeCache.read(address, type, value))
+        return true;
+
+    if (!Board::memoryRead(address, type, value))
+        return false;
+
+    sectionPosition_t position = {};
+
+    for (int i=0; i<dbParameterSize(type); i++)
+    {
+        if (!isDefault(address+i))
+            continue;
+
+        uint32_t mask = (uint32_t)0xFF << (8*i);
+
+        value = ((uint32_t)value & ~mask) | ((uint32_t)defaultByte(address+i, position) << (8*i));
+    }
+
+    return true;
+}
+
+///
+/// \brief Writes value to write cache instead of board memory.
+/// Defaults of chunks to which value belongs are written first if needed.
+///
+static bool memoryWrite(uint32_t address, int32_t value, sectionParameterType_t type)
+{
+    for (int i=0; i<dbParameterSize(type); i++)
+    {
+        if (isDefault(address+i))
+            writeDefaults(address+i);
+    }
+
+    return writeCache.write(address, value, type);
+}
+
+///
+/// \brief Creates log slot entry.
+/// Entry holds sequence number, key, value and check byte, in that order from lowest byte.
+/// Check byte is written last, so that slot which hasn't been fully written is invalid.
+///
+static inline uint32_t logEntry(uint8_t sequence, uint8_t key, uint8_t value)
+{
+    uint8_t check = sequence ^ key ^ value ^ DB_LOG_CHECK_MASK;
+
+    return (uint32_t)sequence | ((uint32_t)key << 8) | ((uint32_t)value << 16) | ((uint32_t)check << 24);
+}
 
 ///
 /// \brief Initializes database.
@@ -33,27 +266,61 @@
 void Database::init()
 {
     setLayout(dbLayout, DB_BLOCKS);
+    invalidateProgramCache();
+    initDefaultMap();
+    initSchema();
+
+    if (migrationBlocked())
+    {
+        //memory doesn't hold current layout yet, see migrate
+        defaultMapReady = false;
+        return;
+    }
+
+    if (migrationPending())
+        initMigrationMap();
+    else
+        initLog();
 }
 
 ///
 /// \brief Performs factory reset of data in database.
+/// Parameters aren't written, their chunks are only marked as holding default
+/// values (see DefaultMap.h).
 /// @param [in] type Factory reset type. See initType_t enumeration.
 ///
 void Database::factoryReset(initType_t type)
 {
-    if (type == initFull)
-        clear();
+    //default map in RAM differs from memory until migration writes it
+    if (!migrationBlocked())
+    {
+        while (!migrate());
+    }
+
+    invalidateProgramCache();
+    //pending writes need to be done before their chunks are reset
+    writeCache.flush();
+    resetDefaultMap(type);
 
-    initData(type);
-    writeCustomValues();
+    for (int i=0; i<NUM_OF_UID_BYTES; i++)
+        DBMS::update(DB_BLOCK_ID, 0, i, UNIQUE_ID);
+
+    //log slots are reset as well
+    initLog();
+    writeCache.flush();
+    setSchema(DB_SCHEMA_VERSION, DB_SCHEMA_NONE, 0, 0);
 }
 
 ///
 /// \brief Checks if database has been already initialized by checking DB_BLOCK_ID.
+/// Memory needs to hold current layout as well (see Schema.h).
 /// \returns True if valid, false otherwise.
 ///
 bool Database::signatureValid()
 {
+    if ((schemaState.version != DB_SCHEMA_VERSION) || migrationBlocked())
+        return false;
+
     //check if all bytes up to START_OFFSET address match unique id
 
     for (int i=0; i<NUM_OF_UID_BYTES; i++)
@@ -65,4 +332,641 @@ bool Database::signatureValid()
     return true;
 }
 
-Database database(Board::memoryRead, Board::memoryWrite);
\ No newline at end of file
+///
+/// \brief Reads parameter from database.
+/// Parameters of high-churn sections are read from RAM (see initLog).
+/// \returns Parameter value.
+///
+int32_t Database::read(uint8_t blockID, uint8_t sectionID, uint16_t parameterID)
+{
+    int32_t value = 0;
+
+    read(blockID, sectionID, parameterID, value);
+    return value;
+}
+
+///
+/// \brief Reads parameter from database.
+/// @param [in,out] value   Variable in which read value is stored.
+/// \returns True on success, false otherwise.
+///
+bool Database::read(uint8_t blockID, uint8_t sectionID, uint16_t parameterID, int32_t &value)
+{
+    int8_t key = getLogKey(blockID, sectionID, parameterID);
+
+    if (key == -1)
+        return DBMS::read(blockID, sectionID, parameterID, value);
+
+    value = logValue[key];
+    return true;
+}
+
+///
+/// \brief Updates parameter in database.
+/// Parameters of high-churn sections are written to log ring. Cached program
+/// images are updated as well. Migration which is still pending (see
+/// updateMigration) is finished first.
+/// \returns True on success, false otherwise.
+///
+bool Database::update(uint8_t blockID, uint8_t sectionID, uint16_t parameterID, int32_t newValue)
+{
+    //default map needs to be in memory before chunk holding default values is written
+    while (!migrate());
+
+    int8_t key = getLogKey(blockID, sectionID, parameterID);
+
+    if (key != -1)
+    {
+        //nothing to write
+        if (logValue[key] == (uint8_t)newValue)
+            return true;
+
+        if (!writeLog(key, newValue))
+            return false;
+    }
+    else if (!DBMS::update(blockID, sectionID, parameterID, newValue))
+    {
+        return false;
+    }
+
+    writeCount[getSectionIndex(blockID, sectionID)]++;
+
+    for (int i=0; i<PROGRAM_CACHE_SIZE; i++)
+    {
+        if (cacheProgram[i] == -1)
+            continue;
+
+        programImage_t &image = programCache[i];
+        uint16_t program = cacheProgram[i];
+
+        if (blockID == DB_BLOCK_PROGRAM)
+        {
+            switch(sectionID)
+            {
+                case programLastActiveScaleSection:
+                if (parameterID == program)
+                    image.scale = newValue;
+                break;
+
+                case programGlobalSettingsSection:
+                if ((parameterID / GLOBAL_PROGRAM_SETTINGS) == program)
+                    image.global[parameterID % GLOBAL_PROGRAM_SETTINGS] = newValue;
+                break;
+
+                case programLocalSettingsSection:
+                if ((parameterID / (LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS)) == program)
+                {
+                    uint16_t index = parameterID % (LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS);
+                    image.local[index / LOCAL_PROGRAM_SETTINGS][index % LOCAL_PROGRAM_SETTINGS] = newValue;
+                }
+                break;
+
+                default:
+                break;
+            }
+        }
+        else if ((blockID == DB_BLOCK_PROGRAM_EXTENDED) && (sectionID == programExtendedSettingsSection))
+        {
+            if ((parameterID / EXTENDED_PROGRAM_SETTINGS) == program)
+                image.extended[parameterID % EXTENDED_PROGRAM_SETTINGS] = newValue;
+        }
+        else if ((blockID == DB_BLOCK_SCALE) && (sectionID == scalePredefinedSection))
+        {
+            if ((parameterID / (PREDEFINED_SCALE_PARAMETERS*PREDEFINED_SCALES)) == program)
+            {
+                uint16_t index = parameterID % (PREDEFINED_SCALE_PARAMETERS*PREDEFINED_SCALES);
+                image.predefinedScale[index / PREDEFINED_SCALE_PARAMETERS][index % PREDEFINED_SCALE_PARAMETERS] = newValue;
+            }
+        }
+    }
+
+    return true;
+}
+
+///
+/// \brief Reads sequence of byte parameters with single bulk memory read.
+/// @param [in] blockID         Block from which parameters are read.
+/// @param [in] sectionID       Section from which parameters are read. Section needs to hold byte parameters.
+/// @param [in] parameterID     First parameter which is read.
+/// @param [in,out] data        Array in which parameters are stored.
+/// @param [in] size            Number of parameters to read.
+/// Parameters which haven't been written to memory yet are taken from write cache,
+/// and parameters which hold default values are taken from defaults.
+/// Sections stored in log ring can't be read this way.
+/// \returns True on success, false otherwise.
+///
+bool Database::readBlock(uint8_t blockID, uint8_t sectionID, uint16_t parameterID, uint8_t *data, uint16_t size)
+{
+    uint32_t address = sectionAddress[getSectionIndex(blockID, sectionID)] + parameterID;
+
+    if (!Board::memoryReadBlock(address, data, size))
+        return false;
+
+    writeCache.overlay(address, data, size);
+
+    sectionPosition_t position = {};
+
+    for (int i=0; i<size; i++)
+    {
+        if (isDefault(address+i))
+            data[i] = defaultByte(address+i, position);
+    }
+
+    return true;
+}
+
+///
+/// \brief Returns settings of requested program.
+/// Program image is loaded from memory only if it isn't cached already.
+/// @param [in] program     Program for which settings are returned.
+/// \returns Reference to program image.
+///
+const programImage_t& Database::getProgram(uint8_t program)
+{
+    int8_t slot = findProgram(program);
+
+    if (program != lastProgram)
+    {
+        //program change
+        lastProgram = program;
+
+        if (slot == -1)
+            cacheMisses++;
+        else
+            cacheHits++;
+    }
+
+    if (slot == -1)
+        slot = loadProgram(program);
+
+    return programCache[slot];
+}
+
+///
+/// \brief Loads one of neighbors of program which has been requested last into cache.
+/// Needs to be called from main loop when there's nothing else to do. Only single image
+/// is loaded per call to keep each call short.
+/// \returns True if image has been loaded, false if neighbors are already cached or memory is busy.
+///
+bool Database::prefetchPrograms()
+{
+    if (lastProgram == -1)
+        return false;
+
+    //memory can't be read until write is done
+    if (!Board::memoryReady())
+        return false;
+
+    uint8_t neighbor[2] =
+    {
+        (uint8_t)((lastProgram == (NUMBER_OF_PROGRAMS-1)) ? 0 : lastProgram+1),
+        (uint8_t)(lastProgram ? lastProgram-1 : NUMBER_OF_PROGRAMS-1)
+    };
+
+    for (int i=0; i<2; i++)
+    {
+        if (findProgram(neighbor[i]) == -1)
+        {
+            loadProgram(neighbor[i]);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+///
+/// \brief Returns number of program changes since startup for which program image has
+/// been found in cache (hits) or had to be loaded from memory (misses).
+///
+void Database::getProgramCacheStats(uint32_t &hits, uint32_t &misses)
+{
+    hits = cacheHits;
+    misses = cacheMisses;
+}
+
+///
+/// \brief Returns number of updates of requested section since startup.
+/// Updates of high-churn sections which don't change value aren't counted.
+///
+uint32_t Database::getWriteCount(uint8_t blockID, uint8_t sectionID)
+{
+    return writeCount[getSectionIndex(blockID, sectionID)];
+}
+
+///
+/// \brief Returns number of log slots written since startup (slotWrites) and number of
+/// values moved from log ring to their own address since startup (homeWrites).
+///
+void Database::getLogStats(uint32_t &slotWrites, uint32_t &homeWrites)
+{
+    slotWrites = logSlotWrites;
+    homeWrites = logHomeWrites;
+}
+
+///
+/// \brief Marks all cached program images as invalid.
+///
+void Database::invalidateProgramCache()
+{
+    for (int i=0; i<PROGRAM_CACHE_SIZE; i++)
+        cacheProgram[i] = -1;
+
+    lastProgram = -1;
+}
+
+///
+/// \brief Returns cache slot in which requested program is loaded, -1 if program isn't cached.
+///
+int8_t Database::findProgram(uint8_t program)
+{
+    for (int i=0; i<PROGRAM_CACHE_SIZE; i++)
+    {
+        if (cacheProgram[i] == program)
+            return i;
+    }
+
+    return -1;
+}
+
+///
+/// \brief Loads program image from memory into cache.
+/// Empty slot is used if available, otherwise image of program which is furthest
+/// away (in encoder steps) from program requested last is replaced.
+/// \returns Cache slot in which program has been loaded.
+///
+uint8_t Database::loadProgram(uint8_t program)
+{
+    uint8_t slot = 0;
+    uint8_t maxDistance = 0;
+
+    for (int i=0; i<PROGRAM_CACHE_SIZE; i++)
+    {
+        if (cacheProgram[i] == -1)
+        {
+            slot = i;
+            break;
+        }
+
+        uint8_t distance = (cacheProgram[i] > lastProgram) ? cacheProgram[i]-lastProgram : lastProgram-cacheProgram[i];
+
+        //programs roll over
+        if (distance > (NUMBER_OF_PROGRAMS/2))
+            distance = NUMBER_OF_PROGRAMS-distance;
+
+        if (distance > maxDistance)
+        {
+            maxDistance = distance;
+            slot = i;
+        }
+    }
+
+    programImage_t &image = programCache[slot];
+
+    readBlock(DB_BLOCK_PROGRAM, programGlobalSettingsSection, GLOBAL_PROGRAM_SETTINGS*(uint16_t)program, image.global, sizeof(image.global));
+    readBlock(DB_BLOCK_PROGRAM_EXTENDED, programExtendedSettingsSection, EXTENDED_PROGRAM_SETTINGS*(uint16_t)program, image.extended, sizeof(image.extended));
+    readBlock(DB_BLOCK_PROGRAM, programLocalSettingsSection, LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*(uint16_t)program, image.local[0], sizeof(image.local));
+    image.scale = read(DB_BLOCK_PROGRAM, programLastActiveScaleSection, program);
+    readBlock(DB_BLOCK_SCALE, scalePredefinedSection, PREDEFINED_SCALE_PARAMETERS*PREDEFINED_SCALES*(uint16_t)program, image.predefinedScale[0], sizeof(image.predefinedScale));
+    cacheProgram[slot] = program;
+
+    return slot;
+}
+
+///
+/// \brief Checks whether log slot entry is valid.
+/// @param [in] entry   Log slot entry.
+/// @param [in] keys    Number of keys stored in log ring.
+///
+bool Database::logEntryValid(uint32_t entry, uint8_t keys)
+{
+    uint8_t check = entry ^ (entry >> 8) ^ (entry >> 16) ^ DB_LOG_CHECK_MASK;
+
+    if ((uint8_t)(entry >> 24) != check)
+        return false;
+
+    return ((uint8_t)(entry >> 8) < keys);
+}
+
+///
+/// \brief Finds slot written last in log ring.
+/// Slot written last is valid slot after which sequence numbers don't continue.
+/// @param [in] address         Memory address of log ring.
+/// @param [in] slots           Number of slots in log ring.
+/// @param [in] keys            Number of keys stored in log ring.
+/// @param [in,out] head        Slot written last.
+/// @param [in,out] sequence    Sequence number of slot written last.
+/// \returns True if log ring holds any valid slot, false otherwise.
+///
+bool Database::findLogHead(uint32_t address, uint8_t slots, uint8_t keys, uint8_t &head, uint8_t &sequence)
+{
+    int32_t first = 0;
+
+    readMemory(address, DWORD_PARAMETER, first);
+
+    uint32_t current = first;
+
+    for (int i=0; i<slots; i++)
+    {
+        int32_t next = first;
+
+        if (i != (slots-1))
+            readMemory(address+(uint32_t)(i+1)*sizeof(next), DWORD_PARAMETER, next);
+
+        if (logEntryValid(current, keys) && (!logEntryValid(next, keys) || ((uint8_t)next != (uint8_t)(current+1))))
+        {
+            head = i;
+            sequence = current;
+            return true;
+        }
+
+        current = next;
+    }
+
+    return false;
+}
+
+///
+/// \brief Loads current values of high-churn parameters.
+/// Values are first read from their own addresses. Slot written last is then found (see
+/// findLogHead), and all valid slots are applied from oldest to newest one so that latest
+/// value of each parameter remains.
+///
+void Database::initLog()
+{
+    uint8_t key = 0;
+
+    for (uint8_t i=0; i<DB_LOG_SECTIONS; i++)
+    {
+        for (uint32_t j=0; j<dbLayout[dbLogSections[i].block].section[dbLogSections[i].section].numberOfParameters; j++)
+        {
+            logValue[key] = DBMS::read(dbLogSections[i].block, dbLogSections[i].section, j);
+            logSlot[key] = -1;
+            key++;
+        }
+    }
+
+    uint32_t address = sectionAddress[getSectionIndex(DB_BLOCK_LOG, logSlotSection)];
+
+    if (!findLogHead(address, DB_LOG_SLOTS, DB_LOG_KEYS, logHead, logSequence))
+    {
+        //empty log: first write goes to slot 0 with sequence 0
+        logHead = DB_LOG_SLOTS-1;
+        logSequence = 0xFF;
+        return;
+    }
+
+    for (int i=1; i<=DB_LOG_SLOTS; i++)
+    {
+        uint8_t slot = (logHead+i) % DB_LOG_SLOTS;
+        int32_t entry = 0;
+
+        readMemory(address+(uint32_t)slot*sizeof(entry), DWORD_PARAMETER, entry);
+
+        if (!logEntryValid(entry, DB_LOG_KEYS))
+            continue;
+
+        key = entry >> 8;
+        logValue[key] = entry >> 16;
+        logSlot[key] = slot;
+    }
+}
+
+///
+/// \brief Returns log key of requested parameter, -1 if parameter isn't stored in log ring.
+/// Keys are assigned to parameters of all high-churn sections in order.
+///
+int8_t Database::getLogKey(uint8_t blockID, uint8_t sectionID, uint16_t parameterID)
+{
+    uint8_t key = 0;
+
+    for (uint8_t i=0; i<DB_LOG_SECTIONS; i++)
+    {
+        uint32_t parameters = dbLayout[dbLogSections[i].block].section[dbLogSections[i].section].numberOfParameters;
+
+        if ((dbLogSections[i].block == blockID) && (dbLogSections[i].section == sectionID))
+            return (parameterID < parameters) ? key+parameterID : -1;
+
+        key += parameters;
+    }
+
+    return -1;
+}
+
+///
+/// \brief Returns block, section and parameter of requested log key.
+///
+void Database::getLogParameter(uint8_t key, uint8_t &blockID, uint8_t &sectionID, uint16_t &parameterID)
+{
+    for (uint8_t i=0; i<DB_LOG_SECTIONS; i++)
+    {
+        uint32_t parameters = dbLayout[dbLogSections[i].block].section[dbLogSections[i].section].numberOfParameters;
+
+        if (key < parameters)
+        {
+            blockID = dbLogSections[i].block;
+            sectionID = dbLogSections[i].section;
+            parameterID = key;
+            return;
+        }
+
+        key -= parameters;
+    }
+}
+
+///
+/// \brief Writes value of high-churn parameter into next log slot.
+/// If slot which is reused holds latest value of other parameter, that value is written
+/// to its own address first.
+/// @param [in] key     Log key of parameter (see getLogKey).
+/// @param [in] value   New value.
+/// \returns True on success, false otherwise.
+///
+bool Database::writeLog(uint8_t key, uint8_t value)
+{
+    uint8_t slot = (logHead == (DB_LOG_SLOTS-1)) ? 0 : logHead+1;
+    uint8_t sequence = logSequence+1;
+
+    for (int i=0; i<DB_LOG_KEYS; i++)
+    {
+        if (logSlot[i] != slot)
+            continue;
+
+        if (i != key)
+        {
+            uint8_t blockID = 0;
+            uint8_t sectionID = 0;
+            uint16_t parameterID = 0;
+
+            getLogParameter(i, blockID, sectionID, parameterID);
+
+            if (!DBMS::update(blockID, sectionID, parameterID, logValue[i]))
+                return false;
+
+            logHomeWrites++;
+        }
+
+        logSlot[i] = -1;
+    }
+
+    if (!DBMS::update(DB_BLOCK_LOG, logSlotSection, slot, logEntry(sequence, key, value)))
+        return false;
+
+    logValue[key] = value;
+    logSlot[key] = slot;
+    logHead = slot;
+    logSequence = sequence;
+    logSlotWrites++;
+
+    return true;
+}
+
+///
+/// \brief Returns index of requested section among sections of all blocks.
+///
+uint8_t Database::getSectionIndex(uint8_t blockID, uint8_t sectionID)
+{
+    uint8_t index = sectionID;
+
+    for (int i=0; i<blockID; i++)
+        index += dbLayout[i].numberOfSections;
+
+    return index;
+}
+
+///
+/// \brief Copies addresses of all sections from layout and loads default map.
+/// Section addresses are compared against addresses known at compile time as well.
+///
+void Database::initDefaultMap()
+{
+    uint8_t index = 0;
+
+    defaultMapReady = false;
+    staticLayout = true;
+
+    for (int i=0; i<DB_BLOCKS; i++)
+    {
+        for (int j=0; j<dbLayout[i].numberOfSections; j++)
+        {
+            sectionAddress[index] = dbLayout[i].section[j].address;
+
+            //template reads can't use compile time addresses if DBMS places sections differently
+            if (sectionAddress[index] != dbSectionAddress(index))
+                staticLayout = false;
+
+            index++;
+        }
+    }
+
+    #ifdef DEBUG
+    if (!staticLayout)
+        printf_P(PSTR("Section addresses differ from compile time addresses\n"));
+    #endif
+
+    defaultMapAddress = sectionAddress[getSectionIndex(DB_BLOCK_DEFAULT_MAP, defaultMapSection)];
+    Board::memoryReadBlock(defaultMapAddress, defaultMap, DB_DEFAULT_MAP_SIZE);
+    defaultMapReady = true;
+}
+
+///
+/// \brief Replaces default map in RAM without writing it to memory.
+/// Used by migration (see Database::initMigrationMap).
+///
+void Database::setDefaultMap(const uint8_t *map)
+{
+    memcpy(defaultMap, map, DB_DEFAULT_MAP_SIZE);
+    defaultMapReady = true;
+}
+
+///
+/// \brief Marks memory chunks as holding default values on factory reset.
+/// Chunk can hold default values only if all of its parameters are reset. ID and
+/// default map are never reset this way, and neither are sections preserved on
+/// partial reset. Parameters which are reset in other chunks are written.
+/// @param [in] type Factory reset type. See initType_t enumeration.
+///
+void Database::resetDefaultMap(initType_t type)
+{
+    uint32_t size = getDBsize();
+    uint8_t previous[DB_DEFAULT_MAP_SIZE];
+    //both positions only move forward, one is used for checking and other one for writing
+    sectionPosition_t position = {};
+    sectionPosition_t writePosition = {};
+
+    memcpy(previous, defaultMap, DB_DEFAULT_MAP_SIZE);
+
+    for (uint16_t chunk=0; chunk<DB_DEFAULT_CHUNKS; chunk++)
+    {
+        uint32_t start = (uint32_t)chunk * DB_DEFAULT_CHUNK_SIZE;
+        uint32_t end = start + DB_DEFAULT_CHUNK_SIZE;
+        bool reset[DB_DEFAULT_CHUNK_SIZE];
+        bool all = true;
+
+        if (end > size)
+            end = size;
+
+        for (uint32_t i=start; i<end; i++)
+        {
+            reset[i-start] = true;
+
+            if (!findSection(i, position))
+                continue;
+
+            if ((position.blockID == DB_BLOCK_ID) || (position.blockID == DB_BLOCK_DEFAULT_MAP))
+                reset[i-start] = false;
+            else if ((type == initPartial) && dbLayout[position.blockID].section[position.sectionID].preserveOnPartialReset)
+                reset[i-start] = false;
+
+            if (!reset[i-start])
+                all = false;
+        }
+
+        if (all)
+        {
+            BIT_SET(defaultMap[chunk/8], chunk%8);
+        }
+        else if (!BIT_READ(defaultMap[chunk/8], chunk%8))
+        {
+            for (uint32_t i=start; i<end; i++)
+            {
+                if (reset[i-start])
+                    writeDefaultByte(i, writePosition);
+            }
+        }
+    }
+
+    for (int i=0; i<DB_DEFAULT_MAP_SIZE; i++)
+    {
+        if (defaultMap[i] != previous[i])
+            Board::memoryWrite(defaultMapAddress+i, defaultMap[i], BYTE_PARAMETER);
+    }
+}
+
+///
+/// \brief Returns default value of single memory byte in current layout.
+/// Used by migration (see Migration.cpp), which reads defaults in order of addresses.
+///
+uint8_t Database::getDefaultByte(uint32_t address)
+{
+    static sectionPosition_t position;
+
+    return defaultByte(address, position);
+}
+
+///
+/// \brief Reads value from memory the same way DBMS does (see memoryRead).
+/// Used by reads with address known at compile time. Write cache lookup and default map
+/// overlay are skipped when cache is empty and parameter doesn't belong to default chunk,
+/// in which case value is read from board memory directly.
+///
+bool Database::readMemory(uint32_t address, sectionParameterType_t type, int32_t &value)
+{
+    //parameters never span more than two chunks
+    if (!writeCache.getDirtyCount() && !isDefault(address) && !isDefault(address+dbParameterSize(type)-1))
+        return Board::memoryRead(address, type, value);
+
+    return memoryRead(address, type, value);
+}
+
+Database database(memoryRead, memoryWrite);
\ No newline at end of file
@@ -27,6 +27,10 @@
 
 #include "../dbms/src/DBMS.h"
 #include "blocks/Blocks.h"
+#include "Address.h"
+#include "Schema.h"
+#include "WriteCache.h"
+#include "Hardware.h"
 
 ///
 /// \brief Database management.
@@ -34,22 +38,213 @@
 /// \defgroup database Database
 /// @{
 
+///
+/// \brief Settings of single program.
+/// Global settings of program and local settings of all its pads are each stored
+/// sequentially in program block, as well as extended settings in extended program
+/// block and predefined scale settings in scale block, so image is loaded with bulk reads.
+///
+typedef struct
+{
+    uint8_t global[GLOBAL_PROGRAM_SETTINGS];
+    uint8_t extended[EXTENDED_PROGRAM_SETTINGS];
+    uint8_t local[NUMBER_OF_PADS][LOCAL_PROGRAM_SETTINGS];
+    uint8_t scale;
+    uint8_t predefinedScale[PREDEFINED_SCALES][PREDEFINED_SCALE_PARAMETERS];
+} programImage_t;
+
+///
+/// \brief Number of program images kept in RAM.
+/// Active program and its neighbors (programs selected with single encoder step) are kept.
+///
+#define PROGRAM_CACHE_SIZE  3
+
 class Database : public DBMS
 {
     public:
     Database(bool (*readCallback)(uint32_t address, sectionParameterType_t type, int32_t &value), bool (*writeCallback)(uint32_t address, int32_t value, sectionParameterType_t type)) :
     DBMS(readCallback, writeCallback)
-    {}
+    {
+        invalidateProgramCache();
+        cacheHits = 0;
+        cacheMisses = 0;
+        logSlotWrites = 0;
+        logHomeWrites = 0;
+        staticLayout = false;
+        schemaState.sequence = 0;
+        schemaState.version = DB_SCHEMA_NONE;
+        schemaState.source = DB_SCHEMA_NONE;
+        schemaState.phase = 0;
+        schemaState.position = 0;
+
+        for (int i=0; i<DB_SECTIONS; i++)
+            writeCount[i] = 0;
+    }
     void init();
     void factoryReset(initType_t type);
     bool signatureValid();
+    int32_t read(uint8_t blockID, uint8_t sectionID, uint16_t parameterID);
+    bool read(uint8_t blockID, uint8_t sectionID, uint16_t parameterID, int32_t &value);
+
+    ///
+    /// \brief Reads parameter from database using memory address known at compile time.
+    /// Address of parameter is calculated from section address and parameter size
+    /// (see Address.h) instead of being resolved by DBMS. Section addresses placed by
+    /// DBMS are checked against these addresses on init (see initDefaultMap). Value is
+    /// still taken from write cache or defaults if memory doesn't hold it yet, but with
+    /// empty write cache and parameter outside of default chunks it's read from memory
+    /// directly (see readMemory).
+    /// Sections stored in log ring need to be read with readLog.
+    /// @param [in] parameterID     Parameter index in section.
+    /// \returns Parameter value, 0 if parameter is outside of section.
+    ///
+    template<uint8_t blockID, uint8_t sectionID>
+    typename dbValue<dbFormat(blockID, sectionID).parameterType>::type read(uint16_t parameterID)
+    {
+        constexpr uint8_t index = dbSectionIndex(blockID, sectionID);
+        constexpr sectionParameterType_t type = dbSectionFormat[index].parameterType;
+        constexpr uint32_t address = dbSectionAddress(index);
+        constexpr uint32_t parameters = dbSectionFormat[index].numberOfParameters;
+
+        static_assert((type == BYTE_PARAMETER) || (type == WORD_PARAMETER) || (type == DWORD_PARAMETER), "Section needs to hold byte, word or dword parameters");
+        static_assert(!dbLogSection(blockID, sectionID), "Section stored in log ring needs to be read with readLog");
+
+        if (parameterID >= parameters)
+            return 0;
+
+        int32_t value = 0;
+
+        readMemory(address+(uint32_t)parameterID*dbParameterSize(type), type, value);
+        return value;
+    }
+
+    ///
+    /// \brief Reads parameter of section stored in log ring (see dbLogSections in Address.h).
+    /// Latest values of these parameters are kept in RAM, so memory isn't accessed.
+    /// @param [in] parameterID     Parameter index in section.
+    /// \returns Parameter value, 0 if parameter is outside of section.
+    ///
+    template<uint8_t blockID, uint8_t sectionID>
+    uint8_t readLog(uint16_t parameterID)
+    {
+        constexpr uint8_t key = dbLogKey(blockID, sectionID);
+        constexpr uint32_t parameters = dbFormat(blockID, sectionID).numberOfParameters;
+
+        static_assert(dbLogSection(blockID, sectionID), "Section needs to be stored in log ring");
+
+        return (parameterID < parameters) ? logValue[key+parameterID] : 0;
+    }
+
+    bool update(uint8_t blockID, uint8_t sectionID, uint16_t parameterID, int32_t newValue);
+    bool readBlock(uint8_t blockID, uint8_t sectionID, uint16_t parameterID, uint8_t *data, uint16_t size);
+    const programImage_t& getProgram(uint8_t program);
+    bool prefetchPrograms();
+    void getProgramCacheStats(uint32_t &hits, uint32_t &misses);
+    uint32_t getWriteCount(uint8_t blockID, uint8_t sectionID);
+    void getLogStats(uint32_t &slotWrites, uint32_t &homeWrites);
+    int32_t getDefaultValue(uint8_t blockID, uint8_t sectionID, uint16_t parameterID);
+    bool migrationPending();
+    bool migrationBlocked();
+    bool migrate();
+    bool updateMigration();
 
     private:
     void createLayout();
-    void writeCustomValues();
-    void initProgramSettings();
-    void initScales();
-    void initGlobalSettings();
+
+    void invalidateProgramCache();
+    int8_t findProgram(uint8_t program);
+    uint8_t loadProgram(uint8_t program);
+
+    void initLog();
+    int8_t getLogKey(uint8_t blockID, uint8_t sectionID, uint16_t parameterID);
+    void getLogParameter(uint8_t key, uint8_t &blockID, uint8_t &sectionID, uint16_t &parameterID);
+    bool writeLog(uint8_t key, uint8_t value);
+    static bool logEntryValid(uint32_t entry, uint8_t keys);
+    static bool findLogHead(uint32_t address, uint8_t slots, uint8_t keys, uint8_t &head, uint8_t &sequence);
+    uint8_t getSectionIndex(uint8_t blockID, uint8_t sectionID);
+
+    void initDefaultMap();
+    static bool readMemory(uint32_t address, sectionParameterType_t type, int32_t &value);
+    void resetDefaultMap(initType_t type);
+    static uint8_t getDefaultByte(uint32_t address);
+    void setDefaultMap(const uint8_t *map);
+
+    void initSchema();
+    bool loadSchema(uint8_t version);
+    void setSchema(uint8_t version, uint8_t source, uint8_t phase, uint16_t position);
+    bool migrateDefaults(uint16_t &position);
+    bool migrateLog(uint16_t &position);
+    bool migrateMove(bool up, uint16_t &position);
+    bool migrateFill(uint16_t &position);
+    bool migrateMap(uint16_t &position);
+    void initMigrationMap();
+
+    ///
+    /// \brief Program images.
+    /// cacheProgram holds program loaded in each slot, -1 if slot is empty.
+    /// lastProgram is program which has been requested last (-1 if none).
+    /// @{
+
+    programImage_t  programCache[PROGRAM_CACHE_SIZE];
+    int8_t          cacheProgram[PROGRAM_CACHE_SIZE];
+    int8_t          lastProgram;
+
+    /// @}
+
+    ///
+    /// \brief Number of program changes for which image has been found in cache or loaded from memory.
+    /// @{
+
+    uint32_t        cacheHits;
+    uint32_t        cacheMisses;
+
+    /// @}
+
+    ///
+    /// \brief Current values of parameters stored in log ring.
+    /// logSlot holds slot in which latest value of each parameter is stored, -1 if value
+    /// is stored only at its own address. logHead is slot written last and logSequence
+    /// its sequence number.
+    /// @{
+
+    uint8_t         logValue[DB_LOG_KEYS];
+    int8_t          logSlot[DB_LOG_KEYS];
+    uint8_t         logHead;
+    uint8_t         logSequence;
+
+    /// @}
+
+    ///
+    /// \brief Number of updates of each section since startup.
+    /// Sections are counted in order of blocks, see getSectionIndex.
+    ///
+    uint32_t        writeCount[DB_SECTIONS];
+
+    ///
+    /// \brief Number of log slots written since startup and number of values moved from
+    /// log ring to their own address because their slot has been reused.
+    /// @{
+
+    uint32_t        logSlotWrites;
+    uint32_t        logHomeWrites;
+
+    /// @}
+
+    ///
+    /// \brief Set if section addresses in DBMS match addresses known at compile time.
+    /// Memory is migrated only if they do (see Migration.cpp).
+    ///
+    bool            staticLayout;
+
+    ///
+    /// \brief Contents of schema record written last (see Schema.h).
+    ///
+    dbSchemaState_t schemaState;
+
+    ///
+    /// \brief Layout from which memory is being migrated.
+    ///
+    dbSchema_t      migrationSchema;
 };
 
 ///
@@ -27,87 +27,75 @@
 #include "Hardware.h"
 
 ///
-/// \brief Writes custom values in database.
+/// \brief Database layout, see Layout.h.
 ///
-void Database::writeCustomValues()
-{
-    initProgramSettings();
-    initScales();
-    initGlobalSettings();
-}
+extern dbBlock_t dbLayout[DB_BLOCKS];
 
 ///
-/// \brief Initializies program block in database with correct values.
+/// \brief Returns default value of parameter.
+/// Parameters which haven't been written since factory reset hold this value.
+/// Defaults which differ between parameters of same section are defined here,
+/// otherwise default value from database layout is used.
+/// \returns Default value.
 ///
-void Database::initProgramSettings()
+int32_t Database::getDefaultValue(uint8_t blockID, uint8_t sectionID, uint16_t parameterID)
 {
-    //init default active program
-    //programLastActiveProgramSection only has 1 parameter - index 0
-    database.update(DB_BLOCK_PROGRAM, programLastActiveProgramSection, 0, DEFAULT_ACTIVE_PROGRAM);
+    switch(blockID)
+    {
+        case DB_BLOCK_PROGRAM:
+        switch(sectionID)
+        {
+            case programLastActiveProgramSection:
+            return DEFAULT_ACTIVE_PROGRAM;
 
-    //init default active scales for programs
-    for (int i=0; i<NUMBER_OF_PROGRAMS; i++)
-        database.update(DB_BLOCK_PROGRAM, programLastActiveScaleSection, i, DEFAULT_ACTIVE_SCALE);
+            case programLastActiveScaleSection:
+            return DEFAULT_ACTIVE_SCALE;
 
-    //init global settings for all programs
-    for (int i=0; i<NUMBER_OF_PROGRAMS; i++)
-    {
-        for (int j=0; j<GLOBAL_PROGRAM_SETTINGS; j++)
-            database.update(DB_BLOCK_PROGRAM, programGlobalSettingsSection, j+(GLOBAL_PROGRAM_SETTINGS*i), defaultGlobalProgramSettingArray[j]);
-    }
+            case programGlobalSettingsSection:
+            return defaultGlobalProgramSettingArray[parameterID % GLOBAL_PROGRAM_SETTINGS];
 
-    //init local settings for all programs
-    for (int i=0; i<NUMBER_OF_PROGRAMS; i++)
-    {
-        for (int j=0; j<NUMBER_OF_PADS; j++)
-        {
-            for (int k=0; k<LOCAL_PROGRAM_SETTINGS; k++)
-            {
-                database.update(DB_BLOCK_PROGRAM, programLocalSettingsSection, (LOCAL_PROGRAM_SETTINGS*j+k) + (LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*i), defaultLocalProgramSettingArray[k]);
-            }
+            case programLocalSettingsSection:
+            return defaultLocalProgramSettingArray[parameterID % LOCAL_PROGRAM_SETTINGS];
+
+            default:
+            break;
         }
-    }
-}
+        break;
 
-///
-/// \brief Initializies scale block in database with correct values.
-///
-void Database::initScales()
-{
-    //init predefined scale settings
-    for (int i=0; i<NUMBER_OF_PROGRAMS; i++)
-    {
-        for (int j=0; j<PREDEFINED_SCALES; j++)
+        case DB_BLOCK_SCALE:
+        switch(sectionID)
         {
-            for (int k=0; k<PREDEFINED_SCALE_PARAMETERS; k++)
-            {
-                database.update(DB_BLOCK_SCALE, scalePredefinedSection, (PREDEFINED_SCALE_PARAMETERS*j+k) + (PREDEFINED_SCALE_PARAMETERS*PREDEFINED_SCALES*i), defaultPredefinedScaleParametersArray[k]);
-            }
+            case scalePredefinedSection:
+            return defaultPredefinedScaleParametersArray[parameterID % PREDEFINED_SCALE_PARAMETERS];
+
+            case scaleUserSection:
+            //all blank notes
+            return BLANK_NOTE;
+
+            default:
+            break;
         }
-    }
+        break;
 
-    //init user scale settings
-    for (int i=0; i<NUMBER_OF_USER_SCALES; i++)
-    {
-        for (int j=0; j<NUMBER_OF_PADS; j++)
+        case DB_BLOCK_GLOBAL_SETTINGS:
+        switch(sectionID)
         {
-            //all blank notes
-            for (int k=0; k<NOTES_PER_PAD; k++)
-                database.update(DB_BLOCK_SCALE, scaleUserSection, (NOTES_PER_PAD*j+k) + (NOTES_PER_PAD*NUMBER_OF_PADS*i), BLANK_NOTE);
+            case globalSettingsMIDI:
+            return defaultMIDIsettingArray[parameterID];
+
+            case globalSettingsVelocitySensitivity:
+            return defaultVelocitySettingsArray[parameterID];
+
+            default:
+            break;
         }
+        break;
+
+        default:
+        break;
     }
-}
 
-///
-/// \brief Initializies global settings block in database with correct values.
-///
-void Database::initGlobalSettings()
-{
-    //init midi settings
-    for (int i=0; i<MIDI_SETTINGS; i++)
-        database.update(DB_BLOCK_GLOBAL_SETTINGS, globalSettingsMIDI, i, defaultMIDIsettingArray[i]);
+    dbSection_t &section = dbLayout[blockID].section[sectionID];
 
-    //init pressure settings
-    for (int i=0; i<VELOCITY_SETTINGS; i++)
-        database.update(DB_BLOCK_GLOBAL_SETTINGS, globalSettingsVelocitySensitivity, i, defaultVelocitySettingsArray[i]);
+    return section.autoIncrement ? section.defaultValue + parameterID : section.defaultValue;
 }
@@ -24,6 +24,7 @@
 */
 
 #include "Database.h"
+#include "Address.h"
 #include "../interface/analog/pads/Pads.h"
 #include "constants/Pads.h" //from board
 
@@ -39,8 +40,8 @@ static dbSection_t programSections[PROGRAM_SECTIONS] =
 {
     //programLastActiveProgramSection
     {
-        .numberOfParameters = 1,
-        .parameterType = BYTE_PARAMETER,
+        .numberOfParameters = dbFormat(DB_BLOCK_PROGRAM, programLastActiveProgramSection).numberOfParameters,
+        .parameterType = dbFormat(DB_BLOCK_PROGRAM, programLastActiveProgramSection).parameterType,
         .preserveOnPartialReset = false,
         .defaultValue = 0,
         .autoIncrement = false,
@@ -49,8 +50,8 @@ static dbSection_t programSections[PROGRAM_SECTIONS] =
 
     //programLastActiveScaleSection
     {
-        .numberOfParameters = NUMBER_OF_PROGRAMS,
-        .parameterType = BYTE_PARAMETER,
+        .numberOfParameters = dbFormat(DB_BLOCK_PROGRAM, programLastActiveScaleSection).numberOfParameters,
+        .parameterType = dbFormat(DB_BLOCK_PROGRAM, programLastActiveScaleSection).parameterType,
         .preserveOnPartialReset = false,
         .defaultValue = 0,
         .autoIncrement = false,
@@ -59,8 +60,8 @@ static dbSection_t programSections[PROGRAM_SECTIONS] =
 
     //programGlobalSettingsSection
     {
-        .numberOfParameters = GLOBAL_PROGRAM_SETTINGS*NUMBER_OF_PROGRAMS,
-        .parameterType = BYTE_PARAMETER,
+        .numberOfParameters = dbFormat(DB_BLOCK_PROGRAM, programGlobalSettingsSection).numberOfParameters,
+        .parameterType = dbFormat(DB_BLOCK_PROGRAM, programGlobalSettingsSection).parameterType,
         .preserveOnPartialReset = false,
         .defaultValue = 0,
         .autoIncrement = false,
@@ -69,8 +70,8 @@ static dbSection_t programSections[PROGRAM_SECTIONS] =
 
     //programLocalSettingsSection
     {
-        .numberOfParameters = LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*NUMBER_OF_PROGRAMS,
-        .parameterType = BYTE_PARAMETER,
+        .numberOfParameters = dbFormat(DB_BLOCK_PROGRAM, programLocalSettingsSection).numberOfParameters,
+        .parameterType = dbFormat(DB_BLOCK_PROGRAM, programLocalSettingsSection).parameterType,
         .preserveOnPartialReset = false,
         .defaultValue = 0,
         .autoIncrement = false,
@@ -82,8 +83,8 @@ static dbSection_t scaleSections[SCALE_SECTIONS] =
 {
     //scalePredefinedSection
     {
-        .numberOfParameters = PREDEFINED_SCALE_PARAMETERS*PREDEFINED_SCALES*NUMBER_OF_PROGRAMS,
-        .parameterType = BYTE_PARAMETER,
+        .numberOfParameters = dbFormat(DB_BLOCK_SCALE, scalePredefinedSection).numberOfParameters,
+        .parameterType = dbFormat(DB_BLOCK_SCALE, scalePredefinedSection).parameterType,
         .preserveOnPartialReset = false,
         .defaultValue = 0,
         .autoIncrement = false,
@@ -92,8 +93,8 @@ static dbSection_t scaleSections[SCALE_SECTIONS] =
 
     //scaleUserSection
     {
-        .numberOfParameters = NUMBER_OF_PADS*NOTES_PER_PAD*NUMBER_OF_USER_SCALES,
-        .parameterType = BYTE_PARAMETER,
+        .numberOfParameters = dbFormat(DB_BLOCK_SCALE, scaleUserSection).numberOfParameters,
+        .parameterType = dbFormat(DB_BLOCK_SCALE, scaleUserSection).parameterType,
         .preserveOnPartialReset = false,
         .defaultValue = 0,
         .autoIncrement = false,
@@ -105,8 +106,8 @@ static dbSection_t padCalibrationSections[PAD_CALIBRATION_SECTIONS] =
 {
     //padCalibrationPressureUpperSection
     {
-        .numberOfParameters = NUMBER_OF_PADS,
-        .parameterType = WORD_PARAMETER,
+        .numberOfParameters = dbFormat(DB_BLOCK_PAD_CALIBRATION, padCalibrationPressureUpperSection).numberOfParameters,
+        .parameterType = dbFormat(DB_BLOCK_PAD_CALIBRATION, padCalibrationPressureUpperSection).parameterType,
         .preserveOnPartialReset = true,
         .defaultValue = VELOCITY_127_RAW_PRESSURE,
         .autoIncrement = false,
@@ -115,8 +116,8 @@ static dbSection_t padCalibrationSections[PAD_CALIBRATION_SECTIONS] =
 
     //padCalibrationXlowerSection
     {
-        .numberOfParameters = NUMBER_OF_PADS,
-        .parameterType = WORD_PARAMETER,
+        .numberOfParameters = dbFormat(DB_BLOCK_PAD_CALIBRATION, padCalibrationXlowerSection).numberOfParameters,
+        .parameterType = dbFormat(DB_BLOCK_PAD_CALIBRATION, padCalibrationXlowerSection).parameterType,
         .preserveOnPartialReset = true,
         .defaultValue = 175,
         .autoIncrement = false,
@@ -125,8 +126,8 @@ static dbSection_t padCalibrationSections[PAD_CALIBRATION_SECTIONS] =
 
     //padCalibrationXupperSection
     {
-        .numberOfParameters = NUMBER_OF_PADS,
-        .parameterType = WORD_PARAMETER,
+        .numberOfParameters = dbFormat(DB_BLOCK_PAD_CALIBRATION, padCalibrationXupperSection).numberOfParameters,
+        .parameterType = dbFormat(DB_BLOCK_PAD_CALIBRATION, padCalibrationXupperSection).parameterType,
         .preserveOnPartialReset = true,
         .defaultValue = 835,
         .autoIncrement = false,
@@ -135,8 +136,8 @@ static dbSection_t padCalibrationSections[PAD_CALIBRATION_SECTIONS] =
 
     //padCalibrationYlowerSection
     {
-        .numberOfParameters = NUMBER_OF_PADS,
-        .parameterType = WORD_PARAMETER,
+        .numberOfParameters = dbFormat(DB_BLOCK_PAD_CALIBRATION, padCalibrationYlowerSection).numberOfParameters,
+        .parameterType = dbFormat(DB_BLOCK_PAD_CALIBRATION, padCalibrationYlowerSection).parameterType,
         .preserveOnPartialReset = true,
         .defaultValue = 175,
         .autoIncrement = false,
@@ -145,8 +146,8 @@ static dbSection_t padCalibrationSections[PAD_CALIBRATION_SECTIONS] =
 
     //padCalibrationYupperSection
     {
-        .numberOfParameters = NUMBER_OF_PADS,
-        .parameterType = WORD_PARAMETER,
+        .numberOfParameters = dbFormat(DB_BLOCK_PAD_CALIBRATION, padCalibrationYupperSection).numberOfParameters,
+        .parameterType = dbFormat(DB_BLOCK_PAD_CALIBRATION, padCalibrationYupperSection).parameterType,
         .preserveOnPartialReset = true,
         .defaultValue = 835,
         .autoIncrement = false,
@@ -158,8 +159,8 @@ static dbSection_t globalSections[GLOBAL_SETTINGS_SECTIONS] =
 {
     //globalSettingsMIDI
     {
-        .numberOfParameters = MIDI_SETTINGS,
-        .parameterType = BYTE_PARAMETER,
+        .numberOfParameters = dbFormat(DB_BLOCK_GLOBAL_SETTINGS, globalSettingsMIDI).numberOfParameters,
+        .parameterType = dbFormat(DB_BLOCK_GLOBAL_SETTINGS, globalSettingsMIDI).parameterType,
         .preserveOnPartialReset = false,
         .defaultValue = 1,
         .autoIncrement = false,
@@ -168,8 +169,8 @@ static dbSection_t globalSections[GLOBAL_SETTINGS_SECTIONS] =
 
     //globalSettingsVelocity
     {
-        .numberOfParameters = VELOCITY_SETTINGS,
-        .parameterType = BYTE_PARAMETER,
+        .numberOfParameters = dbFormat(DB_BLOCK_GLOBAL_SETTINGS, globalSettingsVelocitySensitivity).numberOfParameters,
+        .parameterType = dbFormat(DB_BLOCK_GLOBAL_SETTINGS, globalSettingsVelocitySensitivity).parameterType,
         .preserveOnPartialReset = false,
         .defaultValue = 0,
         .autoIncrement = false,
@@ -180,8 +181,8 @@ static dbSection_t globalSections[GLOBAL_SETTINGS_SECTIONS] =
 static dbSection_t idSections[1] =
 {
     {
-        .numberOfParameters = NUM_OF_UID_BYTES,
-        .parameterType = BYTE_PARAMETER,
+        .numberOfParameters = dbFormat(DB_BLOCK_ID, 0).numberOfParameters,
+        .parameterType = dbFormat(DB_BLOCK_ID, 0).parameterType,
         .preserveOnPartialReset = 0,
         .defaultValue = UNIQUE_ID,
         .autoIncrement = false,
@@ -189,6 +190,45 @@ static dbSection_t idSections[1] =
     },
 };
 
+static dbSection_t programExtendedSections[PROGRAM_EXTENDED_SECTIONS] =
+{
+    //programExtendedSettingsSection
+    {
+        .numberOfParameters = dbFormat(DB_BLOCK_PROGRAM_EXTENDED, programExtendedSettingsSection).numberOfParameters,
+        .parameterType = dbFormat(DB_BLOCK_PROGRAM_EXTENDED, programExtendedSettingsSection).parameterType,
+        .preserveOnPartialReset = false,
+        .defaultValue = 0,
+        .autoIncrement = false,
+        .address = 0
+    },
+};
+
+static dbSection_t logSections[LOG_SECTIONS] =
+{
+    //logSlotSection
+    {
+        .numberOfParameters = dbFormat(DB_BLOCK_LOG, logSlotSection).numberOfParameters,
+        .parameterType = dbFormat(DB_BLOCK_LOG, logSlotSection).parameterType,
+        .preserveOnPartialReset = false,
+        .defaultValue = 0,
+        .autoIncrement = false,
+        .address = 0
+    },
+};
+
+static dbSection_t defaultMapSections[DEFAULT_MAP_SECTIONS] =
+{
+    //defaultMapSection
+    {
+        .numberOfParameters = dbFormat(DB_BLOCK_DEFAULT_MAP, defaultMapSection).numberOfParameters,
+        .parameterType = dbFormat(DB_BLOCK_DEFAULT_MAP, defaultMapSection).parameterType,
+        .preserveOnPartialReset = false,
+        .defaultValue = 0,
+        .autoIncrement = false,
+        .address = 0
+    },
+};
+
 /// @}
 
 ///
@@ -231,6 +271,27 @@ dbBlock_t dbLayout[DB_BLOCKS] =
         .numberOfSections = 1,
         .section = idSections,
     },
+
+    //extended program block
+    {
+        .address = 0,
+        .numberOfSections = PROGRAM_EXTENDED_SECTIONS,
+        .section = programExtendedSections,
+    },
+
+    //log block
+    {
+        .address = 0,
+        .numberOfSections = LOG_SECTIONS,
+        .section = logSections,
+    },
+
+    //default map block
+    {
+        .address = 0,
+        .numberOfSections = DEFAULT_MAP_SECTIONS,
+        .section = defaultMapSections,
+    },
 };
 
 /// @}
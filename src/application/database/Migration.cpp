@@ -0,0 +1,972 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#include <string.h>
+#include "Database.h"
+#include "board/Board.h"
+#include "core/src/general/BitManipulation.h"
+
+///
+/// \ingroup dbSchema
+/// @{
+
+//migration of memory written with older layout. Position of migration is stored in schema
+//record after every step, so that migration continues where it has stopped if power is lost.
+//EEPROM bytes are written in order in which they've been queued, so once record is written,
+//all bytes written before it are in memory as well. Migration of single byte depends only
+//on layouts, so every phase can be repeated from stored position, with exception of moves:
+//byte which has been moved can't be moved again once its source has been overwritten.
+//Because of that, position is stored before byte which is source of any byte moved since
+//position has been stored last is overwritten. Steps which haven't written or moved any
+//byte don't change memory, so their position isn't stored: they're repeated instead.
+
+///
+/// \brief Index of special sections in current layout.
+/// @{
+
+#define DB_ID_INDEX     dbSectionIndex(DB_BLOCK_ID, 0)
+#define DB_LOG_INDEX    dbSectionIndex(DB_BLOCK_LOG, logSlotSection)
+#define DB_MAP_INDEX    dbSectionIndex(DB_BLOCK_DEFAULT_MAP, defaultMapSection)
+
+/// @}
+
+///
+/// \brief Current layout.
+///
+static const dbSchema_t currentSchema = { DB_SCHEMA_VERSION, DB_SECTIONS, dbSectionFormat, NULL };
+
+///
+/// \brief Number of bytes written and examined in current migration step.
+/// stepStore is set if position needs to be stored after step.
+/// @{
+
+static uint8_t  stepWrites;
+static uint16_t stepBytes;
+static bool     stepStore;
+
+/// @}
+
+///
+/// \brief Returns check byte of schema record.
+///
+static uint8_t schemaCheck(const uint8_t *record)
+{
+    uint8_t check = DB_SCHEMA_CHECK_MASK;
+
+    for (int i=0; i<(DB_SCHEMA_RECORD_SIZE-1); i++)
+        check ^= record[i];
+
+    return check;
+}
+
+///
+/// \brief Reads single byte from board memory.
+///
+static uint8_t readByte(uint16_t address)
+{
+    int32_t value = 0;
+
+    Board::memoryRead(address, BYTE_PARAMETER, value);
+    return value;
+}
+
+///
+/// \brief Writes single byte to board memory if it differs.
+///
+static void writeByte(uint16_t address, uint8_t value)
+{
+    if (readByte(address) == value)
+        return;
+
+    Board::memoryWrite(address, value, BYTE_PARAMETER);
+    stepWrites++;
+    stepStore = true;
+}
+
+///
+/// \brief Checks whether current migration step is done.
+///
+static inline bool stepDone()
+{
+    return (stepWrites >= DB_MIGRATION_STEP_WRITES) || (stepBytes >= DB_MIGRATION_STEP_BYTES);
+}
+
+///
+/// \brief Returns format of section in layout.
+///
+static void schemaFormat(const dbSchema_t &schema, uint8_t index, dbSectionFormat_t &format)
+{
+    if (schema.version == DB_SCHEMA_VERSION)
+        format = dbSectionFormat[index];
+    else
+        memcpy_P(&format, &schema.format[index], sizeof(dbSectionFormat_t));
+}
+
+///
+/// \brief Returns index of section in current layout which holds parameters of section in layout.
+///
+static uint8_t schemaTarget(const dbSchema_t &schema, uint8_t index)
+{
+    if (schema.version == DB_SCHEMA_VERSION)
+        return index;
+
+    return pgm_read_byte(&schema.target[index]);
+}
+
+///
+/// \brief Returns size of memory used by layout in bytes.
+///
+static uint16_t schemaSize(const dbSchema_t &schema)
+{
+    dbSectionFormat_t format;
+    uint16_t size = 0;
+
+    for (int i=0; i<schema.numberOfSections; i++)
+    {
+        schemaFormat(schema, i, format);
+        size += dbFormatSize(format);
+    }
+
+    return size;
+}
+
+///
+/// \brief Finds section in layout to which memory address belongs.
+/// @param [in] schema      Layout.
+/// @param [in] address     Memory address.
+/// @param [in,out] index   Section index.
+/// @param [in,out] start   Memory address of section.
+/// @param [in,out] format  Format of section.
+/// \returns True if address belongs to any section, false otherwise.
+///
+static bool schemaSection(const dbSchema_t &schema, uint16_t address, uint8_t &index, uint16_t &start, dbSectionFormat_t &format)
+{
+    start = 0;
+
+    for (index=0; index<schema.numberOfSections; index++)
+    {
+        schemaFormat(schema, index, format);
+
+        if (address < (start+dbFormatSize(format)))
+            return true;
+
+        start += dbFormatSize(format);
+    }
+
+    return false;
+}
+
+///
+/// \brief Finds section in layout which holds parameters of section in current layout.
+/// @param [in] schema      Layout.
+/// @param [in] target      Section index in current layout.
+/// @param [in,out] start   Memory address of section in layout.
+/// @param [in,out] format  Format of section in layout.
+/// \returns True if section exists in layout, false otherwise.
+///
+static bool schemaSource(const dbSchema_t &schema, uint8_t target, uint16_t &start, dbSectionFormat_t &format)
+{
+    start = 0;
+
+    for (int i=0; i<schema.numberOfSections; i++)
+    {
+        schemaFormat(schema, i, format);
+
+        if (schemaTarget(schema, i) == target)
+            return true;
+
+        start += dbFormatSize(format);
+    }
+
+    return false;
+}
+
+///
+/// \brief Maps memory offset in section with one format to offset in section with other format.
+/// Parameter keeps its record and its place in record. Sections with bit and half-byte
+/// parameters are mapped byte by byte.
+/// @param [in] from        Format of section in which offset is.
+/// @param [in] offset      Memory offset from start of section.
+/// @param [in] to          Format of section to which offset is mapped.
+/// @param [in,out] mapped  Memory offset from start of other section.
+/// \returns True if parameter exists in both sections, false otherwise.
+///
+static bool mapOffset(const dbSectionFormat_t &from, uint16_t offset, const dbSectionFormat_t &to, uint16_t &mapped)
+{
+    if (from.parameterType != to.parameterType)
+        return false;
+
+    if ((from.parameterType == BIT_PARAMETER) || (from.parameterType == HALFBYTE_PARAMETER))
+    {
+        mapped = offset;
+        return (offset < dbFormatSize(to));
+    }
+
+    uint8_t size = dbParameterSize(from.parameterType);
+    uint16_t parameter = offset / size;
+    uint16_t fromRecordSize = from.numberOfParameters / from.records;
+    uint16_t toRecordSize = to.numberOfParameters / to.records;
+    uint16_t record = parameter / fromRecordSize;
+    uint16_t place = parameter % fromRecordSize;
+
+    if ((record >= to.records) || (place >= toRecordSize))
+        return false;
+
+    mapped = ((uint16_t)record*toRecordSize + place)*size + offset%size;
+    return true;
+}
+
+///
+/// \brief Finds memory address in layout from which byte in current layout is migrated.
+/// Log ring and default map are never migrated.
+/// @param [in] schema      Layout from which memory is migrated.
+/// @param [in] address     Memory address in current layout.
+/// @param [in,out] source  Memory address in layout.
+/// \returns True if byte is migrated, false otherwise.
+///
+static bool migrationSource(const dbSchema_t &schema, uint16_t address, uint16_t &source)
+{
+    uint8_t index;
+    uint16_t start, sourceStart, offset;
+    dbSectionFormat_t format, sourceFormat;
+
+    if (!schemaSection(currentSchema, address, index, start, format))
+        return false;
+
+    if ((index == DB_LOG_INDEX) || (index == DB_MAP_INDEX))
+        return false;
+
+    if (!schemaSource(schema, index, sourceStart, sourceFormat))
+        return false;
+
+    if (!mapOffset(format, address-start, sourceFormat, offset))
+        return false;
+
+    source = sourceStart + offset;
+    return true;
+}
+
+///
+/// \brief Finds memory address in current layout to which byte in layout belongs.
+/// @param [in] schema      Layout from which memory is migrated.
+/// @param [in] address     Memory address in layout.
+/// @param [in,out] target  Memory address in current layout.
+/// \returns True if byte exists in current layout, false otherwise.
+///
+static bool migrationTarget(const dbSchema_t &schema, uint16_t address, uint16_t &target)
+{
+    uint8_t index;
+    uint16_t start, targetStart, offset;
+    dbSectionFormat_t format, targetFormat;
+
+    if (!schemaSection(schema, address, index, start, format))
+        return false;
+
+    index = schemaTarget(schema, index);
+
+    if (index == DB_SCHEMA_NO_SECTION)
+        return false;
+
+    if (!schemaSource(currentSchema, index, targetStart, targetFormat))
+        return false;
+
+    if (!mapOffset(format, address-start, targetFormat, offset))
+        return false;
+
+    target = targetStart + offset;
+    return true;
+}
+
+///
+/// \brief Checks whether layout is stored in memory by checking its ID block.
+///
+static bool schemaSignature(const dbSchema_t &schema)
+{
+    uint16_t start;
+    dbSectionFormat_t format;
+
+    if (!schemaSource(schema, DB_ID_INDEX, start, format) || (format.numberOfParameters < NUM_OF_UID_BYTES))
+        return false;
+
+    //default values aren't applied, ID is always written
+    for (int i=0; i<NUM_OF_UID_BYTES; i++)
+    {
+        if (readByte(start+i) != UNIQUE_ID)
+            return false;
+    }
+
+    return true;
+}
+
+///
+/// \brief Checks whether memory address belongs to default map in current layout.
+///
+static inline bool mapByte(uint16_t address)
+{
+    return (address >= dbSectionAddress(DB_MAP_INDEX)) && (address < (dbSectionAddress(DB_MAP_INDEX)+DB_DEFAULT_MAP_SIZE));
+}
+
+///
+/// \brief Checks whether memory chunk in current layout holds only parameters which aren't
+/// migrated, in which case it's marked as holding default values instead of being written.
+/// Chunks of default map are always written.
+///
+static bool chunkDefault(const dbSchema_t &schema, uint16_t chunk)
+{
+    uint16_t start = chunk*DB_DEFAULT_CHUNK_SIZE;
+    uint16_t size = dbSectionAddress(DB_SECTIONS);
+    uint16_t source;
+
+    for (uint16_t i=start; (i<(start+DB_DEFAULT_CHUNK_SIZE)) && (i<size); i++)
+    {
+        if (mapByte(i))
+            return false;
+
+        if (migrationSource(schema, i, source))
+            return false;
+    }
+
+    return true;
+}
+
+///
+/// \brief Checks whether memory chunk which holds default values in layout keeps its bit
+/// in default map, instead of its default values being written in defaults phase.
+/// Default map and every byte in chunk need to stay in place. Chunk can't hold log ring
+/// or parameters stored in it either, since those are written in log phase.
+///
+static bool chunkKept(const dbSchema_t &schema, uint16_t chunk)
+{
+    uint16_t start = chunk*DB_DEFAULT_CHUNK_SIZE;
+    uint16_t sectionStart, address;
+    dbSectionFormat_t format;
+    uint8_t index;
+
+    if (!schemaSource(schema, DB_MAP_INDEX, sectionStart, format))
+        return false;
+
+    if ((sectionStart != dbSectionAddress(DB_MAP_INDEX)) || (dbFormatSize(format) != DB_DEFAULT_MAP_SIZE))
+        return false;
+
+    for (uint16_t i=start; i<(start+DB_DEFAULT_CHUNK_SIZE); i++)
+    {
+        if (mapByte(i))
+            return false;
+
+        if (schemaSection(schema, i, index, sectionStart, format))
+        {
+            index = schemaTarget(schema, index);
+
+            if (index == DB_LOG_INDEX)
+                return false;
+
+            for (uint8_t j=0; j<DB_LOG_SECTIONS; j++)
+            {
+                if (index == dbSectionIndex(dbLogSections[j].block, dbLogSections[j].section))
+                    return false;
+            }
+        }
+
+        if (migrationTarget(schema, i, address) && (address != i))
+            return false;
+
+        if (migrationSource(schema, i, address) && (address != i))
+            return false;
+    }
+
+    return true;
+}
+
+///
+/// \brief Returns value of default map byte in current layout once memory is migrated.
+/// Bit is set for each chunk which holds only parameters which aren't migrated, and kept
+/// for each chunk which holds default values in layout and stays in place (see chunkKept).
+/// Default map of layout is then at the same address, so its byte is read from there.
+///
+static uint8_t mapValue(const dbSchema_t &schema, uint16_t address)
+{
+    uint8_t value = 0;
+    uint8_t kept = readByte(address);
+
+    for (int i=0; i<8; i++)
+    {
+        uint16_t chunk = (address-dbSectionAddress(DB_MAP_INDEX))*8+i;
+
+        if (chunkDefault(schema, chunk) || (BIT_READ(kept, i) && chunkKept(schema, chunk)))
+            BIT_SET(value, i);
+    }
+
+    return value;
+}
+
+/// @}
+
+///
+/// \brief Reads schema record and checks whether memory needs to be migrated.
+/// Memory written before schema records have been introduced is recognized by ID block
+/// of older layout. Current layout always writes schema record, so its ID block is
+/// checked only if none of older layouts matches.
+///
+void Database::initSchema()
+{
+    uint8_t record[DB_SCHEMA_RECORDS][DB_SCHEMA_RECORD_SIZE];
+    int8_t newest = -1;
+
+    for (int i=0; i<DB_SCHEMA_RECORDS; i++)
+    {
+        Board::memoryReadBlock(DB_SCHEMA_ADDRESS+i*DB_SCHEMA_RECORD_SIZE, record[i], DB_SCHEMA_RECORD_SIZE);
+
+        if (record[i][DB_SCHEMA_RECORD_SIZE-1] != schemaCheck(record[i]))
+            continue;
+
+        if ((newest == -1) || ((int8_t)(record[i][0] - record[newest][0]) > 0))
+            newest = i;
+    }
+
+    schemaState.sequence = 0;
+    schemaState.version = DB_SCHEMA_NONE;
+    schemaState.source = DB_SCHEMA_NONE;
+    schemaState.phase = 0;
+    schemaState.position = 0;
+
+    if (newest != -1)
+    {
+        schemaState.sequence = record[newest][0];
+        schemaState.version = record[newest][1];
+        schemaState.source = record[newest][2];
+        schemaState.phase = record[newest][3];
+        schemaState.position = record[newest][4] | ((uint16_t)record[newest][5] << 8);
+    }
+
+    if (schemaState.source != DB_SCHEMA_NONE)
+    {
+        //continue migration, migration to other layout can't be continued
+        if ((schemaState.version != DB_SCHEMA_VERSION) || !loadSchema(schemaState.source))
+        {
+            schemaState.version = DB_SCHEMA_NONE;
+            schemaState.source = DB_SCHEMA_NONE;
+        }
+
+        return;
+    }
+
+    if (schemaState.version == DB_SCHEMA_VERSION)
+        return;
+
+    if ((newest != -1) && (schemaState.version != DB_SCHEMA_NONE))
+    {
+        if (loadSchema(schemaState.version))
+            setSchema(DB_SCHEMA_VERSION, migrationSchema.version, dbMigrationDefaults, 0);
+
+        return;
+    }
+
+    if (!staticLayout)
+        return;
+
+    //ID block of older layout can be placed at the same address as in current layout
+    for (int i=DB_SCHEMA_HISTORY-1; i>=0; i--)
+    {
+        if (loadSchema(pgm_read_byte(&dbSchemaHistory[i].version)) && schemaSignature(migrationSchema))
+        {
+            #ifdef DEBUG
+            printf_P(PSTR("Migrating memory from schema %d\n"), migrationSchema.version);
+            #endif
+            setSchema(DB_SCHEMA_VERSION, migrationSchema.version, dbMigrationDefaults, 0);
+            return;
+        }
+    }
+
+    if (schemaSignature(currentSchema))
+        setSchema(DB_SCHEMA_VERSION, DB_SCHEMA_NONE, 0, 0);
+}
+
+///
+/// \brief Loads layout from which memory is migrated.
+/// Sections which are kept need to be in the same order and layout needs to fit into
+/// memory. Layout can be migrated only if DBMS places sections one after another.
+/// @param [in] version Schema version.
+/// \returns True if layout is known and can be migrated, false otherwise.
+///
+bool Database::loadSchema(uint8_t version)
+{
+    bool found = false;
+
+    if (!staticLayout)
+        return false;
+
+    if (version == DB_SCHEMA_VERSION)
+    {
+        migrationSchema = currentSchema;
+        found = true;
+    }
+    else
+    {
+        for (int i=0; i<DB_SCHEMA_HISTORY; i++)
+        {
+            if (pgm_read_byte(&dbSchemaHistory[i].version) == version)
+            {
+                memcpy_P(&migrationSchema, &dbSchemaHistory[i], sizeof(dbSchema_t));
+                found = true;
+                break;
+            }
+        }
+    }
+
+    if (!found)
+        return false;
+
+    if (schemaSize(migrationSchema) > DB_SCHEMA_ADDRESS)
+        return false;
+
+    int16_t last = -1;
+
+    for (int i=0; i<migrationSchema.numberOfSections; i++)
+    {
+        uint8_t target = schemaTarget(migrationSchema, i);
+
+        if (target == DB_SCHEMA_NO_SECTION)
+            continue;
+
+        if ((target >= DB_SECTIONS) || (target <= last))
+            return false;
+
+        last = target;
+    }
+
+    return true;
+}
+
+///
+/// \brief Writes schema record if any of its values has changed.
+/// Record is written in place of older record.
+/// @param [in] version     Schema version of memory.
+/// @param [in] source      Schema version from which memory is migrated, DB_SCHEMA_NONE if none.
+/// @param [in] phase       Migration phase. See dbMigrationPhase_t enumeration.
+/// @param [in] position    Migration position in current phase.
+///
+void Database::setSchema(uint8_t version, uint8_t source, uint8_t phase, uint16_t position)
+{
+    if ((schemaState.version == version) && (schemaState.source == source) && (schemaState.phase == phase) && (schemaState.position == position))
+        return;
+
+    schemaState.sequence++;
+    schemaState.version = version;
+    schemaState.source = source;
+    schemaState.phase = phase;
+    schemaState.position = position;
+
+    uint8_t record[DB_SCHEMA_RECORD_SIZE] =
+    {
+        schemaState.sequence,
+        schemaState.version,
+        schemaState.source,
+        schemaState.phase,
+        (uint8_t)(position & 0xFF),
+        (uint8_t)(position >> 8),
+        0
+    };
+
+    record[DB_SCHEMA_RECORD_SIZE-1] = schemaCheck(record);
+
+    //check byte is written last
+    for (int i=0; i<DB_SCHEMA_RECORD_SIZE; i++)
+        Board::memoryWrite(DB_SCHEMA_ADDRESS+(schemaState.sequence%DB_SCHEMA_RECORDS)*DB_SCHEMA_RECORD_SIZE+i, record[i], BYTE_PARAMETER);
+}
+
+///
+/// \brief Checks whether memory holds older layout which needs to be migrated (see migrate).
+///
+bool Database::migrationPending()
+{
+    return (schemaState.source != DB_SCHEMA_NONE);
+}
+
+///
+/// \brief Checks whether migration needs to be done before database can be used.
+/// Once only default map of current layout remains to be written, parameters are read
+/// from current layout and rest of migration is done from main loop (see updateMigration).
+///
+bool Database::migrationBlocked()
+{
+    return migrationPending() && (schemaState.phase < dbMigrationMap);
+}
+
+///
+/// \brief Performs single migration step if only default map remains to be written.
+/// Needs to be called from main loop while pads are idle. Step is done only if memory
+/// isn't busy, so that its writes don't wait for EEPROM.
+/// \returns True if step has been done, false otherwise.
+///
+bool Database::updateMigration()
+{
+    if (!migrationPending() || migrationBlocked())
+        return false;
+
+    if (!Board::memoryReady())
+        return false;
+
+    migrate();
+    return true;
+}
+
+///
+/// \brief Prepares database for use while default map of current layout is being written.
+/// Default map is kept in RAM until then, so that chunks which hold only parameters which
+/// aren't migrated are read as defaults. Log ring is in such chunks as well.
+///
+void Database::initMigrationMap()
+{
+    uint8_t map[DB_DEFAULT_MAP_SIZE];
+
+    for (int i=0; i<DB_DEFAULT_MAP_SIZE; i++)
+        map[i] = mapValue(migrationSchema, dbSectionAddress(DB_MAP_INDEX)+i);
+
+    setDefaultMap(map);
+    initLog();
+}
+
+///
+/// \brief Performs single step of memory migration to current layout.
+/// Each step writes up to DB_MIGRATION_STEP_WRITES bytes or examines up to
+/// DB_MIGRATION_STEP_BYTES bytes, after which migration position is stored if
+/// step has changed memory.
+/// Once migration is done, database is initialized with current layout.
+/// \returns True if migration is done, false otherwise.
+///
+bool Database::migrate()
+{
+    if (!migrationPending())
+        return true;
+
+    bool done = false;
+    uint16_t position = schemaState.position;
+
+    stepWrites = 0;
+    stepBytes = 0;
+    stepStore = false;
+
+    switch(schemaState.phase)
+    {
+        case dbMigrationDefaults:
+        done = migrateDefaults(position);
+        break;
+
+        case dbMigrationLog:
+        done = migrateLog(position);
+        break;
+
+        case dbMigrationMoveDown:
+        done = migrateMove(false, position);
+        break;
+
+        case dbMigrationMoveUp:
+        done = migrateMove(true, position);
+        break;
+
+        case dbMigrationFill:
+        done = migrateFill(position);
+        break;
+
+        case dbMigrationMap:
+        done = migrateMap(position);
+        break;
+
+        default:
+        done = true;
+        break;
+    }
+
+    if (!done)
+    {
+        if (stepStore)
+            setSchema(schemaState.version, schemaState.source, schemaState.phase, position);
+        else
+            schemaState.position = position;
+
+        return false;
+    }
+
+    if ((schemaState.phase+1) < DB_MIGRATION_PHASES)
+    {
+        setSchema(schemaState.version, schemaState.source, schemaState.phase+1, 0);
+
+        if (schemaState.phase == dbMigrationMap)
+            initMigrationMap();
+
+        return false;
+    }
+
+    setSchema(DB_SCHEMA_VERSION, DB_SCHEMA_NONE, 0, 0);
+
+    #ifdef DEBUG
+    printf_P(PSTR("Memory migrated to schema %d\n"), DB_SCHEMA_VERSION);
+    #endif
+
+    invalidateProgramCache();
+    initDefaultMap();
+    initLog();
+
+    return true;
+}
+
+///
+/// \brief Writes default values of all chunks which hold default values in source layout,
+/// apart from chunks which stay in place and keep their bit in default map (see chunkKept).
+/// Chunks are written the same way as in current layout (see writeDefaults), while
+/// memory still holds source layout. Log ring defaults to empty slots.
+/// @param [in,out] chunk   Next chunk which is checked.
+/// \returns True once all chunks are written, false otherwise.
+///
+bool Database::migrateDefaults(uint16_t &chunk)
+{
+    uint16_t mapStart, logStart, target;
+    dbSectionFormat_t mapFormat, logFormat;
+    uint16_t size = schemaSize(migrationSchema);
+
+    if (!schemaSource(migrationSchema, DB_MAP_INDEX, mapStart, mapFormat))
+        return true;
+
+    if (!schemaSource(migrationSchema, DB_LOG_INDEX, logStart, logFormat))
+        logFormat.numberOfParameters = 0;
+
+    for (; (uint32_t)chunk*DB_DEFAULT_CHUNK_SIZE < size; chunk++)
+    {
+        if (stepDone())
+            return false;
+
+        uint8_t map = readByte(mapStart+chunk/8);
+
+        stepBytes++;
+
+        if (!BIT_READ(map, chunk%8))
+            continue;
+
+        stepBytes += DB_DEFAULT_CHUNK_SIZE;
+
+        if (chunkKept(migrationSchema, chunk))
+            continue;
+
+        for (uint16_t i=chunk*DB_DEFAULT_CHUNK_SIZE; (i<((chunk+1)*DB_DEFAULT_CHUNK_SIZE)) && (i<size); i++)
+        {
+            stepBytes++;
+
+            if ((i >= logStart) && (i < (logStart+dbFormatSize(logFormat))))
+                writeByte(i, 0);
+            else if (migrationTarget(migrationSchema, i, target))
+                writeByte(i, getDefaultByte(target));
+        }
+
+        BIT_CLEAR(map, chunk%8);
+        writeByte(mapStart+chunk/8, map);
+    }
+
+    return true;
+}
+
+///
+/// \brief Writes latest value of each parameter in log ring of source layout to its own address.
+/// Slots are applied from newest to oldest one, skipping parameters which have already been written.
+/// @param [in,out] position    Number of slots which have been applied.
+/// \returns True once all slots are applied, false otherwise.
+///
+bool Database::migrateLog(uint16_t &position)
+{
+    uint16_t logStart, start;
+    dbSectionFormat_t logFormat, format;
+    uint8_t head, sequence;
+    uint8_t keys = 0;
+    uint8_t written[32];
+
+    if (!schemaSource(migrationSchema, DB_LOG_INDEX, logStart, logFormat))
+        return true;
+
+    for (uint8_t i=0; i<DB_LOG_SECTIONS; i++)
+    {
+        if (schemaSource(migrationSchema, dbSectionIndex(dbLogSections[i].block, dbLogSections[i].section), start, format))
+            keys += format.numberOfParameters;
+    }
+
+    if (!findLogHead(logStart, logFormat.numberOfParameters, keys, head, sequence))
+        return true;
+
+    memset(written, 0, sizeof(written));
+
+    for (uint16_t i=0; i<logFormat.numberOfParameters; i++)
+    {
+        uint8_t slot = (head+logFormat.numberOfParameters-i) % logFormat.numberOfParameters;
+        int32_t entry = 0;
+
+        Board::memoryRead(logStart+(uint32_t)slot*sizeof(entry), DWORD_PARAMETER, entry);
+
+        if (!logEntryValid(entry, keys))
+            continue;
+
+        uint8_t key = entry >> 8;
+
+        if (BIT_READ(written[key/8], key%8))
+            continue;
+
+        BIT_SET(written[key/8], key%8);
+
+        //slots before position have been applied already
+        if (i < position)
+            continue;
+
+        if (stepDone())
+            return false;
+
+        for (uint8_t j=0; j<DB_LOG_SECTIONS; j++)
+        {
+            if (!schemaSource(migrationSchema, dbSectionIndex(dbLogSections[j].block, dbLogSections[j].section), start, format))
+                continue;
+
+            if (key < format.numberOfParameters)
+            {
+                writeByte(start+key, entry >> 16);
+                break;
+            }
+
+            key -= format.numberOfParameters;
+        }
+
+        position = i+1;
+    }
+
+    return true;
+}
+
+///
+/// \brief Moves bytes of current layout from their address in source layout.
+/// Bytes which move to lower addresses are moved in ascending order and bytes which move to
+/// higher addresses in descending order, so that each byte is moved before it's overwritten.
+/// Order of bytes is the same in both layouts, so bytes which move in different directions
+/// never overwrite each other.
+/// @param [in] up              If set to true, bytes which move to higher addresses are moved.
+/// @param [in,out] position    Number of bytes which have been checked.
+/// \returns True once all bytes are moved, false otherwise.
+///
+bool Database::migrateMove(bool up, uint16_t &position)
+{
+    uint16_t size = dbSectionAddress(DB_SECTIONS);
+    uint16_t sourceLow = 0, sourceHigh = 0;
+    bool window = false;
+
+    for (; position<size; position++)
+    {
+        uint16_t address = up ? size-1-position : position;
+        uint16_t source;
+
+        if (stepDone())
+            return false;
+
+        stepBytes++;
+
+        if (!migrationSource(migrationSchema, address, source))
+            continue;
+
+        if (up ? (source >= address) : (source <= address))
+            continue;
+
+        //byte which already holds its value is moved as well
+        stepStore = true;
+
+        //bytes moved since position has been stored can't be moved again once their source is overwritten
+        if (window && (address >= sourceLow) && (address <= sourceHigh))
+        {
+            setSchema(schemaState.version, schemaState.source, schemaState.phase, position);
+            window = false;
+        }
+
+        writeByte(address, readByte(source));
+
+        if (!window || (source < sourceLow))
+            sourceLow = source;
+
+        if (!window || (source > sourceHigh))
+            sourceHigh = source;
+
+        window = true;
+    }
+
+    return true;
+}
+
+///
+/// \brief Writes bytes of current layout which aren't migrated.
+/// Chunks which hold only such bytes are marked as holding default values instead
+/// once default map is written (see migrateMap).
+/// @param [in,out] chunk   Next chunk which is written.
+/// \returns True once all chunks are written, false otherwise.
+///
+bool Database::migrateFill(uint16_t &chunk)
+{
+    uint16_t size = dbSectionAddress(DB_SECTIONS);
+
+    for (; (uint32_t)chunk*DB_DEFAULT_CHUNK_SIZE < size; chunk++)
+    {
+        if (stepDone())
+            return false;
+
+        stepBytes += DB_DEFAULT_CHUNK_SIZE;
+
+        if (chunkDefault(migrationSchema, chunk))
+            continue;
+
+        for (uint16_t i=chunk*DB_DEFAULT_CHUNK_SIZE; (i<((chunk+1)*DB_DEFAULT_CHUNK_SIZE)) && (i<size); i++)
+        {
+            uint16_t source;
+
+            if (mapByte(i) || migrationSource(migrationSchema, i, source))
+                continue;
+
+            writeByte(i, getDefaultByte(i));
+        }
+    }
+
+    return true;
+}
+
+///
+/// \brief Writes default map of current layout.
+/// @param [in,out] position    Next byte of default map which is written.
+/// \returns True once default map is written, false otherwise.
+///
+bool Database::migrateMap(uint16_t &position)
+{
+    uint16_t mapStart = dbSectionAddress(DB_MAP_INDEX);
+
+    for (; position<DB_DEFAULT_MAP_SIZE; position++)
+    {
+        if (stepDone())
+            return false;
+
+        //each map byte is set from eight chunks
+        stepBytes += 8*DB_DEFAULT_CHUNK_SIZE;
+        writeByte(mapStart+position, mapValue(migrationSchema, mapStart+position));
+    }
+
+    return true;
+}
@@ -0,0 +1,188 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#pragma once
+
+#include <avr/pgmspace.h>
+#include "Address.h"
+
+///
+/// \defgroup dbSchema Schema
+/// \ingroup database
+/// @{
+
+///
+/// \brief Version of current database layout (see Address.h).
+/// Needs to be increased on every change of layout, in which case layout used until
+/// then needs to be added to schema history below. Memory written with any layout
+/// from history is migrated to current layout on startup instead of being reset.
+///
+#define DB_SCHEMA_VERSION           1
+
+///
+/// \brief Value used for schema version when memory doesn't hold known layout,
+/// and for source version when migration isn't in progress.
+///
+#define DB_SCHEMA_NONE              0xFF
+
+///
+/// \brief Value used in schema history for sections which have been removed from layout.
+///
+#define DB_SCHEMA_NO_SECTION        0xFF
+
+///
+/// \brief Schema record.
+/// Record holds sequence number, schema version, source schema version, migration phase,
+/// migration position (two bytes) and check byte, in that order. Two records are kept
+/// and written in turns, with check byte written last, so that record which hasn't been
+/// fully written is invalid and the other one is used instead. Records are placed at
+/// the end of database memory so that their address doesn't depend on layout.
+/// @{
+
+#define DB_SCHEMA_RECORD_SIZE       7
+#define DB_SCHEMA_RECORDS           2
+#define DB_SCHEMA_ADDRESS           (LESSDB_SIZE-DB_SCHEMA_RECORDS*DB_SCHEMA_RECORD_SIZE)
+#define DB_SCHEMA_CHECK_MASK        0x5A
+
+/// @}
+
+static_assert(dbSectionAddress(DB_SECTIONS) <= DB_SCHEMA_ADDRESS, "Database layout overlaps schema records");
+
+///
+/// \brief Maximum number of memory bytes written and examined in single migration step.
+/// @{
+
+#define DB_MIGRATION_STEP_WRITES    16
+#define DB_MIGRATION_STEP_BYTES     256
+
+/// @}
+
+///
+/// \brief List of all migration phases, in order in which they're done.
+/// Default map and log ring of source layout are applied while memory still holds source
+/// layout. Bytes which move to lower addresses are then moved in ascending order, bytes
+/// which move to higher addresses in descending order, and parameters which don't exist in
+/// source layout are set to their default values at the end. Chunks which hold only such
+/// parameters are marked in default map instead, which is written last. Database can be
+/// used while default map is written (see Database::migrationBlocked).
+/// Chunks which hold default values and stay in place keep their bit in default map, so
+/// phases done before database can be used only write bytes which move, chunks of log ring
+/// and parameters stored in it, and parts of chunks which are partly migrated. Sections of
+/// layouts in history should stay in place for that reason, with new sections added after
+/// them, which keeps startup blocked for well below one second.
+///
+typedef enum
+{
+    dbMigrationDefaults,
+    dbMigrationLog,
+    dbMigrationMoveDown,
+    dbMigrationMoveUp,
+    dbMigrationFill,
+    dbMigrationMap,
+    DB_MIGRATION_PHASES
+} dbMigrationPhase_t;
+
+///
+/// \brief Contents of schema record.
+///
+typedef struct
+{
+    uint8_t     sequence;
+    uint8_t     version;
+    uint8_t     source;
+    uint8_t     phase;
+    uint16_t    position;
+} dbSchemaState_t;
+
+///
+/// \brief Single database layout.
+/// Format of each section and index of section in current layout which holds its parameters
+/// (DB_SCHEMA_NO_SECTION if section has been removed), both stored in flash. Sections which
+/// are kept need to stay in the same order. Sections are placed one after another, same
+/// as DBMS places them.
+///
+typedef struct
+{
+    uint8_t                 version;
+    uint8_t                 numberOfSections;
+    const dbSectionFormat_t *format;
+    const uint8_t           *target;
+} dbSchema_t;
+
+///
+/// \brief Layout of schema version 0.
+/// Released layout without log ring, default map and extended program block.
+/// Numbers are written out so that they don't follow later changes.
+/// @{
+
+const dbSectionFormat_t dbSchema0Format[] PROGMEM =
+{
+    //program block
+    { 1,                                                                BYTE_PARAMETER,  1 },       //programLastActiveProgramSection
+    { 15,                                                               BYTE_PARAMETER,  15 },      //programLastActiveScaleSection
+    { 16*15,                                                            BYTE_PARAMETER,  15 },      //programGlobalSettingsSection
+    { 15*9*15,                                                          BYTE_PARAMETER,  15 },      //programLocalSettingsSection
+
+    //scale block
+    { 3*7*15,                                                           BYTE_PARAMETER,  15 },      //scalePredefinedSection
+    { 9*7*10,                                                           BYTE_PARAMETER,  10 },      //scaleUserSection
+
+    //pad calibration block
+    { 9,                                                                WORD_PARAMETER,  1 },       //padCalibrationPressureUpperSection
+    { 9,                                                                WORD_PARAMETER,  1 },       //padCalibrationXlowerSection
+    { 9,                                                                WORD_PARAMETER,  1 },       //padCalibrationXupperSection
+    { 9,                                                                WORD_PARAMETER,  1 },       //padCalibrationYlowerSection
+    { 9,                                                                WORD_PARAMETER,  1 },       //padCalibrationYupperSection
+
+    //global block
+    { 8,                                                                BYTE_PARAMETER,  1 },       //globalSettingsMIDI
+    { 2,                                                                BYTE_PARAMETER,  1 },       //globalSettingsVelocitySensitivity
+
+    //id block
+    { 10,                                                               BYTE_PARAMETER,  1 },
+};
+
+const uint8_t dbSchema0Target[] PROGMEM =
+{
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13
+};
+
+/// @}
+
+///
+/// \brief All previous layouts.
+/// Current layout is schema DB_SCHEMA_VERSION with all sections in place and isn't listed.
+///
+const dbSchema_t dbSchemaHistory[] PROGMEM =
+{
+    { 0, sizeof(dbSchema0Format)/sizeof(dbSectionFormat_t), dbSchema0Format, dbSchema0Target },
+};
+
+///
+/// \brief Number of previous layouts.
+///
+#define DB_SCHEMA_HISTORY   ((int)(sizeof(dbSchemaHistory)/sizeof(dbSchema_t)))
+
+/// @}
@@ -0,0 +1,218 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#include <string.h>
+#include "WriteCache.h"
+#include "board/Board.h"
+#include "core/src/general/Timing.h"
+
+///
+/// \ingroup database
+/// @{
+
+///
+/// \brief Returns size of parameter in memory, in bytes.
+///
+static uint8_t parameterSize(sectionParameterType_t type)
+{
+    switch(type)
+    {
+        case WORD_PARAMETER:
+        return 2;
+
+        case DWORD_PARAMETER:
+        return 4;
+
+        default:
+        return 1;
+    }
+}
+
+///
+/// \brief Default constructor.
+///
+WriteCache::WriteCache()
+{
+    count = 0;
+    drainCount = 0;
+    lastWriteTime = 0;
+}
+
+///
+/// \brief Stores parameter into cache.
+/// If cache is full, oldest parameter is written to memory first.
+/// @param [in] address Memory address in which value is being written.
+/// @param [in] value   Value to write.
+/// @param [in] type    Type of parameter which is being written.
+/// \returns True on success, false otherwise.
+///
+bool WriteCache::write(uint32_t address, int32_t value, sectionParameterType_t type)
+{
+    lastWriteTime = rTimeMs();
+
+    for (int i=0; i<count; i++)
+    {
+        if (entry[i].address == address)
+        {
+            //parameter at same address always has same type
+            entry[i].value = value;
+            return true;
+        }
+    }
+
+    if (count == WRITE_CACHE_SIZE)
+    {
+        if (!flushOldest())
+            return false;
+    }
+
+    entry[count].address = address;
+    entry[count].type = type;
+    entry[count].value = value;
+    entry[count].writeTime = lastWriteTime;
+    count++;
+
+    return true;
+}
+
+///
+/// \brief Reads parameter from cache.
+/// @param [in] address     Memory address from which value is being read.
+/// @param [in] type        Type of parameter which is being read.
+/// @param [in,out] value   Variable in which read value is stored.
+/// \returns True if parameter is dirty and has been read from cache, false otherwise.
+///
+bool WriteCache::read(uint32_t address, sectionParameterType_t type, int32_t &value)
+{
+    for (int i=0; i<count; i++)
+    {
+        if (entry[i].address == address)
+        {
+            value = entry[i].value;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+///
+/// \brief Replaces bytes read from memory with dirty parameters from cache.
+/// Used after bulk memory reads, see Board::memoryReadBlock.
+/// @param [in] address     Memory address from which bytes have been read.
+/// @param [in,out] data    Bytes read from memory.
+/// @param [in] size        Number of read bytes.
+///
+void WriteCache::overlay(uint32_t address, uint8_t *data, uint16_t size)
+{
+    for (int i=0; i<count; i++)
+    {
+        uint8_t bytes = parameterSize(entry[i].type);
+
+        //parameters are stored in memory little-endian
+        for (int j=0; j<bytes; j++)
+        {
+            uint32_t byteAddress = entry[i].address + j;
+
+            if ((byteAddress >= address) && (byteAddress < (address+size)))
+                data[byteAddress-address] = entry[i].value >> (8*j);
+        }
+    }
+}
+
+///
+/// \brief Writes all dirty parameters to memory.
+///
+void WriteCache::flush()
+{
+    while (count && flushOldest());
+}
+
+///
+/// \brief Requests all currently dirty parameters to be written to memory from main loop.
+/// Unlike flush, this doesn't wait for memory: parameters are written by update, one per
+/// call once memory isn't busy, regardless of whether pads are idle and of quiet time.
+///
+void WriteCache::drain()
+{
+    drainCount = count;
+}
+
+///
+/// \brief Writes dirty parameters to memory incrementally.
+/// Needs to be called from main loop. Single parameter is written per call and only if
+/// memory isn't busy. Parameters are written once no parameter has been written for
+/// WRITE_CACHE_QUIET_TIME while pads are idle, or once they're older than WRITE_CACHE_MAX_AGE.
+/// Parameters for which drain has been requested are written right away.
+/// @param [in] idle    Set to true if pads aren't used.
+///
+void WriteCache::update(bool idle)
+{
+    if (!count)
+        return;
+
+    if (!Board::memoryReady())
+        return;
+
+    uint32_t currentTime = rTimeMs();
+
+    if (drainCount)
+        flushOldest();
+    else if (idle && ((currentTime - lastWriteTime) >= WRITE_CACHE_QUIET_TIME))
+        flushOldest();
+    else if ((currentTime - entry[0].writeTime) >= WRITE_CACHE_MAX_AGE)
+        flushOldest();
+}
+
+///
+/// \brief Returns number of parameters which haven't been written to memory yet.
+///
+uint8_t WriteCache::getDirtyCount()
+{
+    return count;
+}
+
+///
+/// \brief Writes oldest dirty parameter to memory and removes it from cache.
+/// \returns True on success, false otherwise.
+///
+bool WriteCache::flushOldest()
+{
+    if (!Board::memoryWrite(entry[0].address, entry[0].value, entry[0].type))
+        return false;
+
+    count--;
+
+    if (drainCount)
+        drainCount--;
+
+    memmove(&entry[0], &entry[1], sizeof(writeCacheEntry_t)*count);
+
+    return true;
+}
+
+WriteCache writeCache;
+
+/// @}
@@ -0,0 +1,101 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#pragma once
+
+#include <inttypes.h>
+#include "dbms/src/DataTypes.h"
+
+///
+/// \ingroup database
+/// @{
+
+///
+/// \brief Write-back cache for database memory.
+/// Database writes are stored into cache as dirty parameters instead of being written
+/// to board memory right away. Writing same parameter again only replaces its value, so
+/// value changed many times in a row (for instance with encoder) is written to memory
+/// only once. Dirty parameters are written to memory one by one from main loop, oldest
+/// first, once memory isn't busy. Reads of dirty parameters are served from cache.
+/// @{
+
+///
+/// \brief Number of dirty parameters which can be held in cache.
+/// Once cache is full, oldest parameter is written to memory right away.
+///
+#define WRITE_CACHE_SIZE            16
+
+///
+/// \brief Time in milliseconds since last write after which dirty parameters are written
+/// to memory while pads are idle.
+///
+#define WRITE_CACHE_QUIET_TIME      500
+
+///
+/// \brief Time in milliseconds after which dirty parameter is written to memory even
+/// if pads are being used or writes keep coming.
+///
+#define WRITE_CACHE_MAX_AGE         5000
+
+///
+/// \brief Single dirty parameter.
+///
+typedef struct
+{
+    uint16_t                address;
+    sectionParameterType_t  type;
+    int32_t                 value;
+    uint32_t                writeTime;
+} writeCacheEntry_t;
+
+class WriteCache
+{
+    public:
+    WriteCache();
+    bool write(uint32_t address, int32_t value, sectionParameterType_t type);
+    bool read(uint32_t address, sectionParameterType_t type, int32_t &value);
+    void overlay(uint32_t address, uint8_t *data, uint16_t size);
+    void flush();
+    void drain();
+    void update(bool idle);
+    uint8_t getDirtyCount();
+
+    private:
+    bool flushOldest();
+
+    writeCacheEntry_t   entry[WRITE_CACHE_SIZE];
+    uint8_t             count;
+    uint8_t             drainCount;
+    uint32_t            lastWriteTime;
+};
+
+///
+/// \brief External definition of WriteCache class instance.
+///
+extern WriteCache writeCache;
+
+/// @}
+
+/// @}
@@ -30,6 +30,8 @@
 #include "PadCalibration.h"
 #include "GlobalSettings.h"
 #include "ID.h"
+#include "Log.h"
+#include "DefaultMap.h"
 
 ///
 /// \brief List of all blocks in database.
@@ -42,5 +44,14 @@ enum dbBlocks
     DB_BLOCK_PAD_CALIBRATION,   //2
     DB_BLOCK_GLOBAL_SETTINGS,   //3
     DB_BLOCK_ID,                //4
+    DB_BLOCK_PROGRAM_EXTENDED,  //5
+    DB_BLOCK_LOG,               //6
+    DB_BLOCK_DEFAULT_MAP,       //7
     DB_BLOCKS
 };
+
+///
+/// \brief Total number of sections in all blocks.
+/// \ingroup database
+///
+#define DB_SECTIONS (PROGRAM_SECTIONS+SCALE_SECTIONS+PAD_CALIBRATION_SECTIONS+GLOBAL_SETTINGS_SECTIONS+1+PROGRAM_EXTENDED_SECTIONS+LOG_SECTIONS+DEFAULT_MAP_SECTIONS)
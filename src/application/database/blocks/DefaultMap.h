@@ -0,0 +1,64 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#pragma once
+
+///
+/// \defgroup dbDefaultMap Default map
+/// \ingroup database
+/// @{
+
+///
+/// \brief List of all sections in default map database block.
+///
+typedef enum
+{
+    defaultMapSection,
+    DEFAULT_MAP_SECTIONS
+} dbSection_defaultMap_t;
+
+///
+/// \brief Size of memory chunk in bytes.
+/// Memory is divided into chunks, each of which either holds written parameters or
+/// only default values which aren't stored in memory at all. Once any parameter in
+/// chunk which holds default values is written, defaults of all other parameters in
+/// chunk are written as well.
+///
+#define DB_DEFAULT_CHUNK_SIZE   16
+
+///
+/// \brief Total number of memory chunks.
+///
+#define DB_DEFAULT_CHUNKS       ((LESSDB_SIZE+DB_DEFAULT_CHUNK_SIZE-1)/DB_DEFAULT_CHUNK_SIZE)
+
+///
+/// \brief Size of default map in bytes.
+/// Each chunk has one bit in map which is set while chunk holds default values.
+/// Map is cleared on units on which whole memory has been cleared before,
+/// so that all their chunks hold written parameters.
+///
+#define DB_DEFAULT_MAP_SIZE     ((DB_DEFAULT_CHUNKS+7)/8)
+
+/// @}
@@ -0,0 +1,74 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#pragma once
+
+#include <inttypes.h>
+#include "Program.h"
+
+///
+/// \defgroup dbLog Log
+/// \ingroup database
+/// @{
+
+///
+/// \brief List of all sections in log database block.
+///
+typedef enum
+{
+    logSlotSection,
+    LOG_SECTIONS
+} dbSection_log_t;
+
+///
+/// \brief Number of slots in log ring.
+/// Each write of high-churn parameter is stored into next slot, so every slot is
+/// written once per DB_LOG_SLOTS writes. Must not be multiple of 256 so that 8-bit
+/// sequence numbers of two neighbouring slots never follow each other at the end of ring.
+///
+#define DB_LOG_SLOTS        64
+
+///
+/// \brief Total number of parameters in all high-churn sections (see dbLogSections in Address.h).
+///
+#define DB_LOG_KEYS         (1+NUMBER_OF_PROGRAMS)
+
+///
+/// \brief XOR mask applied to slot check byte so that erased (0xFF) and cleared (0x00)
+/// slots are never valid.
+///
+#define DB_LOG_CHECK_MASK   0xA5
+
+///
+/// \brief High-churn section whose parameters are stored in log ring.
+/// Section needs to hold byte parameters.
+///
+typedef struct
+{
+    uint8_t block;
+    uint8_t section;
+} dbLogSection_t;
+
+/// @}
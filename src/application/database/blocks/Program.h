@@ -129,6 +129,44 @@ const uint8_t defaultGlobalProgramSettingArray[GLOBAL_PROGRAM_SETTINGS] =
     GLOBAL_PROGRAM_SETTING_Y_CURVE_GAIN
 };
 
+///
+/// \brief List of all sections in extended program database block.
+/// Block holds program settings added after first release. It's placed after all
+/// released blocks so that their addresses don't change.
+///
+typedef enum
+{
+    programExtendedSettingsSection,
+    PROGRAM_EXTENDED_SECTIONS
+} dbSection_programExtended_t;
+
+///
+/// \brief Default values for extended program settings.
+/// Firmware which has been released without extended program block clears entire
+/// memory on factory reset, so block holds zeros once firmware is updated. Settings
+/// are therefore stored as difference from their default values: stored zero is
+/// read as default value.
+/// @{
+
+#define EXTENDED_PROGRAM_SETTING_VELOCITY_ENGINE    0x00
+#define EXTENDED_PROGRAM_SETTING_XY_FILTER_CUTOFF   24
+#define EXTENDED_PROGRAM_SETTING_XY_FILTER_BETA     32
+#define EXTENDED_PROGRAM_SETTING_XY_RESOLUTION      0x00
+
+/// @}
+
+///
+/// \brief List of all elements in extended program database section.
+///
+typedef enum
+{
+    EXTENDED_PROGRAM_SETTING_VELOCITY_ENGINE_ID,
+    EXTENDED_PROGRAM_SETTING_XY_FILTER_CUTOFF_ID,
+    EXTENDED_PROGRAM_SETTING_XY_FILTER_BETA_ID,
+    EXTENDED_PROGRAM_SETTING_XY_RESOLUTION_ID,
+    EXTENDED_PROGRAM_SETTINGS
+} extendedProgramSettings;
+
 ///
 /// \brief Default values for local program settings.
 /// @{
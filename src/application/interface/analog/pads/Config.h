@@ -30,9 +30,35 @@
 /// @{
 
 ///
-/// \brief Number of pressure samples.
+/// \brief Time in microseconds after first reading above press threshold during which
+/// pressure readings are sampled for velocity (see Velocity.h).
+/// Matches three readouts of all pads with discarded conversions, for which it has been tuned.
 ///
-#define STABLE_SAMPLE_COUNT                         3
+#define STABLE_SAMPLE_TIME_US                       33700
+
+///
+/// \brief Raw pressure rise between first two readings up to which pressure is considered
+/// already stable when slope velocity engine is used (see velocityEngine_t).
+///
+#define VELOCITY_SLOPE_STABLE_RISE                  4
+
+///
+/// \brief Fast release detection.
+/// Pad is released before its pressure reaches zero once pressure has dropped below
+/// 1/FAST_RELEASE_LEVEL_RATIO of highest pressure since press while still falling by at
+/// least 1/FAST_RELEASE_SLOPE_RATIO of it between two readings.
+/// @{
+
+#define FAST_RELEASE_LEVEL_RATIO                    4
+#define FAST_RELEASE_SLOPE_RATIO                    8
+
+/// @}
+
+///
+/// \brief Raw pressure rise from lowest pressure after fast release after which new press is detected.
+/// Until then, new press is detected only once release debounce in board has completed.
+///
+#define FAST_RELEASE_REARM_PRESSURE                 20
 
 ///
 /// \brief Time in milliseconds after which X/Y values are being read after pad has been pressed.
@@ -63,6 +89,13 @@
 ///
 #define PAD_NOTE_BUFFER_SIZE                        16
 
+///
+/// \brief Size of table holding reference counts of active notes (see Pads::getNoteRefIndex).
+/// Needs to be power of two and at least twice as large as NUMBER_OF_PADS*NOTES_PER_PAD
+/// to keep lookups short.
+///
+#define NOTE_REF_TABLE_SIZE                         128
+
 ///
 /// \brief Value used to reset last X, Y and aftertouch values so that new value can always differ from the last one.
 ///
@@ -138,21 +171,72 @@
 #define AFTERTOUCH_SEND_TIMEOUT_STEP                5
 
 ///
-/// \brief Time in milliseconds after which X/Y value needs to change by XY_SEND_TIMEOUT_STEP in order to send new value.
-/// Used to debounce rapidly changing X/Y values.
+/// \brief Fixed-point format of X/Y filter (see Filter.h).
+/// @{
+
+#define XY_FILTER_FRACTION_BITS                     4
+#define XY_FILTER_BETA_SHIFT                        4
+
+/// @}
+
+///
+/// \brief Smoothing factor (in 1/256 steps) used to smooth speed of X/Y movement.
 ///
-#define XY_SEND_TIMEOUT                             5
+#define XY_FILTER_SPEED_ALPHA                       64
 
 ///
-/// \brief Minimum MIDI pressure (velocity) value necessary to send X/Y values (after initial values have been sent).
-/// Used to avoid unstable X/Y values on low pressure.
+/// \brief Time in microseconds between two X/Y readings for which X/Y filter parameters are given.
+/// Matches adaptive pipelined scan with one touched pad, with which defaults have been tuned.
+/// Smoothing factors are scaled by actual time between readings.
 ///
-#define XY_MIN_PRESSURE_PRESSED                     25
+#define XY_FILTER_PERIOD_US                         1872
 
 ///
-/// \brief Difference between current and previous aftertouch reading after XY_SEND_TIMEOUT used to detect value change.
+/// \brief Limits of time between two X/Y readings relative to XY_FILTER_PERIOD_US (in 1/256 steps).
+/// Longer gaps (for instance after pad hasn't been processed for a while) are treated as
+/// the longest one so that filter catches up with reading in a few steps.
+/// @{
+
+#define XY_FILTER_PERIOD_RATIO_MIN                  32
+#define XY_FILTER_PERIOD_RATIO_MAX                  1024
+
+/// @}
+
+///
+/// \brief Raw difference between filtered X/Y value and last reported value needed to report new value.
+///
+#define XY_FILTER_HYSTERESIS                        4
+
+///
+/// \brief Difference between filtered X/Y value (with XY_FILTER_FRACTION_BITS fraction bits)
+/// and last reported value needed to report new value when 14-bit CC resolution is used.
+///
+#define XY_FILTER_HYSTERESIS_14B                    32
+
+///
+/// \brief Growth of X/Y filter hysteresis with speed of movement.
+/// Hysteresis is multiplied by 1 + speed/XY_FILTER_HYSTERESIS_SPEED, where speed is smoothed
+/// change per XY_FILTER_PERIOD_US (with XY_FILTER_FRACTION_BITS fraction bits) limited to
+/// XY_FILTER_HYSTERESIS_SPEED_MAX. Moving finger is then reported in steps of about two CC
+/// values, while resting finger keeps the default hysteresis so that final value settles.
+/// @{
+
+#define XY_FILTER_HYSTERESIS_SPEED                  6
+#define XY_FILTER_HYSTERESIS_SPEED_MAX              20
+
+/// @}
+
+///
+/// \brief Minimum time in milliseconds between two X/Y CC LSB messages which aren't
+/// accompanied by MSB message when 14-bit CC resolution is used (see HighRes.h).
 ///
-#define XY_SEND_TIMEOUT_STEP                        3
+#define XY_LSB_SEND_INTERVAL                        8
+
+///
+/// \brief Minimum MIDI pressure (velocity) value necessary to send X/Y values (after initial values have been sent).
+/// Used to avoid unstable X/Y values on low pressure.
+///
+#define XY_MIN_PRESSURE_PRESSED                     25
 
 ///
 /// \brief Number of zones per pad on X-axis for which calibration data is stored.
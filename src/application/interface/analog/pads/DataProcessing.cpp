@@ -53,6 +53,11 @@ void Pads::update()
 
     for (int i=0; i<NUMBER_OF_PADS; i++)
     {
+        //skip idle pads
+        //last touched pad is always processed since display is updated through it
+        if (!board.padChangeDetected(i) && !noteStored[i] && (i != getLastTouchedPad()))
+            continue;
+
         bool velocityAvailable = false;
         bool aftertouchAvailable = false;
 
@@ -252,6 +257,11 @@ void Pads::update()
             }
         }
     }
+
+    #ifndef DEBUG
+    //send MIDI data from all pads in single USB transfer
+    board.flushUSBMIDI();
+    #endif
 }
 
 ///
@@ -269,44 +279,67 @@ bool Pads::checkVelocity(int8_t pad, int16_t value)
 
     static bool initialReadIgnored[NUMBER_OF_PADS] = { false };
 
+    bool fastRelease = false;
+
     if (!BIT_READ(padPressed, pad))
     {
-        if (value && !initialReadIgnored[pad])
+        if (BIT_READ(releaseRearmPending, pad))
         {
-            //reset all samples
-            for (int i=0; i<STABLE_SAMPLE_COUNT; i++)
-                pressureSamples[pad][i] = 0;
+            //don't detect chatter after early release as new press
+            if (!velocityReleaseRearm(releaseState[pad], value))
+                return false;
+
+            BIT_WRITE(releaseRearmPending, pad, false);
+        }
 
-            pressureSampleCounter[pad] = 0;
+        if (value && !initialReadIgnored[pad])
+        {
+            //slope engine uses initial reading as starting point of pressure rise
+            velocitySampleStart(pressureSamples[pad], value, board.getPadTicks());
             initialReadIgnored[pad] = true;
             return false;
         }
     }
 
-    //stable pressure sample is taken as maximum value out of STABLE_SAMPLE_COUNT samples
-    pressureSamples[pad][pressureSampleCounter[pad]] = value;
-    pressureSampleCounter[pad]++;
+    if ((velocityEngine == velocityEngineSlope) && !BIT_READ(padPressed, pad))
+    {
+        uint16_t estimate;
 
-    if (pressureSampleCounter[pad] == STABLE_SAMPLE_COUNT)
-        pressureSampleCounter[pad] = 0;
-    else
-        return false;
+        if (!value)
+        {
+            //pressure has dropped before estimate was done, start over on next touch
+            initialReadIgnored[pad] = false;
+            return false;
+        }
 
-    //find max now
-    uint16_t maxVal = 0;
+        if (!velocitySlopeUpdate(pressureSamples[pad], value, board.getPadTicks(), estimate))
+            return false;
 
-    for (int i=0; i<STABLE_SAMPLE_COUNT; i++)
+        //if estimate is too low to result in press, new estimate starts with next reading
+        initialReadIgnored[pad] = false;
+        value = (estimate > INT16_MAX) ? INT16_MAX : estimate;
+    }
+    else if (BIT_READ(padPressed, pad) && velocityReleaseUpdate(releaseState[pad], value))
     {
-        if (pressureSamples[pad][i] > maxVal)
-            maxVal = pressureSamples[pad][i];
+        //pressure decay indicates that pad has been lifted, don't wait for it to reach zero
+        fastRelease = true;
+        velocitySampleStart(pressureSamples[pad], 0, board.getPadTicks());
+        value = 0;
     }
+    else
+    {
+        //stable pressure sample is taken as maximum value during STABLE_SAMPLE_TIME_US
+        uint16_t maxVal;
 
-    value = maxVal;
+        if (!velocityMaxUpdate(pressureSamples[pad], value, board.getPadTicks(), maxVal))
+            return false;
+
+        value = maxVal;
+    }
 
-    uint8_t calibratedPressure = getScaledPressure(pad, value, pressureVelocity);
-    calibratedPressure = curves.getCurveValue(velocityCurve, calibratedPressure, 0, 127);
+    uint8_t calibratedPressure = getVelocity(pad, value);
 
-    bool pressDetected = (calibratedPressure > 0);
+    bool pressDetected = !fastRelease && (calibratedPressure > 0);
 
     if (!pressDetected)
     {
@@ -326,10 +359,10 @@ bool Pads::checkVelocity(int8_t pad, int16_t value)
             //pad isn't already pressed
             //sensor is really pressed
             setPadPressState(pad, true);
-            //store raw value so that pressure zone can be determined more precisely once x and y are read
-            lastVelocityValue[pad] = getScaledPressure(pad, value, pressureVelocity);
+            lastVelocityValue[pad] = calibratedPressure;
             BIT_WRITE(lastMIDInoteState, pad, true);
             lastPadPressTime[pad] = rTimeMs();
+            velocityReleaseStart(releaseState[pad], value);
             returnValue = true;
             initialReadIgnored[pad] = false;
         }
@@ -340,8 +373,11 @@ bool Pads::checkVelocity(int8_t pad, int16_t value)
         {
             //pad is already pressed
             setPadPressState(pad, false);
-            lastVelocityValue[pad] = getScaledPressure(pad, value, pressureVelocity);
+            //release velocity is derived from the fastest pressure drop during release
+            //on the same scale and curve as note on velocity
+            lastVelocityValue[pad] = getVelocity(pad, releaseState[pad].drop);
             BIT_WRITE(lastMIDInoteState, pad, false);
+            BIT_WRITE(releaseRearmPending, pad, fastRelease);
             returnValue = true;
             lastXCCvalue[pad] = DEFAULT_XY_AT_VALUE;
             lastYCCvalue[pad] = DEFAULT_XY_AT_VALUE;
@@ -350,7 +386,7 @@ bool Pads::checkVelocity(int8_t pad, int16_t value)
             initialXposition[pad] = DEFAULT_INITIAL_XY_VALUE;
             initialYposition[pad] = DEFAULT_INITIAL_XY_VALUE;
             lastXYchangeTime = 0;
-            pressureSampleCounter[pad] = 0;
+            velocitySampleStart(pressureSamples[pad], 0, board.getPadTicks());
 
             if (isCalibrationEnabled() && (activeCalibration == coordinateZ))
             {
@@ -562,48 +598,66 @@ bool Pads::checkX(int8_t pad, int16_t value)
     }
 
     if (initialXposition[pad] == DEFAULT_INITIAL_XY_VALUE)
+    {
         initialXposition[pad] = getScaledXY(pad, value, coordinateX, rawScale);
+        xyFilterReset(xFilter[pad], value, board.getPadTicks());
+    }
+
+    //smooth raw value before scaling
+    uint16_t filtered = xyFilterUpdate(xFilter[pad], value, board.getPadTicks(), xyFilterParameter[xyFilterCutoff], xyFilterParameter[xyFilterBeta]);
 
     bool xChanged = false;
+    bool cc14bit = getCC14bitState(pad, coordinateX);
 
     if (getPitchBendState(pad, coordinateX))
     {
-        value = getScaledXY(pad, value, coordinateX, midiScale_14b);
-
-        if ((rTimeMs() - xSendTimer[pad]) > XY_SEND_TIMEOUT)
-        {
-            if (abs(value - lastXPitchBendValue[pad]) > XY_SEND_TIMEOUT_STEP)
-                xChanged = true;
-        }
-        else if (value != (int16_t)lastXPitchBendValue[pad])
-        {
-            xChanged = true;
-        }
+        value = getScaledXY(pad, filtered, coordinateX, midiScale_14b);
+        xChanged = (value != (int16_t)lastXPitchBendValue[pad]);
+    }
+    else if (cc14bit)
+    {
+        //curve is applied to filtered value with fraction bits
+        value = getScaledXY(pad, xFilter[pad].value, coordinateX, midiScale_14b_cc);
+        value = curves.getCurveValue14b((curve_t)padCurveX[pad], value, ccXminPad[pad], ccXmaxPad[pad]);
+        xCC14bitSend[pad] = cc14bitCheck(value, lastXCCvalue[pad], lastXCCvalueLSB[pad], rTimeMs() - lastXLSBsendTime[pad]);
+        xChanged = xCC14bitSend[pad];
+        //movement is checked with fraction bits as well
+        filtered = xFilter[pad].value;
     }
     else
     {
-        value = getScaledXY(pad, value, coordinateX, midiScale_7b);
+        value = getScaledXY(pad, filtered, coordinateX, midiScale_7b);
         value = curves.getCurveValue((curve_t)padCurveX[pad], value, ccXminPad[pad], ccXmaxPad[pad]);
-
-        if ((rTimeMs() - xSendTimer[pad]) > XY_SEND_TIMEOUT)
-        {
-            if (abs(value - lastXCCvalue[pad]) > XY_SEND_TIMEOUT_STEP)
-                xChanged = true;
-        }
-        else if (value != lastXCCvalue[pad])
-        {
-            xChanged = true;
-        }
+        xChanged = (value != (int16_t)lastXCCvalue[pad]);
     }
 
-    if (xChanged)
+    //filtered value resting on boundary between two output values isn't reported
+    if (xChanged && xyFilterMoved(xFilter[pad], filtered, cc14bit ? XY_FILTER_HYSTERESIS_14B : XY_FILTER_HYSTERESIS))
     {
         if (getPitchBendState(pad, coordinateX))
+        {
             lastXPitchBendValue[pad] = value;
+        }
+        else if (cc14bit)
+        {
+            if (xCC14bitSend[pad] & CC_14BIT_SEND_MSB)
+            {
+                lastXCCvalue[pad] = value >> 7;
+                lastXCCvalueLSB[pad] = 0;
+            }
+
+            if (xCC14bitSend[pad] & CC_14BIT_SEND_LSB)
+            {
+                lastXCCvalueLSB[pad] = value & 0x7F;
+                lastXLSBsendTime[pad] = rTimeMs();
+            }
+        }
         else
+        {
             lastXCCvalue[pad] = value;
+        }
 
-        xSendTimer[pad] = rTimeMs();
+        xFilter[pad].sent = filtered;
         return true;
     }
 
@@ -654,48 +708,66 @@ bool Pads::checkY(int8_t pad, int16_t value)
     }
 
     if (initialYposition[pad] == DEFAULT_INITIAL_XY_VALUE)
+    {
         initialYposition[pad] = getScaledXY(pad, value, coordinateY, rawScale);
+        xyFilterReset(yFilter[pad], value, board.getPadTicks());
+    }
+
+    //smooth raw value before scaling
+    uint16_t filtered = xyFilterUpdate(yFilter[pad], value, board.getPadTicks(), xyFilterParameter[xyFilterCutoff], xyFilterParameter[xyFilterBeta]);
 
     bool yChanged = false;
+    bool cc14bit = getCC14bitState(pad, coordinateY);
 
     if (getPitchBendState(pad, coordinateY))
     {
-        value = getScaledXY(pad, value, coordinateY, midiScale_14b);
-
-        if ((rTimeMs() - ySendTimer[pad]) > XY_SEND_TIMEOUT)
-        {
-            if (abs(value - lastYPitchBendValue[pad]) > XY_SEND_TIMEOUT_STEP)
-                yChanged = true;
-        }
-        else if (value != (int16_t)lastYPitchBendValue[pad])
-        {
-            yChanged = true;
-        }
+        value = getScaledXY(pad, filtered, coordinateY, midiScale_14b);
+        yChanged = (value != (int16_t)lastYPitchBendValue[pad]);
+    }
+    else if (cc14bit)
+    {
+        //curve is applied to filtered value with fraction bits
+        value = getScaledXY(pad, yFilter[pad].value, coordinateY, midiScale_14b_cc);
+        value = curves.getCurveValue14b((curve_t)padCurveY[pad], value, ccYminPad[pad], ccYmaxPad[pad]);
+        yCC14bitSend[pad] = cc14bitCheck(value, lastYCCvalue[pad], lastYCCvalueLSB[pad], rTimeMs() - lastYLSBsendTime[pad]);
+        yChanged = yCC14bitSend[pad];
+        //movement is checked with fraction bits as well
+        filtered = yFilter[pad].value;
     }
     else
     {
-        value = getScaledXY(pad, value, coordinateY, midiScale_7b);
+        value = getScaledXY(pad, filtered, coordinateY, midiScale_7b);
         value = curves.getCurveValue((curve_t)padCurveY[pad], value, ccYminPad[pad], ccYmaxPad[pad]);
-
-        if ((rTimeMs() - ySendTimer[pad]) > XY_SEND_TIMEOUT)
-        {
-            if (abs(value - lastYCCvalue[pad]) > XY_SEND_TIMEOUT_STEP)
-                yChanged = true;
-        }
-        else if (value != (int16_t)lastYCCvalue[pad])
-        {
-            yChanged = true;
-        }
+        yChanged = (value != (int16_t)lastYCCvalue[pad]);
     }
 
-    if (yChanged)
+    //filtered value resting on boundary between two output values isn't reported
+    if (yChanged && xyFilterMoved(yFilter[pad], filtered, cc14bit ? XY_FILTER_HYSTERESIS_14B : XY_FILTER_HYSTERESIS))
     {
         if (getPitchBendState(pad, coordinateY))
+        {
             lastYPitchBendValue[pad] = value;
+        }
+        else if (cc14bit)
+        {
+            if (yCC14bitSend[pad] & CC_14BIT_SEND_MSB)
+            {
+                lastYCCvalue[pad] = value >> 7;
+                lastYCCvalueLSB[pad] = 0;
+            }
+
+            if (yCC14bitSend[pad] & CC_14BIT_SEND_LSB)
+            {
+                lastYCCvalueLSB[pad] = value & 0x7F;
+                lastYLSBsendTime[pad] = rTimeMs();
+            }
+        }
         else
+        {
             lastYCCvalue[pad] = value;
+        }
 
-        ySendTimer[pad] = rTimeMs();
+        yFilter[pad].sent = filtered;
 
         return true;
     }
@@ -744,7 +816,7 @@ void Pads::checkMIDIdata(int8_t pad, bool velocityAvailable, bool aftertouchAvai
             case false:
             //note off event
             //send note off immediately
-            sendNotes(pad, 0, false);
+            sendNotes(pad, lastVelocityValue[pad], false);
             break;
         }
     }
@@ -761,7 +833,8 @@ void Pads::checkNoteBuffer(int8_t pad)
     if (!noteStored[pad])
         return;
 
-    if ((rTimeMs() - lastPadPressTime[pad]) < PAD_NOTE_SEND_DELAY)
+    //slope engine sends notes as soon as velocity is known
+    if ((velocityEngine != velocityEngineSlope) && ((rTimeMs() - lastPadPressTime[pad]) < PAD_NOTE_SEND_DELAY))
         return;
 
     //send
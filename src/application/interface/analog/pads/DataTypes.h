@@ -124,6 +124,42 @@ typedef enum
     velocity_hard
 } velocitySensitivity_t;
 
+///
+/// \brief List of all possible velocity engines.
+/// Default engine takes maximum of pressure readings during STABLE_SAMPLE_TIME_US after press and
+/// delays note by PAD_NOTE_SEND_DELAY so that X and Y values are sent before it. Slope
+/// engine estimates the same value from pressure rise rate (see Velocity.h) and sends
+/// note as soon as estimate is stable, before X and Y values.
+///
+typedef enum
+{
+    velocityEngineMax,
+    velocityEngineSlope,
+    VELOCITY_ENGINES
+} velocityEngine_t;
+
+///
+/// \brief List of all X/Y filter parameters (see Filter.h).
+///
+typedef enum
+{
+    xyFilterCutoff,
+    xyFilterBeta,
+    XY_FILTER_PARAMETERS
+} xyFilterParameter_t;
+
+///
+/// \brief List of all possible resolutions of X/Y CC messages.
+/// 14-bit resolution sends MSB on CC n and LSB on CC n+32 (see HighRes.h). Used only
+/// on CC numbers 0-31 which have LSB pair, other CC numbers are always sent with 7 bits.
+///
+typedef enum
+{
+    xyResolution7bit,
+    xyResolution14bit,
+    XY_RESOLUTIONS
+} xyResolution_t;
+
 ///
 /// \brief List of all possible predefined scales.
 ///
@@ -155,7 +191,24 @@ typedef enum
 {
     rawScale,
     midiScale_7b,
-    midiScale_14b
+    midiScale_14b,
+    midiScale_14b_cc
 } valueScaleType_t;
 
+///
+/// \brief List of per-pad fixed-point scalers used to convert raw readings into output ranges.
+///
+typedef enum
+{
+    scalerVelocity,
+    scalerAftertouch,
+    scalerX_7b,
+    scalerX_raw,
+    scalerY_7b,
+    scalerY_raw,
+    scalerX_14b,
+    scalerY_14b,
+    NUMBER_OF_PAD_SCALERS
+} padScaler_t;
+
 /// @}
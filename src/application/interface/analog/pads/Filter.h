@@ -0,0 +1,156 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#pragma once
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include "Config.h"
+#include "profiler/Profiler.h"
+
+///
+/// \ingroup interfacePads
+/// @{
+
+///
+/// \brief Adaptive low-pass filter for raw X and Y readings.
+/// Fixed-point variant of speed dependent (one euro) filter. Filtered value moves towards
+/// each new reading by factor alpha (in 1/256 steps) which grows with smoothed speed of
+/// movement: alpha = cutoff + (speed * beta >> XY_FILTER_BETA_SHIFT). Slow movements and
+/// resting finger are heavily smoothed, while fast movements pass with little lag. Speed
+/// is change per XY_FILTER_PERIOD_US and both smoothing factors are scaled by time between
+/// readings, so that filter behaves the same regardless of how often pad is read.
+/// New value is reported only once filtered value has moved by more than hysteresis
+/// (XY_FILTER_HYSTERESIS) from the value which has been reported last, so that filtered
+/// value resting on boundary between two output values doesn't toggle between them.
+/// Hysteresis grows with speed (see XY_FILTER_HYSTERESIS_SPEED), so that slow movement
+/// isn't reported on every output value.
+/// @{
+
+///
+/// \brief Filter state for single coordinate of single pad.
+///
+typedef struct
+{
+    uint16_t value; ///< Filtered value with XY_FILTER_FRACTION_BITS fractional bits.
+    int16_t speed;  ///< Smoothed change between readings, same fixed-point format.
+    uint16_t sent;  ///< Filtered value which has been reported last, in format checked by xyFilterMoved.
+    uint32_t last;  ///< Readout time of last reading in profiler timer ticks.
+} xyFilter_t;
+
+///
+/// \brief Value of xyFilter_t.sent before first value has been reported.
+///
+#define XY_FILTER_UNSENT        0xFFFF
+
+///
+/// \brief Restarts filter with first reading after press.
+/// @param [in,out] filter  Filter state.
+/// @param [in] value       Raw reading (0-1023).
+/// @param [in] ticks       Readout time of reading in profiler timer ticks.
+///
+inline void xyFilterReset(xyFilter_t &filter, uint16_t value, uint32_t ticks)
+{
+    filter.value = value << XY_FILTER_FRACTION_BITS;
+    filter.speed = 0;
+    filter.sent = XY_FILTER_UNSENT;
+    filter.last = ticks;
+}
+
+///
+/// \brief Adds new reading to filter.
+/// @param [in,out] filter  Filter state.
+/// @param [in] value       Raw reading (0-1023).
+/// @param [in] ticks       Readout time of reading in profiler timer ticks.
+/// @param [in] cutoff      Smoothing factor at rest per XY_FILTER_PERIOD_US (1-255, in 1/256 steps).
+/// @param [in] beta        Increase of smoothing factor with speed.
+/// \returns Filtered value (0-1023).
+///
+inline uint16_t xyFilterUpdate(xyFilter_t &filter, uint16_t value, uint32_t ticks, uint8_t cutoff, uint8_t beta)
+{
+    //time since last reading relative to XY_FILTER_PERIOD_US, in 1/256 steps
+    uint32_t ratio = ((ticks - filter.last) << 8) / ((uint32_t)XY_FILTER_PERIOD_US*PROFILER_TICKS_PER_US);
+
+    filter.last = ticks;
+
+    if (ratio < XY_FILTER_PERIOD_RATIO_MIN)
+        ratio = XY_FILTER_PERIOD_RATIO_MIN;
+    else if (ratio > XY_FILTER_PERIOD_RATIO_MAX)
+        ratio = XY_FILTER_PERIOD_RATIO_MAX;
+
+    int16_t delta = (int16_t)(value << XY_FILTER_FRACTION_BITS) - (int16_t)filter.value;
+    //change per XY_FILTER_PERIOD_US
+    int32_t change = ((int32_t)delta << 8) / (int32_t)ratio;
+    uint32_t speedAlpha = (XY_FILTER_SPEED_ALPHA * ratio) >> 8;
+
+    if (change > INT16_MAX)
+        change = INT16_MAX;
+    else if (change < -INT16_MAX)
+        change = -INT16_MAX;
+
+    if (speedAlpha > 256)
+        speedAlpha = 256;
+
+    filter.speed += ((change - filter.speed) * (int32_t)speedAlpha) >> 8;
+
+    uint32_t alpha = cutoff + (((uint32_t)abs(filter.speed) * beta) >> XY_FILTER_BETA_SHIFT);
+
+    alpha = (alpha * ratio) >> 8;
+
+    if (alpha > 256)
+        alpha = 256;
+
+    filter.value += ((int32_t)delta * (int32_t)alpha) >> 8;
+
+    return (filter.value + (1 << (XY_FILTER_FRACTION_BITS-1))) >> XY_FILTER_FRACTION_BITS;
+}
+
+///
+/// \brief Checks whether filtered value has moved enough since last report.
+/// @param [in] filter      Filter state.
+/// @param [in] value       Filtered value returned by xyFilterUpdate or filter.value when
+///                         fraction bits are needed.
+/// @param [in] hysteresis  Required difference at rest, in the same format as value.
+/// \returns True if value should be reported, false otherwise.
+///
+inline bool xyFilterMoved(const xyFilter_t &filter, uint16_t value, uint16_t hysteresis = XY_FILTER_HYSTERESIS)
+{
+    if (filter.sent == XY_FILTER_UNSENT)
+        return true;
+
+    //moving value is reported in larger steps
+    uint16_t speed = abs(filter.speed);
+
+    if (speed > XY_FILTER_HYSTERESIS_SPEED_MAX)
+        speed = XY_FILTER_HYSTERESIS_SPEED_MAX;
+
+    hysteresis += ((uint32_t)hysteresis * speed) / XY_FILTER_HYSTERESIS_SPEED;
+
+    return (abs((int16_t)value - (int16_t)filter.sent) > hysteresis);
+}
+
+/// @}
+
+/// @}
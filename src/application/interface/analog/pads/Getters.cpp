@@ -31,6 +31,7 @@
 #include "PredefinedScales.h"
 #include "../../../board/Board.h"
 #include "curves/Curves.h"
+#include "Scaler.h"
 #include "pins/map/LEDs.h"
 #include "board/common/analog/Variables.h"
 #include "constants/Pads.h" //from board
@@ -159,7 +160,7 @@ note_t Pads::getTonic()
     {
         //predefined scale tonic is written in eeprom
         uint16_t tonicIndex = PREDEFINED_SCALE_TONIC_ID+((PREDEFINED_SCALE_PARAMETERS*PREDEFINED_SCALES)*(uint16_t)activeProgram)+PREDEFINED_SCALE_PARAMETERS*(uint16_t)activeScale;
-        return (note_t)database.read(DB_BLOCK_SCALE, scalePredefinedSection, tonicIndex);
+        return (note_t)database.read<DB_BLOCK_SCALE, scalePredefinedSection>(tonicIndex);
     }
 }
 
@@ -324,7 +325,7 @@ uint8_t Pads::getOctaveFromNote(int8_t note)
 ///
 int8_t Pads::getScaleShiftLevel()
 {
-    return database.read(DB_BLOCK_SCALE, scalePredefinedSection, PREDEFINED_SCALE_SHIFT_ID+((PREDEFINED_SCALE_PARAMETERS*PREDEFINED_SCALES)*(uint16_t)activeProgram)+PREDEFINED_SCALE_PARAMETERS*(uint16_t)activeScale);
+    return database.read<DB_BLOCK_SCALE, scalePredefinedSection>(PREDEFINED_SCALE_SHIFT_ID+((PREDEFINED_SCALE_PARAMETERS*PREDEFINED_SCALES)*(uint16_t)activeProgram)+PREDEFINED_SCALE_PARAMETERS*(uint16_t)activeScale);
 }
 
 ///
@@ -426,6 +427,36 @@ curve_t Pads::getVelocityCurve()
     return velocityCurve;
 }
 
+///
+/// \brief Checks for velocity engine used in active program.
+/// \returns Active velocity engine (enumerated type). See velocityEngine_t enumeration.
+///
+velocityEngine_t Pads::getVelocityEngine()
+{
+    return velocityEngine;
+}
+
+///
+/// \brief Checks for X/Y filter parameter used in active program.
+/// @param [in] parameter   Filter parameter (enumerated type). See xyFilterParameter_t enumeration.
+/// \returns Value of requested parameter.
+///
+uint8_t Pads::getXYfilter(xyFilterParameter_t parameter)
+{
+    assert(parameter < XY_FILTER_PARAMETERS);
+
+    return xyFilterParameter[parameter];
+}
+
+///
+/// \brief Checks for resolution of X/Y CC messages used in active program.
+/// \returns Active resolution (enumerated type). See xyResolution_t enumeration.
+///
+xyResolution_t Pads::getXYresolution()
+{
+    return xyResolution;
+}
+
 ///
 /// \brief Checks currently assigned MIDI channel on requested pad.
 /// @param [in] pad     Pad which is being checked.
@@ -519,10 +550,10 @@ dbSection_padCalibration_t Pads::getPressureZone(int8_t pad)
 void Pads::getConfiguration()
 {
     //globals
-    aftertouchType = (aftertouchType_t)database.read(DB_BLOCK_GLOBAL_SETTINGS, globalSettingsMIDI, MIDI_SETTING_AFTERTOUCH_TYPE_ID);
-    velocitySensitivity = (velocitySensitivity_t)database.read(DB_BLOCK_GLOBAL_SETTINGS, globalSettingsVelocitySensitivity, VELOCITY_SETTING_SENSITIVITY_ID);
-    velocityCurve = (curve_t)database.read(DB_BLOCK_GLOBAL_SETTINGS, globalSettingsVelocitySensitivity, VELOCITY_SETTING_CURVE_ID);
-    pitchBendType = (pitchBendType_t)database.read(DB_BLOCK_GLOBAL_SETTINGS, globalSettingsMIDI, MIDI_SETTING_PITCH_BEND_TYPE_ID);
+    aftertouchType = (aftertouchType_t)database.read<DB_BLOCK_GLOBAL_SETTINGS, globalSettingsMIDI>(MIDI_SETTING_AFTERTOUCH_TYPE_ID);
+    velocitySensitivity = (velocitySensitivity_t)database.read<DB_BLOCK_GLOBAL_SETTINGS, globalSettingsVelocitySensitivity>(VELOCITY_SETTING_SENSITIVITY_ID);
+    velocityCurve = (curve_t)database.read<DB_BLOCK_GLOBAL_SETTINGS, globalSettingsVelocitySensitivity>(VELOCITY_SETTING_CURVE_ID);
+    pitchBendType = (pitchBendType_t)database.read<DB_BLOCK_GLOBAL_SETTINGS, globalSettingsMIDI>(MIDI_SETTING_PITCH_BEND_TYPE_ID);
 
     //read pad configuration from EEPROM
     getProgramParameters();
@@ -538,12 +569,22 @@ void Pads::getProgramParameters()
     printf_P(PSTR("----------------------\nPrinting out program settings\n----------------------\n"));
     #endif
 
-    activeProgram = database.read(DB_BLOCK_PROGRAM, programLastActiveProgramSection, 0);
-    splitEnabled = database.read(DB_BLOCK_PROGRAM, programGlobalSettingsSection, GLOBAL_PROGRAM_SETTING_SPLIT_STATE_ID+(GLOBAL_PROGRAM_SETTINGS*(uint16_t)activeProgram));
+    activeProgram = database.readLog<DB_BLOCK_PROGRAM, programLastActiveProgramSection>(0);
+
+    const programImage_t &program = database.getProgram(activeProgram);
+
+    splitEnabled = program.global[GLOBAL_PROGRAM_SETTING_SPLIT_STATE_ID];
+    velocityEngine = (velocityEngine_t)(program.extended[EXTENDED_PROGRAM_SETTING_VELOCITY_ENGINE_ID] + EXTENDED_PROGRAM_SETTING_VELOCITY_ENGINE);
+    xyFilterParameter[xyFilterCutoff] = program.extended[EXTENDED_PROGRAM_SETTING_XY_FILTER_CUTOFF_ID] + EXTENDED_PROGRAM_SETTING_XY_FILTER_CUTOFF;
+    xyFilterParameter[xyFilterBeta] = program.extended[EXTENDED_PROGRAM_SETTING_XY_FILTER_BETA_ID] + EXTENDED_PROGRAM_SETTING_XY_FILTER_BETA;
+    xyResolution = (xyResolution_t)(program.extended[EXTENDED_PROGRAM_SETTING_XY_RESOLUTION_ID] + EXTENDED_PROGRAM_SETTING_XY_RESOLUTION);
 
     #ifdef DEBUG
     printf_P(PSTR("Active program: %d\n"), activeProgram+1);
     printf_P(PSTR("Active scale: %d\n"), activeScale);
+    printf_P(PSTR("Velocity engine: %s\n"), (velocityEngine == velocityEngineSlope) ? "slope" : "max");
+    printf_P(PSTR("X/Y filter cutoff: %d, beta: %d\n"), xyFilterParameter[xyFilterCutoff], xyFilterParameter[xyFilterBeta]);
+    printf_P(PSTR("X/Y resolution: %s\n"), (xyResolution == xyResolution14bit) ? "14-bit" : "7-bit");
     #endif
 
     getPadParameters();
@@ -551,87 +592,52 @@ void Pads::getProgramParameters()
     getScaleParameters();
 }
 
+//global pad settings are stored in same order as local ones, right after split state
+static_assert((GLOBAL_PROGRAM_SETTING_Y_CURVE_GAIN_ID-GLOBAL_PROGRAM_SETTING_X_ENABLE_ID) == LOCAL_PROGRAM_SETTING_Y_CURVE_GAIN_ID, "Global and local pad settings differ");
+
 ///
-/// \brief Initializes all pad data by reading values from database.
+/// \brief Initializes all pad data from active program image.
+/// Global settings are applied to all pads if split is off, local ones otherwise.
 ///
 void Pads::getPadParameters()
 {
+    //pad curves and limits are reloaded
+    curves.invalidateTables();
+
+    const programImage_t &program = database.getProgram(activeProgram);
+
     #ifdef DEBUG
     printf_P(PSTR("Printing out pad configuration\n"));
-    #endif
 
     if (!splitEnabled)
-    {
-        //split off
-        //apply global settings to pads
-        #ifdef DEBUG
         printf_P(PSTR("All pad parameters are global - split is off.\n"));
-        #endif
-
-        for (int i=0; i<NUMBER_OF_PADS; i++)
-        {
-            BIT_WRITE(xSendEnabled, i, database.read(DB_BLOCK_PROGRAM, programGlobalSettingsSection, GLOBAL_PROGRAM_SETTING_X_ENABLE_ID+(GLOBAL_PROGRAM_SETTINGS*(uint16_t)activeProgram)));
-            BIT_WRITE(ySendEnabled, i, database.read(DB_BLOCK_PROGRAM, programGlobalSettingsSection, GLOBAL_PROGRAM_SETTING_Y_ENABLE_ID+(GLOBAL_PROGRAM_SETTINGS*(uint16_t)activeProgram)));
-            BIT_WRITE(noteSendEnabled, i, database.read(DB_BLOCK_PROGRAM, programGlobalSettingsSection, GLOBAL_PROGRAM_SETTING_NOTE_ENABLE_ID+(GLOBAL_PROGRAM_SETTINGS*(uint16_t)activeProgram)));
-            BIT_WRITE(aftertouchSendEnabled, i, database.read(DB_BLOCK_PROGRAM, programGlobalSettingsSection, GLOBAL_PROGRAM_SETTING_AFTERTOUCH_ENABLE_ID+(GLOBAL_PROGRAM_SETTINGS*(uint16_t)activeProgram)));
-            BIT_WRITE(pitchBendEnabledX, i, database.read(DB_BLOCK_PROGRAM, programGlobalSettingsSection, GLOBAL_PROGRAM_SETTING_PITCH_BEND_X_ENABLE_ID+(GLOBAL_PROGRAM_SETTINGS*(uint16_t)activeProgram)));
-            BIT_WRITE(pitchBendEnabledY, i, database.read(DB_BLOCK_PROGRAM, programGlobalSettingsSection, GLOBAL_PROGRAM_SETTING_PITCH_BEND_Y_ENABLE_ID+(GLOBAL_PROGRAM_SETTINGS*(uint16_t)activeProgram)));
-            ccXPad[i]                       = database.read(DB_BLOCK_PROGRAM, programGlobalSettingsSection, GLOBAL_PROGRAM_SETTING_CC_X_ID+(GLOBAL_PROGRAM_SETTINGS*(uint16_t)activeProgram));
-            ccYPad[i]                       = database.read(DB_BLOCK_PROGRAM, programGlobalSettingsSection, GLOBAL_PROGRAM_SETTING_CC_Y_ID+(GLOBAL_PROGRAM_SETTINGS*(uint16_t)activeProgram));
-            ccXminPad[i]                    = database.read(DB_BLOCK_PROGRAM, programGlobalSettingsSection, GLOBAL_PROGRAM_SETTING_X_MIN_ID+(GLOBAL_PROGRAM_SETTINGS*(uint16_t)activeProgram));
-            ccXmaxPad[i]                    = database.read(DB_BLOCK_PROGRAM, programGlobalSettingsSection, GLOBAL_PROGRAM_SETTING_X_MAX_ID+(GLOBAL_PROGRAM_SETTINGS*(uint16_t)activeProgram));
-            ccYminPad[i]                    = database.read(DB_BLOCK_PROGRAM, programGlobalSettingsSection, GLOBAL_PROGRAM_SETTING_Y_MIN_ID+(GLOBAL_PROGRAM_SETTINGS*(uint16_t)activeProgram));
-            ccYmaxPad[i]                    = database.read(DB_BLOCK_PROGRAM, programGlobalSettingsSection, GLOBAL_PROGRAM_SETTING_Y_MAX_ID+(GLOBAL_PROGRAM_SETTINGS*(uint16_t)activeProgram));
-            padCurveX[i]                    = (curve_t)database.read(DB_BLOCK_PROGRAM, programGlobalSettingsSection, GLOBAL_PROGRAM_SETTING_X_CURVE_GAIN_ID+(GLOBAL_PROGRAM_SETTINGS*(uint16_t)activeProgram));
-            padCurveY[i]                    = (curve_t)database.read(DB_BLOCK_PROGRAM, programGlobalSettingsSection, GLOBAL_PROGRAM_SETTING_Y_CURVE_GAIN_ID+(GLOBAL_PROGRAM_SETTINGS*(uint16_t)activeProgram));
-            midiChannel[i]                  = database.read(DB_BLOCK_PROGRAM, programGlobalSettingsSection, GLOBAL_PROGRAM_SETTING_MIDI_CHANNEL_ID+(GLOBAL_PROGRAM_SETTINGS*(uint16_t)activeProgram));
-        }
-
-        #ifdef DEBUG
-        printf_P(PSTR("X send %s\n"), BIT_READ(xSendEnabled, 0) ? "enabled" : "disabled");
-        printf_P(PSTR("Y send %s\n"), BIT_READ(ySendEnabled, 0) ? "enabled" : "disabled");
-        printf_P(PSTR("Note send %s\n"), BIT_READ(noteSendEnabled, 0) ? "enabled" : "disabled");
-        printf_P(PSTR("Aftertouch send %s\n"), BIT_READ(aftertouchSendEnabled, 0) ? "enabled" : "disabled");
-        printf_P(PSTR("Pitch bend X send %s\n"), BIT_READ(pitchBendEnabledX, 0) ? "enabled" : "disabled");
-        printf_P(PSTR("Pitch bend Y send %s\n"), BIT_READ(pitchBendEnabledY, 0) ? "enabled" : "disabled");
-        printf_P(PSTR("CC X MIDI ID: %d\n"), ccXPad[0]);
-        printf_P(PSTR("CC Y MIDI ID: %d\n"), ccYPad[0]);
-        printf_P(PSTR("CC X lower limit: %d\n"), ccXminPad[0]);
-        printf_P(PSTR("CC X upper limit: %d\n"), ccXmaxPad[0]);
-        printf_P(PSTR("CC Y lower limit: %d\n"), ccYminPad[0]);
-        printf_P(PSTR("CC Y upper limit: %d\n"), ccYmaxPad[0]);
-        printf_P(PSTR("Pad curve for X: %d\n"), padCurveX[0]);
-        printf_P(PSTR("Pad curve for Y: %d\n"), padCurveY[0]);
-        printf_P(PSTR("MIDI channel: %d\n"), midiChannel[0]);
-        #endif
-    }
     else
-    {
-        //split on
-        #ifdef DEBUG
         printf_P(PSTR("Pads have individual settings\n"));
-        #endif
+    #endif
 
-        //pads have individual settings
-        for (int i=0; i<NUMBER_OF_PADS; i++)
+    for (int i=0; i<NUMBER_OF_PADS; i++)
+    {
+        const uint8_t *setting = splitEnabled ? program.local[i] : &program.global[GLOBAL_PROGRAM_SETTING_X_ENABLE_ID];
+
+        BIT_WRITE(xSendEnabled, i, setting[LOCAL_PROGRAM_SETTING_X_ENABLE_ID]);
+        BIT_WRITE(ySendEnabled, i, setting[LOCAL_PROGRAM_SETTING_Y_ENABLE_ID]);
+        BIT_WRITE(noteSendEnabled, i, setting[LOCAL_PROGRAM_SETTING_NOTE_ENABLE_ID]);
+        BIT_WRITE(aftertouchSendEnabled, i, setting[LOCAL_PROGRAM_SETTING_AFTERTOUCH_ENABLE_ID]);
+        BIT_WRITE(pitchBendEnabledX, i, setting[LOCAL_PROGRAM_SETTING_PITCH_BEND_X_ENABLE_ID]);
+        BIT_WRITE(pitchBendEnabledY, i, setting[LOCAL_PROGRAM_SETTING_PITCH_BEND_Y_ENABLE_ID]);
+        ccXPad[i]                   = setting[LOCAL_PROGRAM_SETTING_CC_X_ID];
+        ccYPad[i]                   = setting[LOCAL_PROGRAM_SETTING_CC_Y_ID];
+        ccXminPad[i]                = setting[LOCAL_PROGRAM_SETTING_X_MIN_ID];
+        ccXmaxPad[i]                = setting[LOCAL_PROGRAM_SETTING_X_MAX_ID];
+        ccYminPad[i]                = setting[LOCAL_PROGRAM_SETTING_Y_MIN_ID];
+        ccYmaxPad[i]                = setting[LOCAL_PROGRAM_SETTING_Y_MAX_ID];
+        padCurveX[i]                = (curve_t)setting[LOCAL_PROGRAM_SETTING_X_CURVE_GAIN_ID];
+        padCurveY[i]                = (curve_t)setting[LOCAL_PROGRAM_SETTING_Y_CURVE_GAIN_ID];
+        midiChannel[i]              = setting[LOCAL_PROGRAM_SETTING_MIDI_CHANNEL_ID];
+
+        #ifdef DEBUG
+        if (splitEnabled)
         {
-            BIT_WRITE(xSendEnabled, i, database.read(DB_BLOCK_PROGRAM, programLocalSettingsSection, (LOCAL_PROGRAM_SETTINGS*i+LOCAL_PROGRAM_SETTING_X_ENABLE_ID)+(LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*(uint16_t)activeProgram)));
-            BIT_WRITE(ySendEnabled, i, database.read(DB_BLOCK_PROGRAM, programLocalSettingsSection, (LOCAL_PROGRAM_SETTINGS*i+LOCAL_PROGRAM_SETTING_Y_ENABLE_ID)+(LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*(uint16_t)activeProgram)));
-            BIT_WRITE(noteSendEnabled, i, database.read(DB_BLOCK_PROGRAM, programLocalSettingsSection, (LOCAL_PROGRAM_SETTINGS*i+LOCAL_PROGRAM_SETTING_NOTE_ENABLE_ID)+(LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*(uint16_t)activeProgram)));
-            BIT_WRITE(aftertouchSendEnabled, i, database.read(DB_BLOCK_PROGRAM, programLocalSettingsSection, (LOCAL_PROGRAM_SETTINGS*i+LOCAL_PROGRAM_SETTING_AFTERTOUCH_ENABLE_ID)+(LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*(uint16_t)activeProgram)));
-            BIT_WRITE(pitchBendEnabledX, i, database.read(DB_BLOCK_PROGRAM, programLocalSettingsSection, (LOCAL_PROGRAM_SETTINGS*i+LOCAL_PROGRAM_SETTING_PITCH_BEND_X_ENABLE_ID)+(LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*(uint16_t)activeProgram)));
-            BIT_WRITE(pitchBendEnabledY, i, database.read(DB_BLOCK_PROGRAM, programLocalSettingsSection, (LOCAL_PROGRAM_SETTINGS*i+LOCAL_PROGRAM_SETTING_PITCH_BEND_Y_ENABLE_ID)+(LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*(uint16_t)activeProgram)));
-            ccXPad[i]                   = database.read(DB_BLOCK_PROGRAM, programLocalSettingsSection, (LOCAL_PROGRAM_SETTINGS*i+LOCAL_PROGRAM_SETTING_CC_X_ID)+(LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*(uint16_t)activeProgram));
-            ccYPad[i]                   = database.read(DB_BLOCK_PROGRAM, programLocalSettingsSection, (LOCAL_PROGRAM_SETTINGS*i+LOCAL_PROGRAM_SETTING_CC_Y_ID)+(LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*(uint16_t)activeProgram));
-            ccXminPad[i]                = database.read(DB_BLOCK_PROGRAM, programLocalSettingsSection, (LOCAL_PROGRAM_SETTINGS*i+LOCAL_PROGRAM_SETTING_X_MIN_ID)+(LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*(uint16_t)activeProgram));
-            ccXmaxPad[i]                = database.read(DB_BLOCK_PROGRAM, programLocalSettingsSection, (LOCAL_PROGRAM_SETTINGS*i+LOCAL_PROGRAM_SETTING_X_MAX_ID)+(LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*(uint16_t)activeProgram));
-            ccYminPad[i]                = database.read(DB_BLOCK_PROGRAM, programLocalSettingsSection, (LOCAL_PROGRAM_SETTINGS*i+LOCAL_PROGRAM_SETTING_Y_MIN_ID)+(LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*(uint16_t)activeProgram));
-            ccYmaxPad[i]                = database.read(DB_BLOCK_PROGRAM, programLocalSettingsSection, (LOCAL_PROGRAM_SETTINGS*i+LOCAL_PROGRAM_SETTING_Y_MAX_ID)+(LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*(uint16_t)activeProgram));
-            padCurveX[i]                = (curve_t)database.read(DB_BLOCK_PROGRAM, programLocalSettingsSection, (LOCAL_PROGRAM_SETTINGS*i+LOCAL_PROGRAM_SETTING_X_CURVE_GAIN_ID)+(LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*(uint16_t)activeProgram));
-            padCurveY[i]                = (curve_t)database.read(DB_BLOCK_PROGRAM, programLocalSettingsSection, (LOCAL_PROGRAM_SETTINGS*i+LOCAL_PROGRAM_SETTING_Y_CURVE_GAIN_ID)+(LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*(uint16_t)activeProgram));
-            midiChannel[i]              = database.read(DB_BLOCK_PROGRAM, programLocalSettingsSection, (LOCAL_PROGRAM_SETTINGS*i+LOCAL_PROGRAM_SETTING_MIDI_CHANNEL_ID)+(LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*(uint16_t)activeProgram));
-
-            #ifdef DEBUG
             printf_P(PSTR("----------------------\nPad %d\n----------------------\n"), i+1);
             printf_P(PSTR("X send enabled: %d\n"), BIT_READ(xSendEnabled, i));
             printf_P(PSTR("Y send enabled: %d\n"), BIT_READ(ySendEnabled, i));
@@ -646,9 +652,30 @@ void Pads::getPadParameters()
             printf_P(PSTR("Pad curve for X: %d\n"), padCurveX[i]);
             printf_P(PSTR("Pad curve for Y: %d\n"), padCurveY[i]);
             printf_P(PSTR("MIDI channel: %d\n"), midiChannel[i]);
-            #endif
         }
+        #endif
+    }
+
+    #ifdef DEBUG
+    if (!splitEnabled)
+    {
+        printf_P(PSTR("X send %s\n"), BIT_READ(xSendEnabled, 0) ? "enabled" : "disabled");
+        printf_P(PSTR("Y send %s\n"), BIT_READ(ySendEnabled, 0) ? "enabled" : "disabled");
+        printf_P(PSTR("Note send %s\n"), BIT_READ(noteSendEnabled, 0) ? "enabled" : "disabled");
+        printf_P(PSTR("Aftertouch send %s\n"), BIT_READ(aftertouchSendEnabled, 0) ? "enabled" : "disabled");
+        printf_P(PSTR("Pitch bend X send %s\n"), BIT_READ(pitchBendEnabledX, 0) ? "enabled" : "disabled");
+        printf_P(PSTR("Pitch bend Y send %s\n"), BIT_READ(pitchBendEnabledY, 0) ? "enabled" : "disabled");
+        printf_P(PSTR("CC X MIDI ID: %d\n"), ccXPad[0]);
+        printf_P(PSTR("CC Y MIDI ID: %d\n"), ccYPad[0]);
+        printf_P(PSTR("CC X lower limit: %d\n"), ccXminPad[0]);
+        printf_P(PSTR("CC X upper limit: %d\n"), ccXmaxPad[0]);
+        printf_P(PSTR("CC Y lower limit: %d\n"), ccYminPad[0]);
+        printf_P(PSTR("CC Y upper limit: %d\n"), ccYmaxPad[0]);
+        printf_P(PSTR("Pad curve for X: %d\n"), padCurveX[0]);
+        printf_P(PSTR("Pad curve for Y: %d\n"), padCurveY[0]);
+        printf_P(PSTR("MIDI channel: %d\n"), midiChannel[0]);
     }
+    #endif
 
     uint8_t lastTouchedPad = getLastTouchedPad();
 
@@ -664,7 +691,9 @@ void Pads::getPadParameters()
 ///
 void Pads::getScaleParameters()
 {
-    activeScale = database.read(DB_BLOCK_PROGRAM, programLastActiveScaleSection, (uint16_t)activeProgram);
+    const programImage_t &program = database.getProgram(activeProgram);
+
+    activeScale = program.scale;
 
     //clear all pad notes before assigning new ones
     for (int i=0; i<NUMBER_OF_PADS; i++)
@@ -676,9 +705,9 @@ void Pads::getScaleParameters()
     if (isPredefinedScale(activeScale))
     {
         //predefined scale
-        uint8_t octave = database.read(DB_BLOCK_SCALE, scalePredefinedSection, PREDEFINED_SCALE_OCTAVE_ID+((PREDEFINED_SCALE_PARAMETERS*PREDEFINED_SCALES)*(uint16_t)activeProgram)+PREDEFINED_SCALE_PARAMETERS*(uint16_t)activeScale);
-        note_t tonic = (note_t)database.read(DB_BLOCK_SCALE, scalePredefinedSection, PREDEFINED_SCALE_TONIC_ID+((PREDEFINED_SCALE_PARAMETERS*PREDEFINED_SCALES)*(uint16_t)activeProgram)+PREDEFINED_SCALE_PARAMETERS*(uint16_t)activeScale);
-        int8_t noteShiftLevel = database.read(DB_BLOCK_SCALE, scalePredefinedSection, PREDEFINED_SCALE_SHIFT_ID+((PREDEFINED_SCALE_PARAMETERS*PREDEFINED_SCALES)*(uint16_t)activeProgram)+PREDEFINED_SCALE_PARAMETERS*(uint16_t)activeScale);
+        uint8_t octave = program.predefinedScale[activeScale][PREDEFINED_SCALE_OCTAVE_ID];
+        note_t tonic = (note_t)program.predefinedScale[activeScale][PREDEFINED_SCALE_TONIC_ID];
+        int8_t noteShiftLevel = program.predefinedScale[activeScale][PREDEFINED_SCALE_SHIFT_ID];
 
         #ifdef DEBUG
         printf_P(PSTR("Octave: %d\n"), octave);
@@ -734,11 +763,7 @@ void Pads::getScaleParameters()
         //user scales
         uint16_t noteID = (activeScale - PREDEFINED_SCALES)*(NUMBER_OF_PADS*NOTES_PER_PAD);
 
-        for (int i=0; i<NUMBER_OF_PADS; i++)
-        {
-            for (int j=0; j<NOTES_PER_PAD; j++)
-                padNote[i][j] = database.read(DB_BLOCK_SCALE, scaleUserSection, noteID+j+(NOTES_PER_PAD*i));
-        }
+        database.readBlock(DB_BLOCK_SCALE, scaleUserSection, noteID, padNote[0], sizeof(padNote));
     }
 }
 
@@ -784,11 +809,13 @@ void Pads::getPressureLimits()
 
     for (int i=0; i<NUMBER_OF_PADS; i++)
     {
-        padPressureLimitUpper[i] = database.read(DB_BLOCK_PAD_CALIBRATION, padCalibrationPressureUpperSection, i);
+        padPressureLimitUpper[i] = database.read<DB_BLOCK_PAD_CALIBRATION, padCalibrationPressureUpperSection>(i);
 
         if (percentageIncrease)
             padPressureLimitUpper[i] = padPressureLimitUpper[i] + (int32_t)((padPressureLimitUpper[i] * (int32_t)100) * (uint32_t)percentageIncrease) / 10000;
 
+        updatePressureScalers(i);
+
         #ifdef DEBUG
         printf_P(PSTR("Upper pressure limit for pad %d: %d\n"), i, padPressureLimitUpper[i]);
         #endif
@@ -806,7 +833,7 @@ void Pads::getAftertouchLimits()
 
     for (int i=0; i<NUMBER_OF_PADS; i++)
     {
-        uint16_t upperPressure_limit = database.read(DB_BLOCK_PAD_CALIBRATION, padCalibrationPressureUpperSection, i);
+        uint16_t upperPressure_limit = database.read<DB_BLOCK_PAD_CALIBRATION, padCalibrationPressureUpperSection>(i);
 
         int32_t lowerLimit = upperPressure_limit + (int32_t)((upperPressure_limit * (int32_t)100) * (uint32_t)AFTERTOUCH_PRESSURE_RATIO_LOWER) / 10000;
         int32_t upperLimit = lowerLimit + (int32_t)((lowerLimit * (int32_t)100) * (uint32_t)AFTERTOUCH_PRESSURE_RATIO_UPPER) / 10000;
@@ -814,6 +841,8 @@ void Pads::getAftertouchLimits()
         padAftertouchLimitLower[i] = lowerLimit;
         padAftertouchLimitUpper[i] = upperLimit;
 
+        updatePressureScalers(i);
+
         #ifdef DEBUG
         printf_P(PSTR("Lower aftertouch limit for pad %d: %d\n"), i, padAftertouchLimitLower[i]);
         printf_P(PSTR("Upper aftertouch limit for pad %d: %d\n"), i, padAftertouchLimitUpper[i]);
@@ -832,8 +861,10 @@ void Pads::getXLimits()
 
     for (int i=0; i<NUMBER_OF_PADS; i++)
     {
-        padXLimitLower[i] = database.read(DB_BLOCK_PAD_CALIBRATION, padCalibrationXlowerSection, i);
-        padXLimitUpper[i] = database.read(DB_BLOCK_PAD_CALIBRATION, padCalibrationXupperSection, i);
+        padXLimitLower[i] = database.read<DB_BLOCK_PAD_CALIBRATION, padCalibrationXlowerSection>(i);
+        padXLimitUpper[i] = database.read<DB_BLOCK_PAD_CALIBRATION, padCalibrationXupperSection>(i);
+
+        updateXYscalers(i);
 
         #ifdef DEBUG
         printf_P(PSTR("Lower X limit for pad %d: %d\n"), i, padXLimitLower[i]);
@@ -857,8 +888,10 @@ void Pads::getYLimits()
 
     for (int i=0; i<NUMBER_OF_PADS; i++)
     {
-        padYLimitLower[i] = database.read(DB_BLOCK_PAD_CALIBRATION, padCalibrationYlowerSection, i);
-        padYLimitUpper[i] = database.read(DB_BLOCK_PAD_CALIBRATION, padCalibrationYupperSection, i);
+        padYLimitLower[i] = database.read<DB_BLOCK_PAD_CALIBRATION, padCalibrationYlowerSection>(i);
+        padYLimitUpper[i] = database.read<DB_BLOCK_PAD_CALIBRATION, padCalibrationYupperSection>(i);
+
+        updateXYscalers(i);
 
         #ifdef DEBUG
         printf_P(PSTR("Lower Y limit for pad %d: %d\n"), i, padYLimitLower[i]);
@@ -871,6 +904,75 @@ void Pads::getYLimits()
     #endif
 }
 
+///
+/// \brief Rebuilds velocity and aftertouch scalers for specified pad from current pressure limits.
+/// @param [in] pad     Pad for which scalers are being rebuilt.
+///
+void Pads::updatePressureScalers(int8_t pad)
+{
+    padScaler[pad][scalerVelocity] = scalerMultiplier((int32_t)padPressureLimitUpper[pad] - 1, 127, SCALER_SHIFT_7B);
+    padScaler[pad][scalerAftertouch] = scalerMultiplier((int32_t)padAftertouchLimitUpper[pad] - padAftertouchLimitLower[pad], 127, SCALER_SHIFT_7B);
+}
+
+///
+/// \brief Rebuilds X and Y scalers for specified pad from current X and Y limits.
+/// @param [in] pad     Pad for which scalers are being rebuilt.
+///
+void Pads::updateXYscalers(int8_t pad)
+{
+    int32_t xRange = (int32_t)padXLimitUpper[pad] - padXLimitLower[pad];
+    int32_t yRange = (int32_t)padYLimitUpper[pad] - padYLimitLower[pad];
+
+    padScaler[pad][scalerX_7b] = scalerMultiplier(xRange, 127, SCALER_SHIFT_7B);
+    padScaler[pad][scalerX_raw] = scalerMultiplier(xRange, 1023, SCALER_SHIFT_RAW);
+    padScaler[pad][scalerY_7b] = scalerMultiplier(yRange, 127, SCALER_SHIFT_7B);
+    padScaler[pad][scalerY_raw] = scalerMultiplier(yRange, 1023, SCALER_SHIFT_RAW);
+    padScaler[pad][scalerX_14b] = scalerMultiplierCeil(xRange << XY_FILTER_FRACTION_BITS, CURVE_POSITION_MAX, SCALER_SHIFT_14B);
+    padScaler[pad][scalerY_14b] = scalerMultiplierCeil(yRange << XY_FILTER_FRACTION_BITS, CURVE_POSITION_MAX, SCALER_SHIFT_14B);
+}
+
+///
+/// \brief Scales value within specified limits to output range of requested scaler (0-127, 0-1023 or 0-CURVE_POSITION_MAX).
+/// Uses precomputed multiplier if available, otherwise falls back to regular range mapping.
+/// @param [in] pad         Pad which is being checked.
+/// @param [in] scaler      Scaler to use (enumerated type). See padScaler_t enumeration.
+/// @param [in] value       Raw value.
+/// @param [in] lowerLimit  Lower input limit.
+/// @param [in] upperLimit  Upper input limit.
+/// \returns Scaled value.
+///
+uint16_t Pads::scaleValue(int8_t pad, padScaler_t scaler, uint16_t value, uint16_t lowerLimit, uint16_t upperLimit)
+{
+    uint16_t outRange;
+    uint8_t shift;
+    uint32_t multiplier = padScaler[pad][scaler];
+
+    switch(scaler)
+    {
+        case scalerX_raw:
+        case scalerY_raw:
+        outRange = 1023;
+        shift = SCALER_SHIFT_RAW;
+        break;
+
+        case scalerX_14b:
+        case scalerY_14b:
+        outRange = CURVE_POSITION_MAX;
+        shift = SCALER_SHIFT_14B;
+        break;
+
+        default:
+        outRange = 127;
+        shift = SCALER_SHIFT_7B;
+        break;
+    }
+
+    if (!multiplier)
+        return curves.map(CONSTRAIN(value, lowerLimit, upperLimit), lowerLimit, upperLimit, 0, outRange);
+
+    return scalerApply(CONSTRAIN(value, lowerLimit, upperLimit) - lowerLimit, multiplier, shift);
+}
+
 ///
 /// \brief Checks how many notes there are in requested predefined scale.
 /// @param [in] scale   Scale which is being checked.
@@ -928,24 +1030,38 @@ uint8_t Pads::getScaledPressure(int8_t pad, uint16_t pressure, pressureType_t ty
     switch(type)
     {
         case pressureAftertouch:
-        return curves.map(CONSTRAIN(pressure, padAftertouchLimitLower[pad], padAftertouchLimitUpper[pad]), padAftertouchLimitLower[pad], padAftertouchLimitUpper[pad], 0, 127);
+        return scaleValue(pad, scalerAftertouch, pressure, padAftertouchLimitLower[pad], padAftertouchLimitUpper[pad]);
         break;
 
         case pressureVelocity:
         if (!pressure)
             return 0;
         else
-            return curves.map(CONSTRAIN(pressure, 1, padPressureLimitUpper[pad]), 1, padPressureLimitUpper[pad], 0, 127);
+            return scaleValue(pad, scalerVelocity, pressure, 1, padPressureLimitUpper[pad]);
         break;
     }
 
     return 0;
 }
 
+///
+/// \brief Calculates MIDI velocity from raw pressure on specified pad.
+/// Pressure is scaled with velocity sensitivity (see getScaledPressure) and passed
+/// through velocity curve. Used for both note on and release velocity.
+/// @param [in] pad             Pad which is being checked.
+/// @param [in] pressure        Raw pressure reading (0-1023) or pressure drop on release.
+/// \returns Velocity (0-127).
+///
+uint8_t Pads::getVelocity(int8_t pad, uint16_t pressure)
+{
+    return curves.getCurveValue(velocityCurve, getScaledPressure(pad, pressure, pressureVelocity), 0, 127);
+}
+
 ///
 /// \brief Calculates scaled X or Y value from raw reading (0-1023) on specified pad.
 /// @param [in] pad         Pad which is being checked.
-/// @param [in] xyValue     Raw X or Y value (0-1023).
+/// @param [in] xyValue     Raw X or Y value (0-1023). Filtered value with XY_FILTER_FRACTION_BITS fraction bits
+///                         is expected on midiScale_14b_cc scaling, which returns curve position (see Curves::getCurveValue14b).
 /// @param [in] type        Coordinate which is being checked (X or Y). Enumerated type. See padCoordinate_t enumeration.
 /// @param [in] scaleType   Type of scaling (enumerated type, see valueScaleType_t).
 ///
@@ -972,6 +1088,13 @@ uint16_t Pads::getScaledXY(int8_t pad, uint16_t xyValue, padCoordinate_t type, v
         max = MIDI_PITCHBEND_MAX;
         break;
 
+        case midiScale_14b_cc:
+        //value with filter fraction bits, limits need to be in the same format
+        if (type == coordinateX)
+            return scaleValue(pad, scalerX_14b, xyValue, padXLimitLower[pad] << XY_FILTER_FRACTION_BITS, padXLimitUpper[pad] << XY_FILTER_FRACTION_BITS);
+        else
+            return scaleValue(pad, scalerY_14b, xyValue, padYLimitLower[pad] << XY_FILTER_FRACTION_BITS, padYLimitUpper[pad] << XY_FILTER_FRACTION_BITS);
+
         default:
         return 0;
     }
@@ -981,10 +1104,10 @@ uint16_t Pads::getScaledXY(int8_t pad, uint16_t xyValue, padCoordinate_t type, v
         switch (type)
         {
             case coordinateX:
-            return curves.map(CONSTRAIN(xyValue, padXLimitLower[pad], padXLimitUpper[pad]), padXLimitLower[pad], padXLimitUpper[pad], min, max);
+            return scaleValue(pad, (scaleType == rawScale) ? scalerX_raw : scalerX_7b, xyValue, padXLimitLower[pad], padXLimitUpper[pad]);
 
             case coordinateY:
-            return curves.map(CONSTRAIN(xyValue, padYLimitLower[pad], padYLimitUpper[pad]), padYLimitLower[pad], padYLimitUpper[pad], min, max);
+            return scaleValue(pad, (scaleType == rawScale) ? scalerY_raw : scalerY_7b, xyValue, padYLimitLower[pad], padYLimitUpper[pad]);
 
             default:
             return 0;
@@ -996,12 +1119,12 @@ uint16_t Pads::getScaledXY(int8_t pad, uint16_t xyValue, padCoordinate_t type, v
 
         if (type == coordinateX)
         {
-            value = curves.map(CONSTRAIN(xyValue, padXLimitLower[pad], padXLimitUpper[pad]), padXLimitLower[pad], padXLimitUpper[pad], 0, 1023);
+            value = scaleValue(pad, scalerX_raw, xyValue, padXLimitLower[pad], padXLimitUpper[pad]);
             initialPosition = initialXposition[pad];
         }
         else
         {
-            value = curves.map(CONSTRAIN(xyValue, padYLimitLower[pad], padYLimitUpper[pad]), padYLimitLower[pad], padYLimitUpper[pad], 0, 1023);
+            value = scaleValue(pad, scalerY_raw, xyValue, padYLimitLower[pad], padYLimitUpper[pad]);
             initialPosition = initialYposition[pad];
         }
 
@@ -1106,4 +1229,23 @@ bool Pads::getPitchBendState(int8_t pad, padCoordinate_t coordinate)
     }
 }
 
+///
+/// \brief Checks if 14-bit CC messages are sent on requested coordinate of requested pad.
+/// @param [in] pad         Pad which is being checked.
+/// @param [in] coordinate  Coordinate which is being checked (enumerated type). See padCoordinate_t enumeration.
+/// \returns True if 14-bit resolution is active, pitch bend isn't used and CC on requested coordinate has LSB pair, false otherwise.
+///
+bool Pads::getCC14bitState(int8_t pad, padCoordinate_t coordinate)
+{
+    assert(PAD_CHECK(pad));
+
+    if (xyResolution != xyResolution14bit)
+        return false;
+
+    if (getPitchBendState(pad, coordinate))
+        return false;
+
+    return cc14bitAvailable((coordinate == coordinateX) ? ccXPad[pad] : ccYPad[pad]);
+}
+
 /// @}
@@ -0,0 +1,102 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#pragma once
+
+#include <inttypes.h>
+#include "Config.h"
+
+///
+/// \ingroup interfacePads
+/// @{
+
+///
+/// \brief 14-bit CC messages for X and Y coordinates.
+/// Value is sent as MSB on CC n and LSB on CC n+32. Receiver sets its LSB to zero once MSB
+/// is received, so LSB is sent along with MSB only when it isn't zero. When only LSB has
+/// changed, it is sent alone, but not more often than once in XY_LSB_SEND_INTERVAL
+/// milliseconds. LSB which hasn't been sent because of that is sent once interval passes.
+/// @{
+
+///
+/// \brief Number of CC controllers which have LSB pair (0-31).
+///
+#define CC_14BIT_CONTROLLERS        32
+
+///
+/// \brief Difference between LSB and MSB controller number.
+///
+#define CC_14BIT_LSB_OFFSET         32
+
+///
+/// \brief Parts of 14-bit CC value which need to be sent.
+/// @{
+
+#define CC_14BIT_SEND_MSB           0x01
+#define CC_14BIT_SEND_LSB           0x02
+
+/// @}
+
+///
+/// \brief Checks whether 14-bit CC messages can be sent on specified controller.
+/// @param [in] cc  CC controller number.
+/// \returns True if controller has LSB pair, false otherwise.
+///
+inline bool cc14bitAvailable(uint8_t cc)
+{
+    return cc < CC_14BIT_CONTROLLERS;
+}
+
+///
+/// \brief Checks which parts of new 14-bit CC value need to be sent.
+/// @param [in] value       New value (0-16383).
+/// @param [in] msb         MSB which has been sent last.
+/// @param [in] lsb         LSB as known to receiver.
+/// @param [in] lsbTime_ms  Time in milliseconds since LSB has been sent last.
+/// \returns Combination of CC_14BIT_SEND_MSB and CC_14BIT_SEND_LSB, 0 if nothing needs to be sent.
+///
+inline uint8_t cc14bitCheck(uint16_t value, uint8_t msb, uint8_t lsb, uint32_t lsbTime_ms)
+{
+    uint8_t send = 0;
+
+    if ((value >> 7) != msb)
+    {
+        send |= CC_14BIT_SEND_MSB;
+        //receiver resets LSB on MSB
+        lsb = 0;
+    }
+
+    if ((value & 0x7F) != lsb)
+    {
+        if ((send & CC_14BIT_SEND_MSB) || (lsbTime_ms >= XY_LSB_SEND_INTERVAL))
+            send |= CC_14BIT_SEND_LSB;
+    }
+
+    return send;
+}
+
+/// @}
+
+/// @}
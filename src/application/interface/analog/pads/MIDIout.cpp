@@ -26,6 +26,10 @@
 #include <assert.h>
 #include "Pads.h"
 #include "core/src/general/BitManipulation.h"
+#include "interface/midi/Coalescer.h"
+#ifdef BOARD_HOST
+#include "board/host/Host.h"
+#endif
 
 ///
 /// \ingroup interfacePads
@@ -41,18 +45,34 @@ void Pads::sendX(int8_t pad)
 
     if (getPitchBendState(pad, coordinateX))
     {
-        midi.sendPitchBend(lastXPitchBendValue[pad], midiChannel[pad]);
+        coalescer.sendPitchBend(lastXPitchBendValue[pad], midiChannel[pad]);
         #ifdef DEBUG
         printf_P(PSTR("X for pad %d: %d\n"), pad, lastXPitchBendValue[pad]);
         #endif
     }
+    else if (getCC14bitState(pad, coordinateX))
+    {
+        if (xCC14bitSend[pad] & CC_14BIT_SEND_MSB)
+            coalescer.sendControlChange(ccXPad[pad], lastXCCvalue[pad], midiChannel[pad]);
+
+        if (xCC14bitSend[pad] & CC_14BIT_SEND_LSB)
+            coalescer.sendControlChange(ccXPad[pad]+CC_14BIT_LSB_OFFSET, lastXCCvalueLSB[pad], midiChannel[pad]);
+
+        #ifdef DEBUG
+        printf_P(PSTR("X for pad %d: %d/%d, CC %d\n"), pad, lastXCCvalue[pad], lastXCCvalueLSB[pad], ccXPad[pad]);
+        #endif
+    }
     else
     {
-        midi.sendControlChange(ccXPad[pad], lastXCCvalue[pad], midiChannel[pad]);
+        coalescer.sendControlChange(ccXPad[pad], lastXCCvalue[pad], midiChannel[pad]);
         #ifdef DEBUG
         printf_P(PSTR("X for pad %d: %d, CC %d\n"), pad, lastXCCvalue[pad], ccXPad[pad]);
         #endif
     }
+
+    #ifdef BOARD_HOST
+    hostLatencyEvent(pad, hostLatencyX);
+    #endif
 }
 
 ///
@@ -65,18 +85,123 @@ void Pads::sendY(int8_t pad)
 
     if (getPitchBendState(pad, coordinateY))
     {
-        midi.sendPitchBend(lastYPitchBendValue[pad], midiChannel[pad]);
+        coalescer.sendPitchBend(lastYPitchBendValue[pad], midiChannel[pad]);
         #ifdef DEBUG
         printf_P(PSTR("Y for pad %d: %d\n"), pad, lastYPitchBendValue[pad]);
         #endif
     }
+    else if (getCC14bitState(pad, coordinateY))
+    {
+        if (yCC14bitSend[pad] & CC_14BIT_SEND_MSB)
+            coalescer.sendControlChange(ccYPad[pad], lastYCCvalue[pad], midiChannel[pad]);
+
+        if (yCC14bitSend[pad] & CC_14BIT_SEND_LSB)
+            coalescer.sendControlChange(ccYPad[pad]+CC_14BIT_LSB_OFFSET, lastYCCvalueLSB[pad], midiChannel[pad]);
+
+        #ifdef DEBUG
+        printf_P(PSTR("Y for pad %d: %d/%d, CC %d\n"), pad, lastYCCvalue[pad], lastYCCvalueLSB[pad], ccYPad[pad]);
+        #endif
+    }
     else
     {
-        midi.sendControlChange(ccYPad[pad], lastYCCvalue[pad], midiChannel[pad]);
+        coalescer.sendControlChange(ccYPad[pad], lastYCCvalue[pad], midiChannel[pad]);
         #ifdef DEBUG
         printf_P(PSTR("Y for pad %d: %d, CC %d\n"), pad, lastYCCvalue[pad], ccYPad[pad]);
         #endif
     }
+
+    #ifdef BOARD_HOST
+    hostLatencyEvent(pad, hostLatencyY);
+    #endif
+}
+
+///
+/// \brief Returns key under which note is stored in note reference table.
+///
+static inline uint16_t getNoteKey(uint8_t note, uint8_t channel)
+{
+    return ((uint16_t)((channel-1) & 0x0F) << 7) | (note & 0x7F);
+}
+
+///
+/// \brief Returns index in note reference table at which lookup for key starts.
+///
+static inline uint8_t getNoteKeyHome(uint16_t key)
+{
+    return ((key & 0x7F) ^ ((key >> 4) & 0x78)) & (NOTE_REF_TABLE_SIZE-1);
+}
+
+///
+/// \brief Finds entry for requested note in note reference table.
+/// @param [in] note        MIDI note.
+/// @param [in] channel     MIDI channel.
+/// \returns Index of entry for note or index of empty entry at which note would be stored.
+///
+uint8_t Pads::getNoteRefIndex(uint8_t note, uint8_t channel)
+{
+    uint16_t key = getNoteKey(note, channel);
+    uint8_t index = getNoteKeyHome(key);
+
+    //table is never full
+    while (noteRefCount[index] && (noteRefKey[index] != key))
+        index = (index + 1) & (NOTE_REF_TABLE_SIZE-1);
+
+    return index;
+}
+
+///
+/// \brief Adds reference to requested note.
+/// @param [in] note        MIDI note.
+/// @param [in] channel     MIDI channel.
+///
+void Pads::addNoteRef(uint8_t note, uint8_t channel)
+{
+    uint8_t index = getNoteRefIndex(note, channel);
+
+    noteRefKey[index] = getNoteKey(note, channel);
+    noteRefCount[index]++;
+}
+
+///
+/// \brief Removes reference to requested note.
+/// Once last reference is removed, entries after it are moved back if needed so that
+/// lookup for them doesn't stop at now empty entry.
+/// @param [in] note        MIDI note.
+/// @param [in] channel     MIDI channel.
+/// \returns True if note is still referenced, false otherwise.
+///
+bool Pads::releaseNoteRef(uint8_t note, uint8_t channel)
+{
+    uint8_t index = getNoteRefIndex(note, channel);
+
+    if (!noteRefCount[index])
+        return false;
+
+    if (--noteRefCount[index])
+        return true;
+
+    uint8_t next = index;
+
+    while (true)
+    {
+        next = (next + 1) & (NOTE_REF_TABLE_SIZE-1);
+
+        if (!noteRefCount[next])
+            break;
+
+        uint8_t home = getNoteKeyHome(noteRefKey[next]);
+
+        //entry can be moved to empty one only if its lookup passes empty entry
+        if (((next - home) & (NOTE_REF_TABLE_SIZE-1)) >= ((next - index) & (NOTE_REF_TABLE_SIZE-1)))
+        {
+            noteRefKey[index] = noteRefKey[next];
+            noteRefCount[index] = noteRefCount[next];
+            noteRefCount[next] = 0;
+            index = next;
+        }
+    }
+
+    return false;
 }
 
 ///
@@ -97,6 +222,9 @@ void Pads::sendNotes(int8_t pad, uint8_t velocity, bool state)
         //note on
         if (!getMIDISendState(pad, functionOnOffNotes))
             return;
+
+        //x/y values need to be sent before notes
+        coalescer.flush();
         #ifdef DEBUG
         printf_P(PSTR("Pad %d pressed. Notes:\n"), pad);
         #endif
@@ -111,63 +239,62 @@ void Pads::sendNotes(int8_t pad, uint8_t velocity, bool state)
             #endif
 
             midi.sendNoteOn(padNote[pad][i], velocity, midiChannel[pad]);
+
+            if (!BIT_READ(noteRefPads, pad))
+                addNoteRef(padNote[pad][i], midiChannel[pad]);
         }
 
+        BIT_SET(noteRefPads, pad);
+
         #ifdef DEBUG
         printf_P(PSTR("Velocity: %d\n"), velocity);
         #endif
+
+        #ifdef BOARD_HOST
+        hostLatencyEvent(pad, hostLatencyNoteOn);
+        #endif
         break;
 
         case false:
         //note off
-        if (getMIDISendState(pad, functionOnOffNotes))
         {
-            #ifdef DEBUG
-            printf_P(PSTR("Pad %d released. Notes: \n"), pad);
-            #endif
-            //some special considerations here - don't send note off if same note is active on some other pad
-            for (int i=0; i<NOTES_PER_PAD; i++)
+            bool noteRef = BIT_READ(noteRefPads, pad);
+            bool sendNoteOff = getMIDISendState(pad, functionOnOffNotes);
+
+            BIT_CLEAR(noteRefPads, pad);
+
+            if (sendNoteOff)
             {
-                sendOff = true;
+                coalescer.flush();
+                #ifdef DEBUG
+                printf_P(PSTR("Pad %d released. Notes: \n"), pad);
+                #endif
+            }
 
+            for (int i=0; i<NOTES_PER_PAD; i++)
+            {
                 if (padNote[pad][i] == BLANK_NOTE)
-                continue;
+                    continue;
 
-                for (int j=0; j<NUMBER_OF_PADS; j++)
+                //don't send note off if same note on same channel is still active on some other pad
+                if (noteRef)
                 {
-                    //don't check current pad
-                    if (j == pad)
-                        continue;
-
-                    //don't check released pads
-                    if (!isPadPressed(j))
-                        continue;
-
-                    //don't check pad if noteSend is disabled
-                    if (!BIT_READ(noteSendEnabled, j))
+                    if (releaseNoteRef(padNote[pad][i], midiChannel[pad]))
                         continue;
-
-                    //only send note off if the same note isn't active on some other pad already
-                    if (padNote[j][i] == padNote[pad][i])
-                    {
-                        //extra check here - check if midi channels differ
-                        if (midiChannel[j] == midiChannel[pad])
-                        {
-                            sendOff = false;
-                            break; //no need to check further
-                        }
-                    }
                 }
-
-                if (sendOff)
+                else if (noteRefCount[getNoteRefIndex(padNote[pad][i], midiChannel[pad])])
                 {
-                    #ifdef DEBUG
-                    printf_P(PSTR("%d\n"), padNote[pad][i]);
-                    #endif
-
-                    uint8_t velocity_ = 0;
-                    midi.sendNoteOff(padNote[pad][i], velocity_, midiChannel[pad]);
+                    continue;
                 }
+
+                if (!sendNoteOff)
+                    continue;
+
+                #ifdef DEBUG
+                printf_P(PSTR("%d\n"), padNote[pad][i]);
+                #endif
+
+                midi.sendNoteOff(padNote[pad][i], velocity, midiChannel[pad]);
             }
         }
 
@@ -205,7 +332,7 @@ void Pads::sendNotes(int8_t pad, uint8_t velocity, bool state)
                 printf_P(PSTR("Sending pitch bend 0 for current pad.\n"));
                 #endif
 
-                midi.sendPitchBend(0, midiChannel[pad]);
+                coalescer.sendPitchBend(0, midiChannel[pad]);
             }
         }
         break;
@@ -234,7 +361,7 @@ void Pads::sendAftertouch(int8_t pad)
         for (int i=0; i<NOTES_PER_PAD; i++)
         {
             if (padNote[pad][i] != BLANK_NOTE)
-                midi.sendAfterTouch(padNote[pad][i], aftertouchValue, midiChannel[pad]);
+                coalescer.sendAfterTouch(padNote[pad][i], aftertouchValue, midiChannel[pad]);
         }
         break;
 
@@ -243,7 +370,7 @@ void Pads::sendAftertouch(int8_t pad)
         printf_P(PSTR("Sending channel aftertouch: %d\n"), maxAftertouchValue);
         #endif
 
-        midi.sendAfterTouch(maxAftertouchValue, midiChannel[pad]);
+        coalescer.sendAfterTouch(maxAftertouchValue, midiChannel[pad]);
         break;
     }
 
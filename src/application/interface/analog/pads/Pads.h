@@ -27,6 +27,9 @@
 
 #include "Config.h"
 #include "Sanity.h"
+#include "Velocity.h"
+#include "Filter.h"
+#include "HighRes.h"
 
 ///
 /// \brief Pad updating and processing.
@@ -65,6 +68,9 @@ class Pads
     curve_t getCCcurve(int8_t pad, padCoordinate_t curve);
     velocitySensitivity_t getVelocitySensitivity();
     curve_t getVelocityCurve();
+    velocityEngine_t getVelocityEngine();
+    uint8_t getXYfilter(xyFilterParameter_t parameter);
+    xyResolution_t getXYresolution();
     uint8_t getMIDIchannel(int8_t pad);
     bool isCalibrationEnabled();
     padCoordinate_t getCalibrationMode();
@@ -72,6 +78,7 @@ class Pads
     int8_t getPredefinedScaleNotes(int8_t scale);
     note_t getScaleNote(int8_t scale, int8_t index);
     uint8_t getScaledPressure(int8_t pad, uint16_t pressure, pressureType_t type);
+    uint8_t getVelocity(int8_t pad, uint16_t pressure);
     uint16_t getScaledXY(int8_t pad, uint16_t xyValue, padCoordinate_t type, valueScaleType_t scaleType);
     pitchBendType_t getPitchBendType();
     bool getPitchBendState(int8_t pad, padCoordinate_t coordinate);
@@ -86,6 +93,9 @@ class Pads
     changeResult_t setMIDIchannel(int8_t pad, int8_t channel);
     changeResult_t setVelocitySensitivity(velocitySensitivity_t type);
     changeResult_t setVelocityCurve(curve_t curve);
+    changeResult_t setVelocityEngine(velocityEngine_t engine);
+    changeResult_t setXYfilter(xyFilterParameter_t parameter, int16_t value);
+    changeResult_t setXYresolution(xyResolution_t resolution);
     changeResult_t setCCcurve(padCoordinate_t coordinate, int16_t curve);
     changeResult_t setCCvalue(padCoordinate_t coordinate, int16_t cc);
     changeResult_t setCClimit(padCoordinate_t coordinate, limitType_t limitType, int16_t value);
@@ -108,11 +118,17 @@ class Pads
     void getYLimits();
     void getPressureLimits();
     void getAftertouchLimits();
+    void updatePressureScalers(int8_t pad);
+    void updateXYscalers(int8_t pad);
+    uint16_t scaleValue(int8_t pad, padScaler_t scaler, uint16_t value, uint16_t lowerLimit, uint16_t upperLimit);
     void getPadParameters();
     bool isAftertouchActivated(int8_t pad);
     dbSection_padCalibration_t getPressureZone(int8_t pad);
 
     void setPadPressState(int8_t pad, bool state);
+    uint8_t getNoteRefIndex(uint8_t note, uint8_t channel);
+    void addNoteRef(uint8_t note, uint8_t channel);
+    bool releaseNoteRef(uint8_t note, uint8_t channel);
     void updateNoteLEDs(int8_t pad, bool state);
     void updateLastPressedPad(int8_t pad, bool state);
 
@@ -122,6 +138,7 @@ class Pads
     bool checkAftertouch(int8_t pad, bool velocityAvailable, int16_t value);
     bool checkX(int8_t pad, int16_t value);
     bool checkY(int8_t pad, int16_t value);
+    bool getCC14bitState(int8_t pad, padCoordinate_t coordinate);
     void checkDisplayData(int8_t pad, bool velocityAvailable, bool aftertouchAvailable, bool xAvailable, bool yAvailable);
 
     void sendNotes(int8_t pad, uint8_t velocity, bool state);
@@ -143,6 +160,21 @@ class Pads
 
     /// @}
 
+    ///
+    /// \brief Arrays holding 14-bit X/Y CC state for each pad (see HighRes.h).
+    /// LSB values are values known to receiver, MSB values are held in lastXCCvalue and lastYCCvalue.
+    /// @{
+
+    uint8_t                 lastXCCvalueLSB[NUMBER_OF_PADS],
+                            lastYCCvalueLSB[NUMBER_OF_PADS],
+                            xCC14bitSend[NUMBER_OF_PADS],
+                            yCC14bitSend[NUMBER_OF_PADS];
+
+    uint32_t                lastXLSBsendTime[NUMBER_OF_PADS],
+                            lastYLSBsendTime[NUMBER_OF_PADS];
+
+    /// @}
+
     int16_t                 lastRawXValue[NUMBER_OF_PADS],
                             lastRawYValue[NUMBER_OF_PADS];
 
@@ -168,6 +200,19 @@ class Pads
     ///
     uint16_t                lastMIDInoteState;
 
+    ///
+    /// \brief Release detection state for all pads.
+    /// Release velocity is taken from here as well.
+    ///
+    velocityRelease_t       releaseState[NUMBER_OF_PADS];
+
+    ///
+    /// \brief Variable holding pads which have been released on pressure decay and which
+    /// can't be pressed again until velocityReleaseRearm allows it.
+    /// \warning Variable type assumes there can be no more than 16 pads since each bit holds value for single pad.
+    ///
+    uint16_t                releaseRearmPending;
+
     ///
     /// \brief Array holding CC controller number for every pad on X and Y coordinates.
     /// @{
@@ -234,6 +279,12 @@ class Pads
 
     /// @}
 
+    ///
+    /// \brief Fixed-point multipliers used to scale raw readings on all pads without division.
+    /// Rebuilt each time pad limits change. See Scaler.h.
+    ///
+    uint32_t                padScaler[NUMBER_OF_PADS][NUMBER_OF_PAD_SCALERS];
+
     ///
     /// \brief Array holding MIDI notes for every pad.
     /// Each pad can have several notes. See value of NOTES_PER_PAD.
@@ -245,6 +296,33 @@ class Pads
     ///
     uint8_t                 midiChannel[NUMBER_OF_PADS];
 
+    ///
+    /// \brief Reference counts of notes which have been sent as note on and haven't been released yet.
+    /// Open addressing table indexed by MIDI channel and note, see getNoteRefIndex.
+    /// Entry with zero count is empty.
+    /// @{
+
+    uint16_t                noteRefKey[NOTE_REF_TABLE_SIZE];
+    uint8_t                 noteRefCount[NOTE_REF_TABLE_SIZE];
+
+    /// @}
+
+    ///
+    /// \brief Variable holding pads whose notes are counted in note reference table.
+    /// \warning Variable type assumes there can be no more than 16 pads since each bit holds value for single pad.
+    ///
+    uint16_t                noteRefPads;
+
+    ///
+    /// \brief Array holding tonics shown as active on note LEDs for every pad, single bit per tonic (see note_t).
+    ///
+    uint16_t                padTonicMask[NUMBER_OF_PADS];
+
+    ///
+    /// \brief Array holding number of pads on which each tonic is active.
+    ///
+    uint8_t                 tonicRefCount[MIDI_NOTES];
+
     ///
     /// \brief Holds active aftertouch type.
     ///
@@ -262,6 +340,24 @@ class Pads
     ///
     bool                    splitEnabled;
 
+    ///
+    /// \brief Holds velocity engine used in active program.
+    /// Enumerated type (see velocityEngine_t enumeration).
+    ///
+    velocityEngine_t        velocityEngine;
+
+    ///
+    /// \brief Holds X/Y filter parameters used in active program.
+    /// See xyFilterParameter_t enumeration.
+    ///
+    uint8_t                 xyFilterParameter[XY_FILTER_PARAMETERS];
+
+    ///
+    /// \brief Holds resolution of X/Y CC messages used in active program.
+    /// Enumerated type (see xyResolution_t enumeration).
+    ///
+    xyResolution_t          xyResolution;
+
     ///
     /// \brief Holds active scale.
     ///
@@ -299,12 +395,12 @@ class Pads
     curve_t                 velocityCurve;
 
     ///
-    /// \brief Arrays holding last time in milliseconds values on X or Y coordinate have been changed for each pad.
-    /// Used to detect value bounce.
+    /// \brief Arrays holding X/Y filter state for each pad.
+    /// Used to smooth X/Y values and to detect value bounce.
     /// @{
 
-    uint32_t                xSendTimer[NUMBER_OF_PADS],
-                            ySendTimer[NUMBER_OF_PADS];
+    xyFilter_t              xFilter[NUMBER_OF_PADS],
+                            yFilter[NUMBER_OF_PADS];
 
     /// @}
 
@@ -377,15 +473,11 @@ class Pads
     /// @}
 
     ///
-    /// \brief Array holding three samples for pressure reading for all pads.
-    /// Pressure is selected as maximum value.
-    ///
-    uint16_t                pressureSamples[NUMBER_OF_PADS][STABLE_SAMPLE_COUNT];
-
-    ///
-    /// \brief Holds current sample count for pressure reading for all pads.
+    /// \brief Pressure sampling state for all pads.
+    /// Pressure is selected as maximum value. Slope velocity engine tracks readings
+    /// since press threshold has been crossed here until pad is pressed.
     ///
-    uint8_t                 pressureSampleCounter[NUMBER_OF_PADS];
+    velocitySamples_t       pressureSamples[NUMBER_OF_PADS];
 };
 
 ///
@@ -0,0 +1,109 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#pragma once
+
+#include <inttypes.h>
+
+///
+/// \ingroup interfacePads
+/// @{
+
+///
+/// \brief Fixed-point replacement for range mapping of pad readings.
+/// Mapping value n from input range (0-inRange) to output range (0-outRange) requires
+/// division by inRange. Since ranges change only when pad limits change, reciprocal
+/// is precomputed as multiplier M = ceil((outRange << shift) / inRange) so that scaling
+/// becomes (n * M) >> shift. Result is identical to integer division as long as
+/// inRange * inRange <= (1 << shift). Multiplier is set to 0 when that isn't the case
+/// (or when range is empty) and caller needs to fall back to division.
+/// @{
+
+///
+/// \brief Shift used for 7-bit (0-127) output range.
+/// Largest shift for which (127 << shift) still fits into 32 bits, allows input ranges up to 5792.
+///
+#define SCALER_SHIFT_7B         25
+
+///
+/// \brief Shift used for raw (0-1023) output range, allows input ranges up to 2048.
+///
+#define SCALER_SHIFT_RAW        22
+
+///
+/// \brief Shift used for 14-bit CC position range (see HighRes.h).
+/// Largest shift for which (16256 << shift) still fits into 32 bits. Input ranges are too
+/// large for exact scaling so scalerMultiplierCeil is used with this shift.
+///
+#define SCALER_SHIFT_14B        18
+
+///
+/// \brief Calculates fixed-point multiplier for specified ranges.
+/// @param [in] inRange     Difference between upper and lower input limit.
+/// @param [in] outRange    Largest output value.
+/// @param [in] shift       Fixed-point shift (SCALER_SHIFT_7B or SCALER_SHIFT_RAW).
+/// \returns Multiplier or 0 if exact scaling isn't possible with specified ranges.
+///
+inline uint32_t scalerMultiplier(int32_t inRange, uint16_t outRange, uint8_t shift)
+{
+    if ((inRange <= 0) || ((uint32_t)inRange * (uint32_t)inRange > ((uint32_t)1 << shift)))
+        return 0;
+
+    return (((uint32_t)outRange << shift) + (uint32_t)inRange - 1) / (uint32_t)inRange;
+}
+
+///
+/// \brief Calculates fixed-point multiplier for specified ranges without exactness check.
+/// Result of scaling can be larger by one than with division for some input values, which
+/// is acceptable on high-resolution output ranges. Largest input value is still scaled
+/// exactly to largest output value as long as inRange < (1 << shift).
+/// @param [in] inRange     Difference between upper and lower input limit.
+/// @param [in] outRange    Largest output value.
+/// @param [in] shift       Fixed-point shift.
+/// \returns Multiplier or 0 if range is empty.
+///
+inline uint32_t scalerMultiplierCeil(int32_t inRange, uint16_t outRange, uint8_t shift)
+{
+    if (inRange <= 0)
+        return 0;
+
+    return (((uint32_t)outRange << shift) + (uint32_t)inRange - 1) / (uint32_t)inRange;
+}
+
+///
+/// \brief Scales value using precomputed multiplier.
+/// @param [in] value       Value relative to lower input limit (0-inRange).
+/// @param [in] multiplier  Multiplier calculated using scalerMultiplier.
+/// @param [in] shift       Shift used when calculating multiplier.
+/// \returns Scaled value.
+///
+inline uint16_t scalerApply(uint16_t value, uint32_t multiplier, uint8_t shift)
+{
+    return ((uint32_t)value * multiplier) >> shift;
+}
+
+/// @}
+
+/// @}
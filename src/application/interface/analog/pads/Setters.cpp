@@ -33,6 +33,7 @@
 #include "board/common/analog/Variables.h"
 #include "core/src/general/BitManipulation.h"
 #include "board/Board.h"
+#include "curves/Curves.h"
 
 ///
 /// \ingroup interfacePads
@@ -58,6 +59,9 @@ changeResult_t Pads::setProgram(int8_t program)
     if (program != activeProgram)
     {
         database.update(DB_BLOCK_PROGRAM, programLastActiveProgramSection, (uint16_t)0, program);
+        //store all pending settings on program change so that only few recent changes can be lost
+        //settings are written from main loop so that program change doesn't wait for memory
+        writeCache.drain();
         getProgramParameters();
         return valueChanged;
     }
@@ -354,7 +358,7 @@ changeResult_t Pads::setMIDISendState(function_t type, bool state)
         printf_P(PSTR("%s for all pads.\n"), state ? "on" : "off");
         #endif
 
-        if (database.read(DB_BLOCK_PROGRAM, programGlobalSettingsSection, configurationID+(GLOBAL_PROGRAM_SETTINGS*(uint16_t)activeProgram)) != state)
+        if (database.read<DB_BLOCK_PROGRAM, programGlobalSettingsSection>(configurationID+(GLOBAL_PROGRAM_SETTINGS*(uint16_t)activeProgram)) != state)
         {
             database.update(DB_BLOCK_PROGRAM, programGlobalSettingsSection, configurationID+(GLOBAL_PROGRAM_SETTINGS*(uint16_t)activeProgram), state);
             for (int i=0; i<NUMBER_OF_PADS; i++)
@@ -371,7 +375,7 @@ changeResult_t Pads::setMIDISendState(function_t type, bool state)
         #ifdef DEBUG
         printf_P(PSTR("%s for pad %d.\n"), state ? "on" : "off", lastTouchedPad);
         #endif
-        if (database.read(DB_BLOCK_PROGRAM, programLocalSettingsSection, (LOCAL_PROGRAM_SETTINGS*(uint16_t)lastTouchedPad+configurationID)+(LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*(uint16_t)activeProgram)) != state)
+        if (database.read<DB_BLOCK_PROGRAM, programLocalSettingsSection>((LOCAL_PROGRAM_SETTINGS*(uint16_t)lastTouchedPad+configurationID)+(LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*(uint16_t)activeProgram)) != state)
         {
             database.update(DB_BLOCK_PROGRAM, programLocalSettingsSection, (LOCAL_PROGRAM_SETTINGS*(uint16_t)lastTouchedPad+configurationID)+(LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*(uint16_t)activeProgram), state);
             BIT_WRITE(*variablePointer, lastTouchedPad, state);
@@ -423,7 +427,7 @@ changeResult_t Pads::setAftertouchType(aftertouchType_t type)
         return outOfRange; //wrong argument
     }
 
-    if (database.read(DB_BLOCK_GLOBAL_SETTINGS, globalSettingsMIDI, MIDI_SETTING_AFTERTOUCH_TYPE_ID) != type)
+    if (database.read<DB_BLOCK_GLOBAL_SETTINGS, globalSettingsMIDI>(MIDI_SETTING_AFTERTOUCH_TYPE_ID) != type)
     {
         database.update(DB_BLOCK_GLOBAL_SETTINGS, globalSettingsMIDI, MIDI_SETTING_AFTERTOUCH_TYPE_ID, (uint8_t)type);
 
@@ -542,6 +546,7 @@ changeResult_t Pads::setVelocityCurve(curve_t curve)
     {
         velocityCurve = curve;
         database.update(DB_BLOCK_GLOBAL_SETTINGS, globalSettingsVelocitySensitivity, VELOCITY_SETTING_CURVE_ID, curve);
+        curves.invalidateTables();
         return valueChanged;
     }
     else
@@ -550,6 +555,112 @@ changeResult_t Pads::setVelocityCurve(curve_t curve)
     }
 }
 
+///
+/// \brief Changes velocity engine used in active program.
+/// @param [in] engine  Velocity engine (enumerated type). See velocityEngine_t enumeration.
+/// \returns Result of changing velocity engine (enumerated type). See changeResult_t enumeration.
+///
+changeResult_t Pads::setVelocityEngine(velocityEngine_t engine)
+{
+    if (engine >= VELOCITY_ENGINES)
+        return outOfRange;
+
+    //engines keep different state while pads are being pressed
+    if (pads.getNumberOfPressedPads())
+        return releasePads;
+
+    if (velocityEngine != engine)
+    {
+        velocityEngine = engine;
+        database.update(DB_BLOCK_PROGRAM_EXTENDED, programExtendedSettingsSection, EXTENDED_PROGRAM_SETTING_VELOCITY_ENGINE_ID+(EXTENDED_PROGRAM_SETTINGS*(uint16_t)activeProgram), (uint8_t)(velocityEngine - EXTENDED_PROGRAM_SETTING_VELOCITY_ENGINE));
+
+        #ifdef DEBUG
+        printf_P(PSTR("Velocity engine: %s\n"), (velocityEngine == velocityEngineSlope) ? "slope" : "max");
+        #endif
+
+        return valueChanged;
+    }
+
+    return noChange;
+}
+
+///
+/// \brief Changes X/Y filter parameter used in active program.
+/// @param [in] parameter   Filter parameter (enumerated type). See xyFilterParameter_t enumeration.
+/// @param [in] value       New value (1-255 for cutoff, 0-255 for beta).
+/// \returns Result of changing filter parameter (enumerated type). See changeResult_t enumeration.
+///
+changeResult_t Pads::setXYfilter(xyFilterParameter_t parameter, int16_t value)
+{
+    uint8_t id, defaultValue;
+
+    switch(parameter)
+    {
+        case xyFilterCutoff:
+        //filter would never move with zero cutoff
+        if ((value < 1) || (value > 255))
+            return outOfRange;
+
+        id = EXTENDED_PROGRAM_SETTING_XY_FILTER_CUTOFF_ID;
+        defaultValue = EXTENDED_PROGRAM_SETTING_XY_FILTER_CUTOFF;
+        break;
+
+        case xyFilterBeta:
+        if ((value < 0) || (value > 255))
+            return outOfRange;
+
+        id = EXTENDED_PROGRAM_SETTING_XY_FILTER_BETA_ID;
+        defaultValue = EXTENDED_PROGRAM_SETTING_XY_FILTER_BETA;
+        break;
+
+        default:
+        return outOfRange;
+    }
+
+    if (xyFilterParameter[parameter] != value)
+    {
+        xyFilterParameter[parameter] = value;
+        database.update(DB_BLOCK_PROGRAM_EXTENDED, programExtendedSettingsSection, id+(EXTENDED_PROGRAM_SETTINGS*(uint16_t)activeProgram), (uint8_t)(value - defaultValue));
+
+        #ifdef DEBUG
+        printf_P(PSTR("X/Y filter %s: %d\n"), (parameter == xyFilterCutoff) ? "cutoff" : "beta", value);
+        #endif
+
+        return valueChanged;
+    }
+
+    return noChange;
+}
+
+///
+/// \brief Changes resolution of X/Y CC messages used in active program.
+/// @param [in] resolution  CC resolution (enumerated type). See xyResolution_t enumeration.
+/// \returns Result of changing CC resolution (enumerated type). See changeResult_t enumeration.
+///
+changeResult_t Pads::setXYresolution(xyResolution_t resolution)
+{
+    if (resolution >= XY_RESOLUTIONS)
+        return outOfRange;
+
+    //last sent values and filter hysteresis differ between resolutions
+    if (pads.getNumberOfPressedPads())
+        return releasePads;
+
+    if (xyResolution != resolution)
+    {
+        xyResolution = resolution;
+        database.update(DB_BLOCK_PROGRAM_EXTENDED, programExtendedSettingsSection, EXTENDED_PROGRAM_SETTING_XY_RESOLUTION_ID+(EXTENDED_PROGRAM_SETTINGS*(uint16_t)activeProgram), (uint8_t)(xyResolution - EXTENDED_PROGRAM_SETTING_XY_RESOLUTION));
+
+        #ifdef DEBUG
+        printf_P(PSTR("X/Y resolution: %s\n"), (xyResolution == xyResolution14bit) ? "14-bit" : "7-bit");
+        #endif
+
+        return valueChanged;
+    }
+
+    return noChange;
+}
+
 ///
 /// \brief Changes curve for CC MIDI messages on requested coordinate.
 /// @param [in] coordinate  Coordinate on which curve is being changed (enumerated type). See padCoordinate_t enumeration.
@@ -617,6 +728,8 @@ changeResult_t Pads::setCCcurve(padCoordinate_t coordinate, int16_t curve)
         break;
     }
 
+    //curve tables for previous configuration are no longer needed
+    curves.invalidateTables();
     return valueChanged;
 }
 
@@ -814,6 +927,8 @@ changeResult_t Pads::setCClimit(padCoordinate_t coordinate, limitType_t limitTyp
         break;
     }
 
+    //curve tables for previous configuration are no longer needed
+    curves.invalidateTables();
     return valueChanged;
 }
 
@@ -899,7 +1014,7 @@ changeResult_t Pads::calibratePressure(int8_t pad, int16_t limit, bool updateMID
 {
     assert(PAD_CHECK(pad));
 
-    if (database.read(DB_BLOCK_PAD_CALIBRATION, padCalibrationPressureUpperSection, pad) != limit)
+    if (database.read<DB_BLOCK_PAD_CALIBRATION, padCalibrationPressureUpperSection>(pad) != limit)
     {
         #ifdef DEBUG
         printf_P(PSTR("Calibrating pressure for pad %d. New value: %d\n"), pad, limit);
@@ -984,6 +1099,7 @@ changeResult_t Pads::calibrateXY(int8_t pad, padCoordinate_t type, limitType_t l
     {
         variablePointer[pad] = limit;
         database.update(DB_BLOCK_PAD_CALIBRATION, configurationSection, (uint16_t)pad, limit);
+        updateXYscalers(pad);
 
         if (updateMIDIvalue)
         {
@@ -1261,7 +1377,7 @@ changeResult_t Pads::setScaleShiftLevel(int8_t shiftLevel, bool internalChange)
 
     int8_t scaleNotes = getPredefinedScaleNotes(activeScale);
     int8_t octaveShift = 0;
-    int8_t currentShiftLevel = database.read(DB_BLOCK_SCALE, scalePredefinedSection, PREDEFINED_SCALE_SHIFT_ID+((PREDEFINED_SCALE_PARAMETERS*PREDEFINED_SCALES)*(uint16_t)activeProgram)+PREDEFINED_SCALE_PARAMETERS*(uint16_t)activeScale);
+    int8_t currentShiftLevel = database.read<DB_BLOCK_SCALE, scalePredefinedSection>(PREDEFINED_SCALE_SHIFT_ID+((PREDEFINED_SCALE_PARAMETERS*PREDEFINED_SCALES)*(uint16_t)activeProgram)+PREDEFINED_SCALE_PARAMETERS*(uint16_t)activeScale);
 
     //overflow check
     if (shiftLevel < 0)
@@ -1427,59 +1543,43 @@ void Pads::updateNoteLEDs(int8_t pad, bool state)
 {
     assert(PAD_CHECK(pad));
 
-    uint8_t noteArray[NOTES_PER_PAD],
-    noteCounter = 0;
-
-    for (int i=0; i<NOTES_PER_PAD; i++)
-    {
-        if (padNote[pad][i] != BLANK_NOTE)
-        {
-            noteArray[noteCounter] = padNote[pad][i];
-            noteCounter++;
-        }
-    }
-
     switch(state)
     {
         case true:
         //note on
-        uint8_t tonicArray[NOTES_PER_PAD];
+        if (padTonicMask[pad])
+            return;
 
-        for (int i=0; i<noteCounter; i++)
+        for (int i=0; i<NOTES_PER_PAD; i++)
         {
-            tonicArray[i] = (uint8_t)getTonicFromNote(noteArray[i]);
-            leds.setNoteLEDstate((note_t)tonicArray[i], ledStateBlink);
+            if (padNote[pad][i] == BLANK_NOTE)
+                continue;
+
+            note_t tonic = getTonicFromNote(padNote[pad][i]);
+
+            if (BIT_READ(padTonicMask[pad], tonic))
+                continue;
+
+            BIT_SET(padTonicMask[pad], tonic);
+            tonicRefCount[tonic]++;
+            leds.setNoteLEDstate(tonic, ledStateBlink);
         }
         break;
 
         case false:
         //note off
         //we need to set LEDs back to full states for released pad, but only if
-        //some other pad with same active note isn't already pressed
-        bool noteActive;
-
-        for (int z=0; z<noteCounter; z++)
+        //some other pad with same active tonic isn't already pressed
+        for (int i=0; i<MIDI_NOTES; i++)
         {
-            //iterate over every note on released pad
-            noteActive = false;
-
-            for (int i=0; i<NUMBER_OF_PADS; i++)
-            {
-                if (!isPadPressed(i))
-                    continue; //skip released pad
-                if (i == pad)
-                    continue; //skip current pad
-
-                for (int j=0; j<NOTES_PER_PAD; j++)
-                {
-                    if (getTonicFromNote(padNote[i][j]) == getTonicFromNote(noteArray[z]))
-                        noteActive = true;
-                }
-            }
+            if (!BIT_READ(padTonicMask[pad], i))
+                continue;
 
-            if (!noteActive)
-                leds.setNoteLEDstate(getTonicFromNote((note_t)noteArray[z]), ledStateOn);
+            if (!--tonicRefCount[i])
+                leds.setNoteLEDstate((note_t)i, ledStateOn);
         }
+
+        padTonicMask[pad] = 0;
         break;
     }
 }
@@ -1622,7 +1722,7 @@ changeResult_t Pads::setPitchBendState(bool state, padCoordinate_t coordinate)
     {
         case true:
         //local
-        if (database.read(DB_BLOCK_PROGRAM, programLocalSettingsSection, (LOCAL_PROGRAM_SETTINGS*(uint16_t)lastTouchedPad+configurationID)+(LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*(uint16_t)activeProgram)) != state)
+        if (database.read<DB_BLOCK_PROGRAM, programLocalSettingsSection>((LOCAL_PROGRAM_SETTINGS*(uint16_t)lastTouchedPad+configurationID)+(LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*(uint16_t)activeProgram)) != state)
         {
             database.update(DB_BLOCK_PROGRAM, programLocalSettingsSection, (LOCAL_PROGRAM_SETTINGS*(uint16_t)lastTouchedPad+configurationID)+(LOCAL_PROGRAM_SETTINGS*NUMBER_OF_PADS*(uint16_t)activeProgram), state);
             BIT_WRITE(*variablePointer, lastTouchedPad, state);
@@ -1638,7 +1738,7 @@ changeResult_t Pads::setPitchBendState(bool state, padCoordinate_t coordinate)
 
         case false:
         //global
-        if (database.read(DB_BLOCK_PROGRAM, programGlobalSettingsSection, configurationID+(GLOBAL_PROGRAM_SETTINGS*(uint16_t)activeProgram)) != state)
+        if (database.read<DB_BLOCK_PROGRAM, programGlobalSettingsSection>(configurationID+(GLOBAL_PROGRAM_SETTINGS*(uint16_t)activeProgram)) != state)
         {
             database.update(DB_BLOCK_PROGRAM, programGlobalSettingsSection, configurationID+(GLOBAL_PROGRAM_SETTINGS*(uint16_t)activeProgram), state);
             for (int i=0; i<NUMBER_OF_PADS; i++)
@@ -0,0 +1,270 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#pragma once
+
+#include <inttypes.h>
+#include "Config.h"
+#include "profiler/Profiler.h"
+
+///
+/// \ingroup interfacePads
+/// @{
+
+///
+/// \brief Stable pad pressure on press.
+/// Default velocity engine takes maximum of readings which follow first reading above press
+/// threshold during STABLE_SAMPLE_TIME_US. Window is timed so that it doesn't depend on how
+/// often pad is read. Slope engine uses first reading as starting point of pressure rise
+/// instead and predicts the same maximum from rise rate between readings. Estimate is
+/// considered stable once rise starts to decelerate (or pressure doesn't rise at all), after
+/// which remaining rise up to last reading of default engine is extrapolated assuming that
+/// each next rise shrinks by the same ratio and that readings keep coming at current rate.
+/// If rise is still accelerating on last reading, result is identical to default engine.
+/// @{
+
+///
+/// \brief Pressure sampling state for single pad.
+///
+typedef struct
+{
+    uint32_t start;     ///< Readout time of first reading in profiler timer ticks.
+    uint32_t last;      ///< Readout time of last reading in profiler timer ticks.
+    uint16_t peak;      ///< Highest reading after first one.
+    uint16_t value;     ///< Last reading.
+    int16_t rise;       ///< Rise between last two readings.
+    uint8_t count;      ///< Number of readings, including first one. 0 if sampling hasn't started.
+} velocitySamples_t;
+
+///
+/// \brief Starts pressure sampling.
+/// Reading with which sampling is started isn't included in default engine maximum.
+/// @param [in,out] samples     Sampling state.
+/// @param [in] value           Pressure reading.
+/// @param [in] ticks           Readout time of pressure reading in profiler timer ticks.
+///
+inline void velocitySampleStart(velocitySamples_t &samples, uint16_t value, uint32_t ticks)
+{
+    samples.start = ticks;
+    samples.last = ticks;
+    samples.peak = 0;
+    samples.value = value;
+    samples.rise = 0;
+    samples.count = 1;
+}
+
+///
+/// \brief Adds pressure reading to default engine maximum.
+/// Sampling is restarted from current reading once window has elapsed.
+/// @param [in,out] samples     Sampling state.
+/// @param [in] value           Pressure reading.
+/// @param [in] ticks           Readout time of pressure reading in profiler timer ticks.
+/// @param [out] maximum        Maximum reading. Valid only if function returns true.
+/// \returns True once STABLE_SAMPLE_TIME_US has elapsed since first reading, false otherwise.
+///
+inline bool velocityMaxUpdate(velocitySamples_t &samples, uint16_t value, uint32_t ticks, uint16_t &maximum)
+{
+    if (!samples.count)
+        velocitySampleStart(samples, 0, samples.last);
+
+    if (value > samples.peak)
+        samples.peak = value;
+
+    samples.value = value;
+    samples.last = ticks;
+
+    if ((ticks - samples.start) < (uint32_t)STABLE_SAMPLE_TIME_US*PROFILER_TICKS_PER_US)
+        return false;
+
+    maximum = samples.peak;
+    velocitySampleStart(samples, value, ticks);
+    return true;
+}
+
+///
+/// \brief Adds pressure reading to slope estimate.
+/// @param [in,out] samples     Sampling state. Restarted from current reading once estimate is stable.
+/// @param [in] value           Pressure reading.
+/// @param [in] ticks           Readout time of pressure reading in profiler timer ticks.
+/// @param [out] estimate       Estimated stable pressure. Valid only if function returns true.
+/// \returns True if estimate is stable, false otherwise.
+///
+inline bool velocitySlopeUpdate(velocitySamples_t &samples, uint16_t value, uint32_t ticks, uint16_t &estimate)
+{
+    if (!samples.count)
+    {
+        //starting point of pressure rise
+        velocitySampleStart(samples, value, ticks);
+        return false;
+    }
+
+    int16_t rise = value - samples.value;
+    uint16_t peak = (value > samples.peak) ? value : samples.peak;
+    uint32_t elapsed = ticks - samples.start;
+    uint32_t period = ticks - samples.last;
+    uint32_t window = (uint32_t)STABLE_SAMPLE_TIME_US*PROFILER_TICKS_PER_US;
+
+    bool stable = false;
+    //number of readings remaining up to last reading of default engine at current rate
+    uint32_t remaining = ((elapsed >= window) || !period) ? 0 : (window - elapsed + period - 1) / period;
+
+    estimate = peak;
+
+    if (!remaining || (rise <= 0))
+    {
+        //maximum is already known
+        stable = true;
+    }
+    else if (samples.count == 1)
+    {
+        if (rise <= VELOCITY_SLOPE_STABLE_RISE)
+        {
+            stable = true;
+            uint32_t predicted = value + (uint32_t)rise*remaining;
+            estimate = (predicted > 0xFFFF) ? 0xFFFF : predicted;
+        }
+    }
+    else if (rise <= samples.rise)
+    {
+        //steps shrink geometrically, keep fraction so that many small steps aren't truncated away
+        int32_t step = (int32_t)rise << 8;
+        uint32_t predicted = (uint32_t)value << 8;
+
+        for (uint32_t i=0; (i<remaining) && step; i++)
+        {
+            step = (step * rise) / samples.rise;
+            predicted += step;
+        }
+
+        predicted >>= 8;
+
+        //keep sampling while most of the estimate would still be extrapolated
+        if ((predicted - value) <= ((uint32_t)value >> 2))
+        {
+            stable = true;
+            estimate = (predicted > 0xFFFF) ? 0xFFFF : predicted;
+        }
+    }
+
+    if (stable)
+    {
+        velocitySampleStart(samples, value, ticks);
+        return true;
+    }
+
+    samples.peak = peak;
+    samples.value = value;
+    samples.rise = rise;
+    samples.last = ticks;
+
+    if (samples.count < 0xFF)
+        samples.count++;
+
+    return false;
+}
+
+/// @}
+
+///
+/// \brief Detection of pad release from pressure decay.
+/// Pressure of lifted pad falls steeply towards zero, while pressure of held pad changes
+/// slowly or stays at significant part of pressure pad has been pressed with. Both are
+/// checked on each reading so that release doesn't need to wait for pressure to reach
+/// zero. Largest drop between two readings during final decay is kept as release velocity.
+/// @{
+
+///
+/// \brief Release detection state for single pad.
+///
+typedef struct
+{
+    uint16_t peak;  ///< Highest pressure since press.
+    uint16_t last;  ///< Last pressure reading (lowest reading after release).
+    uint16_t drop;  ///< Largest drop between two readings since pressure last rose.
+} velocityRelease_t;
+
+///
+/// \brief Resets release detection once pad has been pressed.
+/// @param [in,out] state       Release detection state.
+/// @param [in] value           Pressure on press.
+///
+inline void velocityReleaseStart(velocityRelease_t &state, uint16_t value)
+{
+    state.peak = value;
+    state.last = value;
+    state.drop = 0;
+}
+
+///
+/// \brief Adds pressure reading of pressed pad to release detection.
+/// @param [in,out] state       Release detection state.
+/// @param [in] value           Pressure reading.
+/// \returns True if pressure decay indicates that pad has been lifted, false otherwise.
+///
+inline bool velocityReleaseUpdate(velocityRelease_t &state, uint16_t value)
+{
+    if (value > state.last)
+    {
+        //decay has ended
+        state.drop = 0;
+        state.last = value;
+
+        if (value > state.peak)
+            state.peak = value;
+
+        return false;
+    }
+
+    uint16_t drop = state.last - value;
+
+    if (drop > state.drop)
+        state.drop = drop;
+
+    state.last = value;
+
+    return ((uint32_t)value*FAST_RELEASE_LEVEL_RATIO < state.peak) && ((uint32_t)drop*FAST_RELEASE_SLOPE_RATIO >= state.peak);
+}
+
+///
+/// \brief Checks whether pad released by release detection can be pressed again.
+/// @param [in,out] state       Release detection state.
+/// @param [in] value           Pressure reading.
+/// \returns True once pressure has reached zero or once it has risen by
+///          FAST_RELEASE_REARM_PRESSURE from its lowest value after release.
+///
+inline bool velocityReleaseRearm(velocityRelease_t &state, uint16_t value)
+{
+    if (!value)
+        return true;
+
+    if (value < state.last)
+        state.last = value;
+
+    return (value > state.last + FAST_RELEASE_REARM_PRESSURE);
+}
+
+/// @}
+
+/// @}
@@ -59,6 +59,61 @@ void Curves::init()
         curveMin[i] = min_val;
         curveMax[i] = max_val;
     }
+
+    invalidateTables();
+}
+
+///
+/// \brief Releases all curve output tables.
+/// Needs to be called once curve or output range used on any pad changes so that tables
+/// for new configuration can be claimed.
+///
+void Curves::invalidateTables()
+{
+    for (int i=0; i<CURVE_TABLE_CACHE_SIZE; i++)
+        table[i].curve = NUMBER_OF_CURVES;
+
+    lastTable = 0;
+}
+
+///
+/// \brief Finds output table for specified curve and output range.
+/// If table doesn't exist, first free table is claimed.
+/// @param [in] curve   Wanted curve.
+/// @param [in] min     Lowest output value.
+/// @param [in] max     Largest output value.
+/// \returns Pointer to table or NULL if all tables are in use.
+///
+curveTable_t *Curves::getTable(curve_t curve, uint8_t min, uint8_t max)
+{
+    curveTable_t *tablePointer = &table[lastTable];
+
+    if ((tablePointer->curve == curve) && (tablePointer->min == min) && (tablePointer->max == max))
+        return tablePointer;
+
+    for (int i=0; i<CURVE_TABLE_CACHE_SIZE; i++)
+    {
+        tablePointer = &table[i];
+
+        if (tablePointer->curve == NUMBER_OF_CURVES)
+        {
+            //free table - claim it
+            tablePointer->curve = curve;
+            tablePointer->min = min;
+            tablePointer->max = max;
+
+            for (int j=0; j<CURVE_VALUES/8; j++)
+                tablePointer->filled[j] = 0;
+        }
+
+        if ((tablePointer->curve == curve) && (tablePointer->min == min) && (tablePointer->max == max))
+        {
+            lastTable = i;
+            return tablePointer;
+        }
+    }
+
+    return NULL;
 }
 
 ///
@@ -89,6 +144,8 @@ uint32_t Curves::invertRange(uint32_t value, uint32_t min, uint32_t max)
 
 ///
 /// \brief Returns value for wanted curve and curve index.
+/// When output range differs from full curve range, scaled values are stored in RAM table
+/// for curve and range so that each value is scaled only once.
 /// @param [in] curve   Wanted curve.
 /// @param [in] value   Wanted curve index.
 /// @param [in] min     Lowest possible output value.
@@ -100,10 +157,53 @@ uint8_t Curves::getCurveValue(curve_t curve, uint8_t value, uint8_t min, uint8_t
     uint8_t out_min = min < curveMin[curve] ? curveMin[curve] : min;
     uint8_t out_max = max > curveMax[curve] ? curveMax[curve] : max;
 
-    if (out_min || (out_max != 127))
-         return map(pgm_read_byte(&(curveArray[curve][value])), curveMin[curve], curveMax[curve], out_min, out_max);
-    else
+    if (!out_min && (out_max == 127))
         return pgm_read_byte(&(curveArray[curve][value]));
+
+    curveTable_t *tablePointer = getTable(curve, out_min, out_max);
+
+    if (tablePointer == NULL)
+        return map(pgm_read_byte(&(curveArray[curve][value])), curveMin[curve], curveMax[curve], out_min, out_max);
+
+    uint8_t mask = 1 << (value & 0x07);
+
+    if (!(tablePointer->filled[value >> 3] & mask))
+    {
+        tablePointer->value[value] = map(pgm_read_byte(&(curveArray[curve][value])), curveMin[curve], curveMax[curve], out_min, out_max);
+        tablePointer->filled[value >> 3] |= mask;
+    }
+
+    return tablePointer->value[value];
+}
+
+///
+/// \brief Returns 14-bit value for wanted curve and curve position.
+/// Value is linearly interpolated between two neighbouring curve values. Output range is
+/// applied in the same way as in getCurveValue, with 7-bit limits.
+/// @param [in] curve       Wanted curve.
+/// @param [in] position    Curve position (0-CURVE_POSITION_MAX), that is, curve index with
+///                         CURVE_FRACTION_BITS fraction bits.
+/// @param [in] min         Lowest possible output value (7-bit).
+/// @param [in] max         Largest possible output value (7-bit).
+/// \returns Curve value (0-16383).
+///
+uint16_t Curves::getCurveValue14b(curve_t curve, uint16_t position, uint8_t min, uint8_t max)
+{
+    uint8_t index = position >> CURVE_FRACTION_BITS;
+    uint8_t fraction = position & ((1 << CURVE_FRACTION_BITS) - 1);
+    int32_t value = (int32_t)pgm_read_byte(&(curveArray[curve][index])) << CURVE_FRACTION_BITS;
+
+    if (fraction && (index < (CURVE_VALUES-1)))
+        value += ((int16_t)pgm_read_byte(&(curveArray[curve][index+1])) - (int16_t)pgm_read_byte(&(curveArray[curve][index]))) * fraction;
+
+    uint8_t out_min = min < curveMin[curve] ? curveMin[curve] : min;
+    uint8_t out_max = max > curveMax[curve] ? curveMax[curve] : max;
+
+    if (out_min || (out_max != 127))
+        value = map(value, (int32_t)curveMin[curve] << CURVE_FRACTION_BITS, (int32_t)curveMax[curve] << CURVE_FRACTION_BITS, (int32_t)out_min << CURVE_FRACTION_BITS, (int32_t)out_max << CURVE_FRACTION_BITS);
+
+    //stretch 0-CURVE_POSITION_MAX to full 14-bit range
+    return value + (value >> CURVE_FRACTION_BITS);
 }
 
 Curves curves;
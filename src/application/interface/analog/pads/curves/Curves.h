@@ -38,12 +38,28 @@ class Curves
     Curves();
     void init();
     uint8_t getCurveValue(curve_t type, uint8_t value, uint8_t min, uint8_t max);
+    uint16_t getCurveValue14b(curve_t curve, uint16_t position, uint8_t min, uint8_t max);
     int32_t map(int32_t x, int32_t in_min, int32_t in_max, int32_t out_min, int32_t out_max);
     uint32_t invertRange(uint32_t value, uint32_t min, uint32_t max);
+    void invalidateTables();
 
     private:
+    curveTable_t *getTable(curve_t curve, uint8_t min, uint8_t max);
+
     uint8_t curveMin[NUMBER_OF_CURVES];
     uint8_t curveMax[NUMBER_OF_CURVES];
+
+    ///
+    /// \brief Curve output tables for currently used curves and output ranges.
+    /// Table is claimed on first use of curve/range combination and released only
+    /// once curve configuration changes (see invalidateTables).
+    ///
+    curveTable_t table[CURVE_TABLE_CACHE_SIZE];
+
+    ///
+    /// \brief Index of last used table, checked first on next lookup.
+    ///
+    uint8_t lastTable;
 };
 
 extern Curves curves;
@@ -25,6 +25,8 @@
 
 #pragma once
 
+#include <inttypes.h>
+
 ///
 /// \brief List of all possible curves.
 ///
@@ -45,3 +47,38 @@ typedef enum
     curve_eight_waves_up_down,
     NUMBER_OF_CURVES
 } curve_t;
+
+///
+/// \brief Number of curve output tables held in RAM.
+/// Covers velocity curve and X/Y curves with non-default limits for all pads when split is off.
+///
+#define CURVE_TABLE_CACHE_SIZE  4
+
+///
+/// \brief Number of values in single curve.
+///
+#define CURVE_VALUES            128
+
+///
+/// \brief Number of fraction bits in curve position used for high-resolution curve values.
+/// Position range covers CURVE_VALUES-1 segments between neighbouring curve values.
+/// @{
+
+#define CURVE_FRACTION_BITS     7
+#define CURVE_POSITION_MAX      ((CURVE_VALUES-1) << CURVE_FRACTION_BITS)
+
+/// @}
+
+///
+/// \brief Curve output table materialized in RAM for specific curve and output range.
+/// Values are calculated lazily on first access, filled holds one bit per value.
+///
+typedef struct
+{
+    uint8_t curve;
+    uint8_t min;
+    uint8_t max;
+    uint8_t filled[CURVE_VALUES/8];
+    uint8_t value[CURVE_VALUES];
+} curveTable_t;
+
@@ -111,7 +111,7 @@ void Buttons::init()
     initHandlers_buttons();
     uint32_t currentTime = rTimeMs();
     processingEnabled = false;
-    transportControlMode = (transportControlMode_t)database.read(DB_BLOCK_GLOBAL_SETTINGS, globalSettingsMIDI, MIDI_SETTING_TRANSPORT_CC_ID);
+    transportControlMode = (transportControlMode_t)database.read<DB_BLOCK_GLOBAL_SETTINGS, globalSettingsMIDI>(MIDI_SETTING_TRANSPORT_CC_ID);
 
     //read buttons for 0.1 seconds
     do
@@ -63,6 +63,7 @@ class Display
     void displayMIDIchannel(uint8_t channel = 255);
     void clearPadPressData();
     void displayDeviceInfo();
+    void displayMemoryWrites(uint32_t programWrites, uint32_t scaleWrites, uint32_t slotWrites, uint32_t movedWrites);
 
     void displayChangeResult(function_t function, int16_t value, settingType_t type);
     void displayError(function_t function, changeResult_t result);
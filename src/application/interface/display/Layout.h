@@ -112,6 +112,12 @@
 #define DISPLAY_ROW_MENU_DEVICE_INFO_2                      2
 #define DISPLAY_POSITION_MENU_DEVICE_INFO_2                 0
 
+#define DISPLAY_ROW_MENU_MEMORY_WRITES_1                    1
+#define DISPLAY_POSITION_MENU_MEMORY_WRITES_1               0
+
+#define DISPLAY_ROW_MENU_MEMORY_WRITES_2                    2
+#define DISPLAY_POSITION_MENU_MEMORY_WRITES_2               0
+
 #define DISPLAY_ROW_FACTORY_RESET_TITLE                     0
 #define DISPLAY_ROW_FACTORY_RESET_INFO_CONFIRM              1
 #define DISPLAY_ROW_FACTORY_RESET_PADS                      2
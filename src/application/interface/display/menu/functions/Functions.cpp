@@ -147,6 +147,23 @@ bool deviceInfo(uint8_t argument)
     return true;
 }
 
+///
+/// \brief Used to display number of memory writes of high-churn settings since startup.
+/// @param [in] argument    Function argument defined in menu layout.
+/// \returns                True on success, false otherwise.
+///
+bool memoryWrites(uint8_t argument)
+{
+    uint32_t slotWrites, movedWrites;
+
+    database.getLogStats(slotWrites, movedWrites);
+
+    display.displayMemoryWrites(database.getWriteCount(DB_BLOCK_PROGRAM, programLastActiveProgramSection),
+        database.getWriteCount(DB_BLOCK_PROGRAM, programLastActiveScaleSection), slotWrites, movedWrites);
+
+    return true;
+}
+
 ///
 /// \brief Used to initiate setting up of calibration mode.
 /// @param [in] argument    Function argument defined in menu layout.
@@ -271,7 +288,7 @@ bool checkNoteOffStatus(uint8_t argument)
         return true;
 
         case false:
-        return (database.read(DB_BLOCK_GLOBAL_SETTINGS, globalSettingsMIDI, MIDI_SETTING_NOTE_OFF_TYPE_ID) == (noteOffType_t)argument);
+        return (database.read<DB_BLOCK_GLOBAL_SETTINGS, globalSettingsMIDI>(MIDI_SETTING_NOTE_OFF_TYPE_ID) == (noteOffType_t)argument);
     }
 
     return false;
@@ -433,3 +450,120 @@ bool checkPressureCurve(uint8_t argument)
 
     return false;
 }
+
+///
+/// \brief Used to either check or change velocity engine.
+/// When itemFuncChangeVal is set to false, velocity engine
+/// is compared to function argument.
+/// When itemFuncChangeVal is set to true, velocity engine is
+/// changed to function argument value.
+/// @param [in] argument    Function argument defined in menu layout.
+/// \returns                True on success, false otherwise.
+///
+bool checkVelocityEngine(uint8_t argument)
+{
+    switch((velocityEngine_t)argument)
+    {
+        case velocityEngineMax:
+        case velocityEngineSlope:
+        //ok
+        break;
+
+        default:
+        //invalid argument
+        return false;
+    }
+
+    switch(itemFuncChangeVal)
+    {
+        case true:
+        //engine can't be switched while pads are pressed
+        return (pads.setVelocityEngine((velocityEngine_t)argument) != releasePads);
+
+        case false:
+        return (pads.getVelocityEngine() == (velocityEngine_t)argument);
+    }
+
+    return false;
+}
+
+///
+/// \brief Used to either check or change X/Y resolution.
+/// When itemFuncChangeVal is set to false, X/Y resolution
+/// is compared to function argument.
+/// When itemFuncChangeVal is set to true, X/Y resolution is
+/// changed to function argument value.
+/// @param [in] argument    Function argument defined in menu layout.
+/// \returns                True on success, false otherwise.
+///
+bool checkXYresolution(uint8_t argument)
+{
+    switch((xyResolution_t)argument)
+    {
+        case xyResolution7bit:
+        case xyResolution14bit:
+        //ok
+        break;
+
+        default:
+        //invalid argument
+        return false;
+    }
+
+    switch(itemFuncChangeVal)
+    {
+        case true:
+        return (pads.setXYresolution((xyResolution_t)argument) != releasePads);
+
+        case false:
+        return (pads.getXYresolution() == (xyResolution_t)argument);
+    }
+
+    return false;
+}
+
+///
+/// \brief Used to either check or change X/Y smoothing (filter cutoff).
+/// When itemFuncChangeVal is set to false, filter cutoff
+/// is compared to function argument.
+/// When itemFuncChangeVal is set to true, filter cutoff is
+/// changed to function argument value.
+/// @param [in] argument    Function argument defined in menu layout.
+/// \returns                True on success, false otherwise.
+///
+bool checkXYsmoothing(uint8_t argument)
+{
+    switch(itemFuncChangeVal)
+    {
+        case true:
+        return (pads.setXYfilter(xyFilterCutoff, argument) != outOfRange);
+
+        case false:
+        return (pads.getXYfilter(xyFilterCutoff) == argument);
+    }
+
+    return false;
+}
+
+///
+/// \brief Used to either check or change X/Y response (filter speed coefficient).
+/// When itemFuncChangeVal is set to false, filter speed coefficient
+/// is compared to function argument.
+/// When itemFuncChangeVal is set to true, filter speed coefficient is
+/// changed to function argument value.
+/// @param [in] argument    Function argument defined in menu layout.
+/// \returns                True on success, false otherwise.
+///
+bool checkXYresponse(uint8_t argument)
+{
+    switch(itemFuncChangeVal)
+    {
+        case true:
+        return (pads.setXYfilter(xyFilterBeta, argument) != outOfRange);
+
+        case false:
+        return (pads.getXYfilter(xyFilterBeta) == argument);
+    }
+
+    return false;
+}
@@ -34,6 +34,7 @@
 
 bool factoryReset(uint8_t argument);
 bool deviceInfo(uint8_t argument);
+bool memoryWrites(uint8_t argument);
 bool enableCalibration(uint8_t argument);
 bool checkRunningStatus(uint8_t argument);
 bool checkTransportCC(uint8_t argument);
@@ -42,5 +43,9 @@ bool checkVelocitySensitivity(uint8_t argument);
 bool checkPressureCurve(uint8_t argument);
 bool checkAftertouchType(uint8_t argument);
 bool checkNoteOffStatus(uint8_t argument);
+bool checkVelocityEngine(uint8_t argument);
+bool checkXYresolution(uint8_t argument);
+bool checkXYsmoothing(uint8_t argument);
+bool checkXYresponse(uint8_t argument);
 
 /// @}
@@ -24,6 +24,8 @@
 */
 
 #include "dbms/src/DataTypes.h"
+#include "../../../../database/blocks/Program.h"
+#include "../../../analog/pads/DataTypes.h"
 #include "../functions/Functions.h"
 #include "items/ServiceMenu.h"
 #include "items/UserMenu.h"
@@ -110,6 +112,30 @@ static menuItem_t userMenuLayout[USER_MENU_ITEMS] =
         .checkable = true,
     },
 
+    {
+        .stringPointer = menuOption_velocityEngine_string,
+        .level = 13,
+        .function = NULL,
+        .argument = 0,
+        .checkable = false,
+    },
+
+    {
+        .stringPointer = velocityEngine_max_string,
+        .level = 131,
+        .function = checkVelocityEngine,
+        .argument = (uint8_t)velocityEngineMax,
+        .checkable = true,
+    },
+
+    {
+        .stringPointer = velocityEngine_slope_string,
+        .level = 132,
+        .function = checkVelocityEngine,
+        .argument = (uint8_t)velocityEngineSlope,
+        .checkable = true,
+    },
+
     {
         .stringPointer = menuOption_midiSettings_string,
         .level = 2,
@@ -247,8 +273,104 @@ static menuItem_t userMenuLayout[USER_MENU_ITEMS] =
     },
 
     {
-        .stringPointer = menuOption_deviceInfo_string,
+        .stringPointer = menuOption_xySettings_string,
         .level = 3,
+        .function = NULL,
+        .argument = 0,
+        .checkable = false,
+    },
+
+    {
+        .stringPointer = xySettings_resolution_string,
+        .level = 31,
+        .function = NULL,
+        .argument = 0,
+        .checkable = false,
+    },
+
+    {
+        .stringPointer = xyResolution_7bit_string,
+        .level = 311,
+        .function = checkXYresolution,
+        .argument = (uint8_t)xyResolution7bit,
+        .checkable = true,
+    },
+
+    {
+        .stringPointer = xyResolution_14bit_string,
+        .level = 312,
+        .function = checkXYresolution,
+        .argument = (uint8_t)xyResolution14bit,
+        .checkable = true,
+    },
+
+    {
+        .stringPointer = xySettings_smoothing_string,
+        .level = 32,
+        .function = NULL,
+        .argument = 0,
+        .checkable = false,
+    },
+
+    {
+        .stringPointer = xyFilter_low_string,
+        .level = 321,
+        .function = checkXYsmoothing,
+        .argument = EXTENDED_PROGRAM_SETTING_XY_FILTER_CUTOFF*2,
+        .checkable = true,
+    },
+
+    {
+        .stringPointer = xyFilter_medium_string,
+        .level = 322,
+        .function = checkXYsmoothing,
+        .argument = EXTENDED_PROGRAM_SETTING_XY_FILTER_CUTOFF,
+        .checkable = true,
+    },
+
+    {
+        .stringPointer = xyFilter_high_string,
+        .level = 323,
+        .function = checkXYsmoothing,
+        .argument = EXTENDED_PROGRAM_SETTING_XY_FILTER_CUTOFF/2,
+        .checkable = true,
+    },
+
+    {
+        .stringPointer = xySettings_response_string,
+        .level = 33,
+        .function = NULL,
+        .argument = 0,
+        .checkable = false,
+    },
+
+    {
+        .stringPointer = xyFilter_slow_string,
+        .level = 331,
+        .function = checkXYresponse,
+        .argument = EXTENDED_PROGRAM_SETTING_XY_FILTER_BETA/2,
+        .checkable = true,
+    },
+
+    {
+        .stringPointer = xyFilter_medium_string,
+        .level = 332,
+        .function = checkXYresponse,
+        .argument = EXTENDED_PROGRAM_SETTING_XY_FILTER_BETA,
+        .checkable = true,
+    },
+
+    {
+        .stringPointer = xyFilter_fast_string,
+        .level = 333,
+        .function = checkXYresponse,
+        .argument = EXTENDED_PROGRAM_SETTING_XY_FILTER_BETA*2,
+        .checkable = true,
+    },
+
+    {
+        .stringPointer = menuOption_deviceInfo_string,
+        .level = 4,
         .function = deviceInfo,
         .argument = 0,
         .checkable = false,
@@ -256,7 +378,7 @@ static menuItem_t userMenuLayout[USER_MENU_ITEMS] =
 
     {
         .stringPointer = menuOption_factoryReset_string,
-        .level = 4,
+        .level = 5,
         .function = factoryReset,
         .argument = (uint8_t)initPartial,
         .checkable = false,
@@ -266,7 +388,7 @@ static menuItem_t userMenuLayout[USER_MENU_ITEMS] =
 ///
 /// \brief Service menu layout.
 ///
-static menuItem_t serviceMenuLayout[USER_MENU_ITEMS] =
+static menuItem_t serviceMenuLayout[SERVICE_MENU_ITEMS] =
 {
     {
         .stringPointer = menuOption_padCalibration_string,
@@ -309,8 +431,16 @@ static menuItem_t serviceMenuLayout[USER_MENU_ITEMS] =
     },
 
     {
-        .stringPointer = menuOption_factoryReset_string,
+        .stringPointer = menuOption_memoryWrites_string,
         .level = 3,
+        .function = memoryWrites,
+        .argument = 0,
+        .checkable = false,
+    },
+
+    {
+        .stringPointer = menuOption_factoryReset_string,
+        .level = 4,
         .function = factoryReset,
         .argument = (uint8_t)initFull,
         .checkable = false,
@@ -35,6 +35,7 @@ typedef enum
 {
     serviceMenuItem_calibration,
     serviceMenuItem_deviceInfo,
+    serviceMenuItem_memoryWrites,
     serviceMenuItem_factoryReset,
 
     serviceMenuItem_calibrateX,
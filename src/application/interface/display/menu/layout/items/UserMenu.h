@@ -36,7 +36,9 @@ typedef enum
     userMenuItem_pressureSettings,
     userMenuItem_pressureSensitivity,
     userMenuItem_pressureCurve,
+    userMenuItem_velocityEngine,
     userMenuItem_midiSettings,
+    userMenuItem_xySettings,
     userMenuItem_deviceInfo,
     userMenuItem_factoryReset,
 
@@ -48,6 +50,9 @@ typedef enum
     userMenuItem_pressureCurve_log,
     userMenuItem_pressureCurve_exp,
 
+    userMenuItem_velocityEngine_max,
+    userMenuItem_velocityEngine_slope,
+
     userMenuItem_midiSettings_aftertouchType,
     userMenuItem_midiSettings_runningStatus,
     userMenuItem_midiSettings_noteOff,
@@ -70,6 +75,21 @@ typedef enum
     userMenuItem_midiSettings_pitchBend_1,
     userMenuItem_midiSettings_pitchBend_2,
 
+    userMenuItem_xySettings_resolution,
+    userMenuItem_xySettings_smoothing,
+    userMenuItem_xySettings_response,
+
+    userMenuItem_xySettings_resolution_7bit,
+    userMenuItem_xySettings_resolution_14bit,
+
+    userMenuItem_xySettings_smoothing_low,
+    userMenuItem_xySettings_smoothing_medium,
+    userMenuItem_xySettings_smoothing_high,
+
+    userMenuItem_xySettings_response_slow,
+    userMenuItem_xySettings_response_medium,
+    userMenuItem_xySettings_response_fast,
+
     USER_MENU_ITEMS
 } userMenuItems_t;
 
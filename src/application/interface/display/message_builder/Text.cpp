@@ -631,6 +631,34 @@ void Display::displayDeviceInfo()
     updateText(DISPLAY_ROW_MENU_DEVICE_INFO_2, displayText_still, DISPLAY_POSITION_MENU_DEVICE_INFO_2);
 }
 
+///
+/// \brief Displays number of memory writes of high-churn settings since startup.
+/// @param [in] programWrites   Number of program changes written.
+/// @param [in] scaleWrites     Number of scale changes written.
+/// @param [in] slotWrites      Number of log slots written.
+/// @param [in] movedWrites     Number of values moved from log to their own address.
+///
+void Display::displayMemoryWrites(uint32_t programWrites, uint32_t scaleWrites, uint32_t slotWrites, uint32_t movedWrites)
+{
+    stringBuffer.startLine();
+    stringBuffer.appendText_P(memoryWrites_program_string);
+    stringBuffer.appendInt(programWrites);
+    stringBuffer.appendText_P(memoryWrites_scale_string);
+    stringBuffer.appendInt(scaleWrites);
+    stringBuffer.endLine();
+
+    updateText(DISPLAY_ROW_MENU_MEMORY_WRITES_1, displayText_still, DISPLAY_POSITION_MENU_MEMORY_WRITES_1);
+
+    stringBuffer.startLine();
+    stringBuffer.appendText_P(memoryWrites_log_string);
+    stringBuffer.appendInt(slotWrites);
+    stringBuffer.appendText_P(memoryWrites_moved_string);
+    stringBuffer.appendInt(movedWrites);
+    stringBuffer.endLine();
+
+    updateText(DISPLAY_ROW_MENU_MEMORY_WRITES_2, displayText_still, DISPLAY_POSITION_MENU_MEMORY_WRITES_2);
+}
+
 ///
 /// \brief Displays confirmation screen before performing factory reset.
 ///
@@ -38,12 +38,15 @@ const char menuType_service_string[] PROGMEM = "Service menu";
 
 const char menuOption_padCalibration_string[] PROGMEM = "Pad calibration";
 const char menuOption_deviceInfo_string[] PROGMEM = "Device info";
+const char menuOption_memoryWrites_string[] PROGMEM = "Memory writes";
 const char menuOption_factoryReset_string[] PROGMEM = "Factory reset";
 const char menuOption_factoryReset_title_string[] PROGMEM = "***FACTORY RESET***";
 const char menuOption_velocitySettings_string[] PROGMEM = "Velocity settings";
 const char menuOption_pressureSensitivity_string[] PROGMEM = "Sensitivity";
 const char menuOption_pressureCurve_string[] PROGMEM = "Curve";
+const char menuOption_velocityEngine_string[] PROGMEM = "Engine";
 const char menuOption_midiSettings_string[] PROGMEM = "MIDI settings";
+const char menuOption_xySettings_string[] PROGMEM = "X/Y settings";
 
 //calibration menu options
 const char calibration_x_string[] PROGMEM = "Calibrate X";
@@ -62,6 +65,12 @@ const char calibrationMode_manual_string[] PROGMEM = "Manual";
 const char deviceInfo_swVersion_string[] PROGMEM = "Software: ";
 const char deviceInfo_hwVersion_string[] PROGMEM = "Hardware: ";
 
+//memory writes
+const char memoryWrites_program_string[] PROGMEM = "Program: ";
+const char memoryWrites_scale_string[] PROGMEM = ", scale: ";
+const char memoryWrites_log_string[] PROGMEM = "Log: ";
+const char memoryWrites_moved_string[] PROGMEM = ", moved: ";
+
 //factory reset options
 const char factoryReset_partial_string[] PROGMEM = "Partial reset";
 const char factoryReset_full_string[] PROGMEM = "Full reset";
@@ -77,6 +86,22 @@ const char pressure_curve_linear_string[] PROGMEM = "Linear";
 const char pressure_curve_log_string[] PROGMEM = "Logarithmic";
 const char pressure_curve_inv_exp_string[] PROGMEM = "Exponential";
 
+const char velocityEngine_max_string[] PROGMEM = "Standard";
+const char velocityEngine_slope_string[] PROGMEM = "Slope";
+
+const char xySettings_resolution_string[] PROGMEM = "Resolution";
+const char xySettings_smoothing_string[] PROGMEM = "Smoothing";
+const char xySettings_response_string[] PROGMEM = "Response";
+
+const char xyResolution_7bit_string[] PROGMEM = "7-bit";
+const char xyResolution_14bit_string[] PROGMEM = "14-bit";
+
+const char xyFilter_low_string[] PROGMEM = "Low";
+const char xyFilter_medium_string[] PROGMEM = "Medium";
+const char xyFilter_high_string[] PROGMEM = "High";
+const char xyFilter_slow_string[] PROGMEM = "Slow";
+const char xyFilter_fast_string[] PROGMEM = "Fast";
+
 const char midiSettings_midiChannel_string[] PROGMEM = "Channel";
 const char midiSettings_atouchType_string[] PROGMEM = "Aftertouch type";
 const char midiSettings_runningStatus_string[] PROGMEM = "Running status";
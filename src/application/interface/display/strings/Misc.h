@@ -37,6 +37,7 @@ const char deviceName_string[] PROGMEM = "Zvuk Machines Zvuk9";
 const char welcome_string[] PROGMEM = "Welcome!";
 const char firmware_updated[] PROGMEM = "Firmware updated!";
 const char dbInit_string[] PROGMEM = "First time initialization.";
+const char dbMigration_string[] PROGMEM = "Updating memory layout.";
 const char restoringDefaults_string[] PROGMEM = "Restoring defaults.";
 const char pleaseWait_string[] PROGMEM = "Please wait...";
 const char complete_string[] PROGMEM = "Complete!";
@@ -0,0 +1,236 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#include "Coalescer.h"
+#include "board/Board.h"
+#include "core/src/general/BitManipulation.h"
+#include "core/src/general/Timing.h"
+
+///
+/// \ingroup interfaceMIDI
+/// @{
+
+///
+/// \brief Default constructor.
+///
+Coalescer::Coalescer()
+{
+    init();
+}
+
+///
+/// \brief Discards all pending values.
+///
+void Coalescer::init()
+{
+    slotCount = 0;
+    pitchBendPending = 0;
+    channelAftertouchPending = 0;
+    lastDrainTime = 0;
+}
+
+///
+/// \brief Sends or stores CC value.
+///
+void Coalescer::sendControlChange(uint8_t cc, uint8_t value, uint8_t channel)
+{
+    store(midiMessageControlChange, channel, cc, value);
+}
+
+///
+/// \brief Sends or stores key aftertouch value.
+///
+void Coalescer::sendAfterTouch(uint8_t note, uint8_t value, uint8_t channel)
+{
+    store(midiMessageAfterTouch, channel, note, value);
+}
+
+///
+/// \brief Sends or stores pitch bend value.
+///
+void Coalescer::sendPitchBend(uint16_t value, uint8_t channel)
+{
+    uint8_t index = channel - 1;
+
+    if (!COALESCER_INTERVAL && !BIT_READ(pitchBendPending, index) && Board::getMIDIcapacity(midiMessagePitchBend))
+    {
+        midi.sendPitchBend(value, channel);
+        return;
+    }
+
+    pitchBendValue[index] = value;
+    BIT_SET(pitchBendPending, index);
+}
+
+///
+/// \brief Sends or stores channel aftertouch value.
+///
+void Coalescer::sendAfterTouch(uint8_t value, uint8_t channel)
+{
+    uint8_t index = channel - 1;
+
+    if (!COALESCER_INTERVAL && !BIT_READ(channelAftertouchPending, index) && Board::getMIDIcapacity(midiMessageAfterTouchChannel))
+    {
+        midi.sendAfterTouch(value, channel);
+        return;
+    }
+
+    channelAftertouchValue[index] = value;
+    BIT_SET(channelAftertouchPending, index);
+}
+
+///
+/// \brief Sends all pending values regardless of transport capacity.
+/// Needs to be called before sending any other message so that pending values
+/// aren't sent after messages which have been generated later.
+///
+void Coalescer::flush()
+{
+    drain(true);
+}
+
+///
+/// \brief Sends pending values for which transport has capacity once COALESCER_INTERVAL has passed.
+/// Called from main loop.
+///
+void Coalescer::update()
+{
+    if (!slotCount && !pitchBendPending && !channelAftertouchPending)
+        return;
+
+    if ((rTimeMs() - lastDrainTime) < COALESCER_INTERVAL)
+        return;
+
+    drain(false);
+    lastDrainTime = rTimeMs();
+}
+
+///
+/// \brief Stores CC or key aftertouch value into its slot.
+/// Value is sent right away if nothing is pending and transport has capacity. Updated
+/// slot is moved behind all other pending slots so that slots are sent in order of their
+/// last update, which keeps order of values written in sequence (ie. 14-bit CC MSB and LSB).
+/// If all slots are in use, pending values are flushed first.
+///
+void Coalescer::store(midiMessageType_t type, uint8_t channel, uint8_t data1, uint8_t value)
+{
+    coalescerSlot_t newSlot = { (uint8_t)type, channel, data1, value };
+
+    if (!COALESCER_INTERVAL && !slotCount && Board::getMIDIcapacity(type))
+    {
+        send(newSlot);
+        return;
+    }
+
+    uint8_t index;
+
+    for (index=0; index<slotCount; index++)
+    {
+        if ((slot[index].type == type) && (slot[index].channel == channel) && (slot[index].data1 == data1))
+            break;
+    }
+
+    if (index == slotCount)
+    {
+        if (slotCount == COALESCER_SLOTS)
+        {
+            flush();
+            index = 0;
+        }
+
+        slotCount++;
+    }
+
+    for (; index<slotCount-1; index++)
+        slot[index] = slot[index+1];
+
+    slot[index] = newSlot;
+}
+
+///
+/// \brief Sends single pending CC or key aftertouch value.
+///
+void Coalescer::send(const coalescerSlot_t &slot)
+{
+    if (slot.type == midiMessageControlChange)
+        midi.sendControlChange(slot.data1, slot.value, slot.channel);
+    else
+        midi.sendAfterTouch(slot.data1, slot.value, slot.channel);
+}
+
+///
+/// \brief Sends pending values.
+/// @param [in] all     If set to true, all pending values are sent. Otherwise, only
+///                     values for which transport has capacity are sent.
+///
+void Coalescer::drain(bool all)
+{
+    uint8_t capacity = all ? 0xFF : Board::getMIDIcapacity(midiMessagePitchBend);
+
+    for (int i=0; (i<COALESCER_CHANNELS) && pitchBendPending && capacity; i++)
+    {
+        if (!BIT_READ(pitchBendPending, i))
+            continue;
+
+        midi.sendPitchBend(pitchBendValue[i], i+1);
+        BIT_CLEAR(pitchBendPending, i);
+
+        if (!all)
+            capacity--;
+    }
+
+    capacity = all ? 0xFF : Board::getMIDIcapacity(midiMessageControlChange);
+
+    for (int i=0; (i<COALESCER_CHANNELS) && channelAftertouchPending && capacity; i++)
+    {
+        if (!BIT_READ(channelAftertouchPending, i))
+            continue;
+
+        midi.sendAfterTouch(channelAftertouchValue[i], i+1);
+        BIT_CLEAR(channelAftertouchPending, i);
+
+        if (!all)
+            capacity--;
+    }
+
+    uint8_t sent = 0;
+
+    while ((sent < slotCount) && capacity)
+    {
+        send(slot[sent++]);
+
+        if (!all)
+            capacity--;
+    }
+
+    for (int i=sent; i<slotCount; i++)
+        slot[i-sent] = slot[i];
+
+    slotCount -= sent;
+}
+
+/// @}
+
+Coalescer coalescer;
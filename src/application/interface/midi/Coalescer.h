@@ -0,0 +1,107 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#pragma once
+
+#include <inttypes.h>
+
+///
+/// \brief Last-value-wins output stage for continuous MIDI messages.
+/// Control change, pitch bend and aftertouch messages are stored into pending slots instead
+/// of being sent right away: single slot per channel and CC number, per channel and note for
+/// key aftertouch and per channel for pitch bend and channel aftertouch. Newer value replaces
+/// pending one, so stale intermediate values are never sent. Pending values are sent once
+/// transport has capacity for them (see Board::getMIDIcapacity), but not more often than
+/// once in COALESCER_INTERVAL. Other messages are sent directly, after flushing pending values.
+/// Aftertouch has no capacity of its own: both key and channel aftertouch share UART
+/// controller lane with CC messages, so they are limited by the same capacity. Pending
+/// channel aftertouch values are sent first, followed by CC and key aftertouch slots in order
+/// of their last update, so aftertouch and CC messages get the capacity in proportion to how
+/// often they change.
+/// \defgroup interfaceMIDI MIDI output
+/// \ingroup interface
+/// @{
+
+///
+/// \brief Number of pending CC and key aftertouch slots.
+///
+#define COALESCER_SLOTS             48
+
+///
+/// \brief Time in milliseconds between sending of pending values.
+/// Interval is fixed at compile time. With zero interval, values are sent as soon as
+/// transport has capacity. Interval matches USB_MIDI_FLUSH_TIMEOUT so that values updated
+/// several times within one USB MIDI batch are sent once, together with other pending values.
+///
+#define COALESCER_INTERVAL          1
+
+///
+/// \brief Number of MIDI channels.
+///
+#define COALESCER_CHANNELS          16
+
+///
+/// \brief Pending CC or key aftertouch value.
+///
+typedef struct
+{
+    uint8_t type;
+    uint8_t channel;
+    uint8_t data1;
+    uint8_t value;
+} coalescerSlot_t;
+
+class Coalescer
+{
+    public:
+    Coalescer();
+    void init();
+    void sendControlChange(uint8_t cc, uint8_t value, uint8_t channel);
+    void sendPitchBend(uint16_t value, uint8_t channel);
+    void sendAfterTouch(uint8_t note, uint8_t value, uint8_t channel);
+    void sendAfterTouch(uint8_t value, uint8_t channel);
+    void flush();
+    void update();
+
+    private:
+    void store(midiMessageType_t type, uint8_t channel, uint8_t data1, uint8_t value);
+    void send(const coalescerSlot_t &slot);
+    void drain(bool all);
+
+    coalescerSlot_t slot[COALESCER_SLOTS];
+    uint8_t         slotCount;
+    uint16_t        pitchBendValue[COALESCER_CHANNELS];
+    uint16_t        pitchBendPending;
+    uint8_t         channelAftertouchValue[COALESCER_CHANNELS];
+    uint16_t        channelAftertouchPending;
+    uint32_t        lastDrainTime;
+};
+
+///
+/// \brief External definition of Coalescer class instance.
+///
+extern Coalescer coalescer;
+
+/// @}
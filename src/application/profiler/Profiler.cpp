@@ -0,0 +1,256 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#include <string.h>
+#include <util/atomic.h>
+#include "Profiler.h"
+#include "board/Board.h"
+#include "database/Database.h"
+#include "core/src/general/Timing.h"
+
+///
+/// \ingroup profiler
+/// @{
+
+volatile profilerStageData_t    profilerISRdata[PROFILER_STAGES-profilerStageISR_ADC];
+volatile uint32_t               profilerISRticks;
+
+#ifdef DEBUG
+///
+/// \brief Stage names used when printing profiler results.
+///
+static const char * const stageName[PROFILER_STAGES] =
+{
+    "pads",
+    "digital in",
+    "display",
+    "leds",
+    "adc isr",
+    "timer isr"
+};
+#endif
+
+///
+/// \brief Default constructor.
+///
+Profiler::Profiler()
+{
+
+}
+
+///
+/// \brief Resets all counters.
+/// Called once board is initialized since profiler timer must be running.
+///
+void Profiler::init()
+{
+    reset();
+}
+
+///
+/// \brief Clears all counters and starts new measurement window.
+///
+void Profiler::reset()
+{
+    memset(loopData, 0, sizeof(loopData));
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        for (int i=0; i<PROFILER_STAGES-profilerStageISR_ADC; i++)
+        {
+            profilerISRdata[i].ticks = 0;
+            profilerISRdata[i].calls = 0;
+            profilerISRdata[i].maxTicks = 0;
+        }
+    }
+
+    windowStartTicks = board.getProfilerTicks();
+    lastPrintTime = rTimeMs();
+}
+
+///
+/// \brief Marks start of main loop stage.
+///
+void Profiler::begin()
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        stageStartISRticks = profilerISRticks;
+    }
+
+    stageStartTicks = board.getProfilerTicks();
+}
+
+///
+/// \brief Marks end of main loop stage and accumulates its time.
+/// Time spent in ISRs while stage has been running isn't accounted to stage.
+/// @param [in] stage   Stage which has been running since last call to begin().
+///
+void Profiler::end(profilerStage_t stage)
+{
+    uint32_t ticks = board.getProfilerTicks() - stageStartTicks;
+    uint32_t isrTicks;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        isrTicks = profilerISRticks - stageStartISRticks;
+    }
+
+    ticks = (ticks > isrTicks) ? ticks - isrTicks : 0;
+
+    loopData[stage].ticks += ticks;
+    loopData[stage].calls++;
+
+    if (ticks > loopData[stage].maxTicks)
+        loopData[stage].maxTicks = ticks;
+}
+
+///
+/// \brief Returns accumulated measurements for requested stage.
+/// @param [in] stage       Stage for which data is being read.
+/// @param [in,out] data    Structure in which measurements are stored.
+///
+void Profiler::getStageData(profilerStage_t stage, profilerStageData_t &data)
+{
+    if (stage < profilerStageISR_ADC)
+    {
+        data = loopData[stage];
+        return;
+    }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        data.ticks = profilerISRdata[stage-profilerStageISR_ADC].ticks;
+        data.calls = profilerISRdata[stage-profilerStageISR_ADC].calls;
+        data.maxTicks = profilerISRdata[stage-profilerStageISR_ADC].maxTicks;
+    }
+}
+
+///
+/// \brief Handles profiler SysEx requests.
+/// @param [in] array   Received SysEx message, including start and end bytes.
+/// @param [in] size    Size of received message.
+/// \returns True if message has been recognized as profiler request, false otherwise.
+///
+bool Profiler::handleSysEx(const uint8_t *array, uint16_t size)
+{
+    if (size != 5)
+        return false;
+
+    if ((array[1] != PROFILER_SYSEX_ID) || (array[2] != PROFILER_SYSEX_COMMAND))
+        return false;
+
+    if (array[3] >= PROFILER_SYSEX_REQUESTS)
+        return false;
+
+    uint8_t response[4+PROFILER_SYSEX_VALUE_SIZE*PROFILER_SYSEX_VALUES+1];
+    uint8_t index = 0;
+
+    response[index++] = 0xF0;
+    response[index++] = PROFILER_SYSEX_ID;
+    response[index++] = PROFILER_SYSEX_COMMAND;
+    response[index++] = array[3];
+
+    uint32_t value[PROFILER_SYSEX_VALUES];
+    profilerStageData_t data;
+
+    value[0] = board.getProfilerTicks() - windowStartTicks;
+
+    for (int i=0; i<PROFILER_STAGES; i++)
+    {
+        getStageData((profilerStage_t)i, data);
+        value[1+i*3+0] = data.ticks;
+        value[1+i*3+1] = data.calls;
+        value[1+i*3+2] = data.maxTicks;
+    }
+
+    database.getProgramCacheStats(value[1+3*PROFILER_STAGES], value[1+3*PROFILER_STAGES+1]);
+
+    for (int i=0; i<PROFILER_SYSEX_VALUES; i++)
+    {
+        for (int j=PROFILER_SYSEX_VALUE_SIZE-1; j>=0; j--)
+            response[index++] = (value[i] >> (7*j)) & 0x7F;
+    }
+
+    response[index++] = 0xF7;
+
+    midi.sendSysEx(index, response, true);
+
+    if (array[3] == profilerSysExReset)
+        reset();
+
+    return true;
+}
+
+///
+/// \brief Prints profiler results periodically in debug build.
+/// Printing is done outside of profiled stages so it doesn't affect results.
+///
+void Profiler::update()
+{
+    #ifdef DEBUG
+    if ((rTimeMs() - lastPrintTime) < PROFILER_PRINT_TIME)
+        return;
+
+    print();
+    reset();
+    #endif
+}
+
+///
+/// \brief Prints accumulated measurements for all stages.
+/// Times are printed in microseconds.
+///
+void Profiler::print()
+{
+    #ifdef DEBUG
+    uint32_t window = board.getProfilerTicks() - windowStartTicks;
+    profilerStageData_t data;
+
+    printf_P(PSTR("Profiler window: %lu us\n"), window/PROFILER_TICKS_PER_US);
+
+    for (int i=0; i<PROFILER_STAGES; i++)
+    {
+        getStageData((profilerStage_t)i, data);
+
+        printf_P(PSTR("%s: total %lu us (%lu%%), calls %lu, avg %lu us, max %lu us\n"),
+            stageName[i],
+            data.ticks/PROFILER_TICKS_PER_US,
+            (window/100) ? data.ticks/(window/100) : 0,
+            data.calls,
+            data.calls ? (data.ticks/data.calls)/PROFILER_TICKS_PER_US : 0,
+            data.maxTicks/PROFILER_TICKS_PER_US);
+    }
+
+    uint32_t hits, misses;
+
+    database.getProgramCacheStats(hits, misses);
+    printf_P(PSTR("program cache: hits %lu, misses %lu\n"), hits, misses);
+    #endif
+}
+
+Profiler profiler;
+
+/// @}
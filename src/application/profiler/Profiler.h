@@ -0,0 +1,166 @@
+/*
+    Zvuk9 MIDI controller
+    Copyright (C) 2014-2017 Ad Bit LLC
+    Author: Igor Petrović
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    You may ONLY use this file:
+    1) if you have a valid commercial Ad Bit LLC license and then in accordance with
+    the terms contained in the written license agreement between you and Ad Bit LLC,
+    or alternatively
+    2) if you follow the terms found in GNU General Public License version 3 as
+    published by the Free Software Foundation here
+    <https://www.gnu.org/licenses/gpl-3.0.txt>
+*/
+
+#pragma once
+
+#include <inttypes.h>
+
+///
+/// \brief Main loop and ISR time accounting.
+/// Time is measured with free-running board timer so that measurement itself
+/// doesn't depend on debug output. Time spent in ISRs is excluded from main loop
+/// stages during which ISRs have fired.
+/// \defgroup profiler Profiler
+/// @{
+
+///
+/// \brief Number of profiler timer ticks per microsecond.
+///
+#define PROFILER_TICKS_PER_US       2
+
+///
+/// \brief Time in milliseconds after which profiler results are printed and reset in debug build.
+///
+#define PROFILER_PRINT_TIME         2000
+
+///
+/// \brief SysEx message format used to query profiler counters.
+/// Request:    F0 PROFILER_SYSEX_ID PROFILER_SYSEX_COMMAND <profilerSysExRequest_t> F7
+/// Response:   F0 PROFILER_SYSEX_ID PROFILER_SYSEX_COMMAND <request> <window ticks> [<ticks> <calls> <max ticks>] x PROFILER_STAGES
+///             <program cache hits> <program cache misses> F7
+/// Each counter in response is sent as five 7-bit bytes, MSB first. Program cache counters
+/// (see Database::getProgramCacheStats) count from startup and aren't reset by profiler.
+/// @{
+
+#define PROFILER_SYSEX_ID           0x7D
+#define PROFILER_SYSEX_COMMAND      0x50
+
+/// @}
+
+///
+/// \brief Size of single counter in profiler SysEx response.
+///
+#define PROFILER_SYSEX_VALUE_SIZE   5
+
+///
+/// \brief Number of counters in profiler SysEx response.
+///
+#define PROFILER_SYSEX_VALUES       (1+3*PROFILER_STAGES+2)
+
+///
+/// \brief List of profiled stages.
+///
+typedef enum
+{
+    profilerStagePads,
+    profilerStageDigitalInput,
+    profilerStageDisplay,
+    profilerStageLEDs,
+    profilerStageISR_ADC,
+    profilerStageISR_timer,
+    PROFILER_STAGES
+} profilerStage_t;
+
+///
+/// \brief List of supported profiler SysEx requests.
+///
+typedef enum
+{
+    profilerSysExQuery,
+    profilerSysExReset,
+    PROFILER_SYSEX_REQUESTS
+} profilerSysExRequest_t;
+
+///
+/// \brief Accumulated measurements for single stage.
+///
+typedef struct
+{
+    uint32_t ticks;
+    uint32_t calls;
+    uint32_t maxTicks;
+} profilerStageData_t;
+
+///
+/// \brief Measurements for ISR stages.
+/// Updated from ISRs directly, see Profiler::addISRtime.
+///
+extern volatile profilerStageData_t profilerISRdata[PROFILER_STAGES-profilerStageISR_ADC];
+
+///
+/// \brief Total time spent in all ISRs, in profiler timer ticks.
+///
+extern volatile uint32_t            profilerISRticks;
+
+class Profiler
+{
+    public:
+    Profiler();
+    void init();
+    void reset();
+    void begin();
+    void end(profilerStage_t stage);
+    bool handleSysEx(const uint8_t *array, uint16_t size);
+    void update();
+
+    ///
+    /// \brief Accumulates time spent in ISR.
+    /// Called from ISRs only, with time measured directly on 8-bit profiler timer
+    /// counter, so ISR must take less than 256 ticks.
+    /// @param [in] stage   ISR stage (profilerStageISR_ADC or profilerStageISR_timer).
+    /// @param [in] ticks   Ticks spent in ISR.
+    /// @param [in] calls   Number of calls added to stage. ISRs which only assist
+    ///                     another one add their time with 0 calls.
+    ///
+    static inline void addISRtime(profilerStage_t stage, uint8_t ticks, uint8_t calls = 1)
+    {
+        volatile profilerStageData_t &data = profilerISRdata[stage-profilerStageISR_ADC];
+
+        data.ticks += ticks;
+        data.calls += calls;
+
+        if (calls && (ticks > data.maxTicks))
+            data.maxTicks = ticks;
+
+        profilerISRticks += ticks;
+    }
+
+    private:
+    void getStageData(profilerStage_t stage, profilerStageData_t &data);
+    void print();
+
+    profilerStageData_t loopData[profilerStageISR_ADC];
+    uint32_t            windowStartTicks;
+    uint32_t            stageStartTicks;
+    uint32_t            stageStartISRticks;
+    uint32_t            lastPrintTime;
+};
+
+///
+/// \brief External definition of Profiler class instance.
+///
+extern Profiler profiler;
+
+/// @}